@@ -0,0 +1,329 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "Base/AsyncLog.h"
+
+#if !defined(_WIN64) && !(defined(__OHOS__) && (__OHOS__ == 1)) && !defined(__ANDROID__) && !defined(__IOS__)
+#define MRT_ASYNC_LOG_SUPPORTED 1
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <pthread.h>
+#include <sys/uio.h>
+#include <thread>
+#include <unistd.h>
+#endif
+
+#include "Base/CString.h"
+#include "Base/Globals.h"
+#include "Base/LogFile.h"
+
+namespace MapleRuntime {
+std::atomic<bool> AsyncLogger::enabled = { false };
+std::atomic<uint64_t> AsyncLogger::droppedCount = { 0 };
+
+#ifdef MRT_ASYNC_LOG_SUPPORTED
+namespace {
+constexpr uint8_t SINK_WRAP = 0xFF;
+constexpr size_t RECORD_ALIGNMENT = 8;
+// records of the same sink are written with one writev, up to this many records.
+constexpr int MAX_BATCH_RECORDS = 64;
+constexpr size_t CACHE_LINE_ALIGN = 64;
+
+struct RecordHeader {
+    uint16_t length;
+    uint8_t sink;
+    uint8_t reserved;
+};
+
+struct LogRing {
+    LogRing* next = nullptr;
+    std::atomic<bool> inUse = { true };
+    size_t capacity = 0;
+    char* data = nullptr;
+    // written by the owner thread only.
+    alignas(CACHE_LINE_ALIGN) std::atomic<uint64_t> head = { 0 };
+    // written by the thread holding drainMutex only.
+    alignas(CACHE_LINE_ALIGN) std::atomic<uint64_t> tail = { 0 };
+};
+
+struct RingHolder {
+    LogRing* ring = nullptr;
+    bool released = false;
+    ~RingHolder()
+    {
+        if (ring != nullptr) {
+            ring->inUse.store(false, std::memory_order_release);
+        }
+        ring = nullptr;
+        released = true;
+    }
+};
+
+size_t g_ringSize = 0;
+std::atomic<LogRing*> g_rings = { nullptr };
+std::mutex g_drainMutex;
+std::mutex g_startMutex;
+std::atomic<bool> g_writerStarted = { false };
+std::mutex g_wakeMutex;
+std::condition_variable g_wakeCond;
+std::atomic<bool> g_wakePending = { false };
+// set while the writer waits for records, in which case producers wake it up.
+std::atomic<bool> g_writerSleeping = { false };
+thread_local RingHolder g_ringHolder;
+// set for the writer thread and threads which are draining rings, whose logs are written synchronously.
+thread_local bool g_isDraining = false;
+
+inline size_t RecordSize(size_t len)
+{
+    return (sizeof(RecordHeader) + len + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+}
+
+LogRing* AcquireRing()
+{
+    for (LogRing* ring = g_rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+        bool expected = false;
+        if (!ring->inUse.load(std::memory_order_relaxed) &&
+            ring->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return ring;
+        }
+    }
+    LogRing* ring = new (std::nothrow) LogRing();
+    if (ring == nullptr) {
+        return nullptr;
+    }
+    ring->data = new (std::nothrow) char[g_ringSize];
+    if (ring->data == nullptr) {
+        delete ring;
+        return nullptr;
+    }
+    ring->capacity = g_ringSize;
+    LogRing* first = g_rings.load(std::memory_order_relaxed);
+    do {
+        ring->next = first;
+    } while (!g_rings.compare_exchange_weak(first, ring, std::memory_order_release, std::memory_order_relaxed));
+    return ring;
+}
+
+void WriteBatch(uint8_t sink, const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler)
+{
+    if (iovcnt == 0) {
+        return;
+    }
+    if (sink == AsyncLogger::SINK_LOGGER_FILE) {
+        Logger::GetLogger().WriteRecords(iov, iovcnt, bytes, notInSigHandler);
+    } else if (sink == AsyncLogger::SINK_STDOUT) {
+        if (notInSigHandler) {
+            fflush(stdout);
+        }
+        (void)writev(STDOUT_FILENO, iov, iovcnt);
+    } else if (sink < LOG_TYPE_NUMBER) {
+        LogFile::WriteRecords(static_cast<LogType>(sink), iov, iovcnt, bytes, notInSigHandler);
+    }
+}
+
+bool HasPendingRecords()
+{
+    for (LogRing* ring = g_rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+        if (ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WakeWriter()
+{
+    if (!g_wakePending.exchange(true, std::memory_order_relaxed)) {
+        // the writer checks g_wakePending under g_wakeMutex before it waits, so the wakeup is not lost.
+        std::lock_guard<std::mutex> lock(g_wakeMutex);
+        g_wakeCond.notify_one();
+    }
+}
+
+// caller holds g_drainMutex. Records of one ring are written in order, records of different rings are ordered by
+// their timestamps only.
+void DrainRings(bool notInSigHandler)
+{
+    struct iovec iov[MAX_BATCH_RECORDS];
+    for (LogRing* ring = g_rings.load(std::memory_order_acquire); ring != nullptr; ring = ring->next) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        int iovcnt = 0;
+        size_t bytes = 0;
+        uint8_t batchSink = SINK_WRAP;
+        while (tail != head) {
+            size_t offset = tail & (ring->capacity - 1);
+            const RecordHeader* header = reinterpret_cast<const RecordHeader*>(ring->data + offset);
+            if (header->sink == SINK_WRAP) {
+                tail += ring->capacity - offset;
+                continue;
+            }
+            if (iovcnt == MAX_BATCH_RECORDS || (iovcnt > 0 && header->sink != batchSink)) {
+                // iov points into the ring, so the space is released after it is written.
+                WriteBatch(batchSink, iov, iovcnt, bytes, notInSigHandler);
+                ring->tail.store(tail, std::memory_order_release);
+                iovcnt = 0;
+                bytes = 0;
+            }
+            batchSink = header->sink;
+            iov[iovcnt].iov_base = ring->data + offset + sizeof(RecordHeader);
+            iov[iovcnt].iov_len = header->length;
+            ++iovcnt;
+            bytes += header->length;
+            tail += RecordSize(header->length);
+        }
+        WriteBatch(batchSink, iov, iovcnt, bytes, notInSigHandler);
+        ring->tail.store(tail, std::memory_order_release);
+    }
+}
+
+// the writer sleeps until a producer enqueues a record. Producers only wake it up while it sleeps, so records
+// logged while it is writing are picked up by the same round without any wakeup.
+void WaitForRecords()
+{
+    std::unique_lock<std::mutex> lock(g_wakeMutex);
+    g_writerSleeping.store(true, std::memory_order_relaxed);
+    // pairs with the fence in Enqueue: either the producer sees the writer sleeping, or its record is seen here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!HasPendingRecords()) {
+        g_wakeCond.wait(lock, [] { return g_wakePending.load(std::memory_order_relaxed); });
+    }
+    g_writerSleeping.store(false, std::memory_order_relaxed);
+    g_wakePending.store(false, std::memory_order_relaxed);
+}
+
+void WriterLoop()
+{
+    g_isDraining = true;
+    uint64_t reportedDrops = 0;
+    while (true) {
+        WaitForRecords();
+        {
+            std::lock_guard<std::mutex> lock(g_drainMutex);
+            DrainRings(true);
+        }
+        uint64_t drops = AsyncLogger::GetDroppedCount();
+        if (drops != reportedDrops) {
+            LOG(RTLOG_WARNING, "async log dropped %lu records since last report, %lu in total. "
+                "Consider a larger MRT_LOG_ASYNC_BUFFER_SIZE.", drops - reportedDrops, drops);
+            reportedDrops = drops;
+        }
+    }
+}
+
+void StartWriter()
+{
+    std::lock_guard<std::mutex> lock(g_startMutex);
+    if (g_writerStarted.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::thread writer(WriterLoop);
+    writer.detach();
+    (void)atexit([] { AsyncLogger::Flush(true); });
+    g_writerStarted.store(true, std::memory_order_release);
+}
+} // namespace
+
+void AsyncLogger::InitFromEnv() noexcept
+{
+    auto env = std::getenv("MRT_LOG_ASYNC_BUFFER_SIZE");
+    if (env == nullptr) {
+        return;
+    }
+    size_t size = CString::ParseSizeFromEnv(env) * KB;
+    if (size < MIN_RING_SIZE || size > MAX_RING_SIZE) {
+        LOG(RTLOG_ERROR, "Unsupported MRT_LOG_ASYNC_BUFFER_SIZE parameter. It should be in [4kb, 16mb]. "
+            "Async logging is disabled.\n");
+        return;
+    }
+    // ring offsets are masked, so that round the size up to a power of two.
+    g_ringSize = MIN_RING_SIZE;
+    while (g_ringSize < size) {
+        g_ringSize <<= 1;
+    }
+    // the writer thread doesn't exist in a forked child, whose pending records are written by parent.
+    (void)pthread_atfork(nullptr, nullptr, [] { AsyncLogger::enabled.store(false, std::memory_order_relaxed); });
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+bool AsyncLogger::Enqueue(uint8_t sink, const char* record, size_t len) noexcept
+{
+    if (g_isDraining || g_ringHolder.released || len > UINT16_MAX || RecordSize(len) > g_ringSize / 2) {
+        return false;
+    }
+    LogRing* ring = g_ringHolder.ring;
+    if (ring == nullptr) {
+        ring = AcquireRing();
+        if (ring == nullptr) {
+            return false;
+        }
+        g_ringHolder.ring = ring;
+    }
+    if (UNLIKELY(!g_writerStarted.load(std::memory_order_acquire))) {
+        StartWriter();
+    }
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    uint64_t tail = ring->tail.load(std::memory_order_acquire);
+    size_t size = RecordSize(len);
+    size_t offset = head & (ring->capacity - 1);
+    size_t toEnd = ring->capacity - offset;
+    // a record never wraps around, the tail of ring is skipped instead.
+    size_t needed = size <= toEnd ? size : toEnd + size;
+    size_t used = static_cast<size_t>(head - tail);
+    if (ring->capacity - used < needed) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    if (size > toEnd) {
+        reinterpret_cast<RecordHeader*>(ring->data + offset)->sink = SINK_WRAP;
+        head += toEnd;
+        offset = 0;
+    }
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(ring->data + offset);
+    header->length = static_cast<uint16_t>(len);
+    header->sink = sink;
+    header->reserved = 0;
+    memcpy(ring->data + offset + sizeof(RecordHeader), record, len);
+    ring->head.store(head + size, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (g_writerSleeping.load(std::memory_order_relaxed)) {
+        WakeWriter();
+    }
+    return true;
+}
+
+void AsyncLogger::Flush(bool notInSigHandler) noexcept
+{
+    if (!IsEnabled() || g_isDraining || g_rings.load(std::memory_order_acquire) == nullptr) {
+        return;
+    }
+    if (notInSigHandler) {
+        std::lock_guard<std::mutex> lock(g_drainMutex);
+        g_isDraining = true;
+        DrainRings(true);
+        g_isDraining = false;
+        return;
+    }
+    // the interrupted thread may be draining. Nothing can be done in that case.
+    if (g_drainMutex.try_lock()) {
+        g_isDraining = true;
+        DrainRings(false);
+        g_isDraining = false;
+        g_drainMutex.unlock();
+    }
+}
+#else
+void AsyncLogger::InitFromEnv() noexcept {}
+
+bool AsyncLogger::Enqueue(uint8_t, const char*, size_t) noexcept { return false; }
+
+void AsyncLogger::Flush(bool) noexcept {}
+#endif
+} // namespace MapleRuntime
@@ -0,0 +1,55 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_ASYNC_LOG_H
+#define MRT_ASYNC_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace MapleRuntime {
+// AsyncLogger moves log writing off the logging threads. Every thread appends formatted records to its own
+// single-producer ring buffer without taking any lock, and a background writer drains all rings and writes records
+// of the same destination with one writev. A record is dropped if the ring of its thread is full, and the number of
+// dropped records is reported by the writer.
+//
+// Rings are never freed: a ring released by an exited thread is reused by the next new thread, so that the writer can
+// walk the ring list without synchronizing with thread exit.
+//
+// Async logging is enabled by MRT_LOG_ASYNC_BUFFER_SIZE, which is the ring size per thread, such as "64kb".
+// Records of error and fatal level and records in signal handlers are still written synchronously, after pending
+// records are flushed, so that nothing logged before a crash is lost.
+class AsyncLogger {
+public:
+    // destinations of records other than the LogFile types.
+    static constexpr uint8_t SINK_LOGGER_FILE = 0xFE;
+    static constexpr uint8_t SINK_STDOUT = 0xFD;
+
+    static constexpr size_t MIN_RING_SIZE = 4 * 1024;
+    static constexpr size_t MAX_RING_SIZE = 16 * 1024 * 1024;
+
+    static void InitFromEnv() noexcept;
+
+    static bool IsEnabled() noexcept { return enabled.load(std::memory_order_relaxed); }
+
+    // return false if the record should be written synchronously, e.g., called by the writer itself.
+    // a record which doesn't fit in the ring is dropped and still regarded as consumed.
+    static bool Enqueue(uint8_t sink, const char* record, size_t len) noexcept;
+
+    // write all records which are enqueued before this call. Records are written with write(2) only and no lock is
+    // waited for if called in signal handler.
+    static void Flush(bool notInSigHandler) noexcept;
+
+    static uint64_t GetDroppedCount() noexcept { return droppedCount.load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<bool> enabled;
+    static std::atomic<uint64_t> droppedCount;
+};
+} // namespace MapleRuntime
+#endif // MRT_ASYNC_LOG_H
@@ -9,7 +9,11 @@
 
 #include <sys/stat.h>
 #include <unistd.h>
+#if !defined(_WIN64)
+#include <sys/uio.h>
+#endif
 
+#include "Base/AsyncLog.h"
 #include "Base/CString.h"
 #include "Base/Globals.h"
 #include "Base/ImmortalWrapper.h"
@@ -202,6 +206,51 @@ bool Logger::MaybeRotate(size_t curPos, size_t maxSize, FILE* file)
     return true;
 }
 
+bool Logger::WriteRecordsToFile(FILE* file, const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler)
+{
+#if defined(_WIN64)
+    (void)file;
+    (void)iov;
+    (void)iovcnt;
+    (void)bytes;
+    (void)notInSigHandler;
+    return false;
+#else
+    if (notInSigHandler) {
+        fflush(file);
+    }
+    int fileNo = fileno(file);
+    if (writev(fileNo, iov, iovcnt) != static_cast<ssize_t>(bytes)) {
+        return false;
+    }
+    if (notInSigHandler) {
+        // the stream position is stale after writing to its descriptor directly.
+        (void)fseek(file, lseek(fileNo, 0, SEEK_CUR), SEEK_SET);
+    }
+    return true;
+#endif
+}
+
+void Logger::WriteRecords(const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler)
+{
+    if (fd == nullptr) {
+        return;
+    }
+    if (!notInSigHandler) {
+        (void)WriteRecordsToFile(fd, iov, iovcnt, bytes, false);
+        return;
+    }
+    std::lock_guard<std::recursive_mutex> lock(logMutex);
+    if (!WriteRecordsToFile(fd, iov, iovcnt, bytes, true)) {
+        PRINT_ERROR("Write async log records failed. msg: %s\n", strerror(errno));
+        return;
+    }
+    curPosLocation += bytes;
+    if (MaybeRotate(curPosLocation, maxFileSize, fd)) {
+        curPosLocation = 0;
+    }
+}
+
 const char LOG_LEVEL[] = { 'V', 'D', 'I', 'I', 'W', 'E', 'F', 'F' };
 const uint64_t ERROR_MSG_SIZE = 128;
 
@@ -338,6 +387,25 @@ static inline void WriteLogOnIos(RTLogLevel level, const char* buf)
 }
 #endif
 
+bool Logger::EnqueueAsync(RTLogLevel level, char* buf, int len)
+{
+    // leave room for the line break.
+    if (len > static_cast<int>(LOG_BUFFER_SIZE) - 2) {
+        len = static_cast<int>(LOG_BUFFER_SIZE) - 2;
+    }
+    buf[len] = '\n';
+    buf[len + 1] = '\0';
+    uint8_t sink = filePath.IsEmpty() ? AsyncLogger::SINK_STDOUT : AsyncLogger::SINK_LOGGER_FILE;
+    if (!AsyncLogger::Enqueue(sink, buf, len + 1)) {
+        buf[len] = '\0';
+        return false;
+    }
+    if (level == RTLOG_REPORT && !filePath.IsEmpty()) {
+        VLOG(REPORT, "%.*s", len, buf);
+    }
+    return true;
+}
+
 void Logger::FormatLog(RTLogLevel level, bool notInSigHandler, const char* format, ...) noexcept
 {
     if (!CheckLogLevel(level)) {
@@ -378,6 +446,13 @@ void Logger::FormatLog(RTLogLevel level, bool notInSigHandler, const char* forma
 #elif defined (__IOS__)
     WriteLogOnIos(level, buf);
 #else
+    if (AsyncLogger::IsEnabled()) {
+        if (notInSigHandler && level < RTLOG_ERROR && EnqueueAsync(level, buf, index)) {
+            return;
+        }
+        // pending records go first, so that nothing logged before a crash is lost.
+        AsyncLogger::Flush(notInSigHandler);
+    }
     if (filePath.IsEmpty()) {
         std::lock_guard<std::recursive_mutex> lock(logMutex);
         PRINT_FATAL_IF(sprintf_s(buf, LOG_BUFFER_SIZE, "%s\n", buf) == -1, "FormatLog sprintf_s failed.\n");
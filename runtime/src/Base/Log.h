@@ -28,6 +28,8 @@
 #include <os/signpost.h>
 #endif
 
+struct iovec;
+
 namespace MapleRuntime {
 #define LOG(level, format...) ::MapleRuntime::Logger::GetLogger().FormatLog(level, true, format)
 #define FLOG(level, format...) ::MapleRuntime::Logger::GetLogger().FormatLog(level, false, format)
@@ -398,11 +400,17 @@ public:
     static size_t GetLogFileSize();
     static void GetLogPath(const char* env, CString& logPath);
     bool CheckLogLevel(RTLogLevel level);
+    // write records drained by AsyncLogger to file and resynchronize the file position for later fprintf.
+    static bool WriteRecordsToFile(FILE* file, const struct iovec* iov, int iovcnt, size_t bytes,
+                                   bool notInSigHandler);
+    void WriteRecords(const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler);
 #if  (defined(_WIN64)) || defined(__APPLE__)
     MRT_EXPORT static void RegisterLogHandle(LogHandle handle);
     static void InvokeLogHandle(const char* msg);
 #endif
 private:
+    bool EnqueueAsync(RTLogLevel level, char* buf, int len);
+
     FILE* fd = nullptr;
     RTLogLevel minimumLogLevel;
     size_t maxFileSize;
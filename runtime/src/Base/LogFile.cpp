@@ -7,6 +7,7 @@
 
 #include "LogFile.h"
 
+#include "Base/AsyncLog.h"
 #include "Base/SysCall.h"
 #include "securec.h"
 
@@ -43,9 +44,14 @@ void LogFile::Init()
 #if defined(MRT_DEBUG) && (MRT_DEBUG == 1)
     OpenLogFiles();
 #endif
+    AsyncLogger::InitFromEnv();
 }
 
-void LogFile::Fini() { CloseLogFiles(); }
+void LogFile::Fini()
+{
+    AsyncLogger::Flush(true);
+    CloseLogFiles();
+}
 
 void LogFile::SetFlagWithEnv(const char* env, LogType type)
 {
@@ -152,6 +158,17 @@ static void WriteLogImpl(bool addPrefix, LogType type, const char* format, va_li
     }
     index += ret;
 
+    if (AsyncLogger::IsEnabled()) {
+        if (index > static_cast<int>(sizeof(buf)) - 1) {
+            index = static_cast<int>(sizeof(buf)) - 1;
+        }
+        buf[index] = '\n';
+        if (AsyncLogger::Enqueue(type, buf, index + 1)) {
+            return;
+        }
+        buf[index] = '\0';
+    }
+
     LogFile::LogFileLock(type);
 #if defined(__OHOS__) && (__OHOS__ == 1)
     auto env = CString(std::getenv("MRT_REPORT"));
@@ -186,6 +203,35 @@ static void WriteLogImpl(bool addPrefix, LogType type, const char* format, va_li
     LogFile::LogFileUnLock(type);
 }
 
+void LogFile::WriteRecords(LogType type, const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler)
+{
+    FILE* file = logFile[type].file;
+    if (!notInSigHandler) {
+        if (file != nullptr) {
+            (void)Logger::WriteRecordsToFile(file, iov, iovcnt, bytes, false);
+        }
+        return;
+    }
+    LogFileLock(type);
+    if (!LogIsEnabled(type) || file == nullptr) {
+        LogFileUnLock(type);
+        return;
+    }
+    if (!Logger::WriteRecordsToFile(file, iov, iovcnt, bytes, true)) {
+        PRINT_ERROR("Write async log records failed. msg: %s\n", strerror(errno));
+        LogFileUnLock(type);
+        return;
+    }
+#ifndef MRT_DEBUG
+    size_t curPos = GetCurPosLocation(type) + bytes;
+    SetCurPosLocation(type, curPos);
+    if (Logger::MaybeRotate(curPos, GetMaxFileSize(type), file)) {
+        SetCurPosLocation(type, 0);
+    }
+#endif
+    LogFileUnLock(type);
+}
+
 void WriteLog(bool addPrefix, LogType type, const char* format, ...) noexcept
 {
     va_list args;
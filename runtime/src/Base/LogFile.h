@@ -249,6 +249,9 @@ public:
 
     static RTLogLevel GetLogLevel() { return logLevel; }
 
+    // write records of this type drained by AsyncLogger.
+    static void WriteRecords(LogType type, const struct iovec* iov, int iovcnt, size_t bytes, bool notInSigHandler);
+
 private:
 #if defined(MRT_DEBUG) && (MRT_DEBUG == 1)
     static void OpenLogFiles();
@@ -240,6 +240,19 @@ int SchdfdUnlock(SignedSocket fd, SchdpollEventType type);
  */
 int SchdfdRegisterAndNetpollAdd(SignedSocket fd);
 
+#ifndef MRT_WINDOWS
+/**
+ * @brief Wait until an unregistered fd is readable.
+ * @par Description: fd is registered and added to netpoll, and deregistered after the event arrives.
+ * When waiting, cjthread park is released, e.g., for a pidfd until the child process exits.
+ * @attention fd is not closed by this interface, and must not be registered by others.
+ * @param  fd           [IN]  fd
+ * @retval #0 Function operation succeeded.
+ * @retval #Non-zero Function fails to be operated and an error code is returned.
+ */
+int SchdfdWaitReadable(SignedSocket fd);
+#endif
+
 #ifdef MRT_WINDOWS
 /**
  * @brief Waiting for IOCP asynchronous operation to complete.
@@ -718,6 +718,26 @@ int SchdfdRegisterAndNetpollAdd(SignedSocket fd)
     return 0;
 }
 
+#ifndef MRT_WINDOWS
+/* The fd is watched only during the wait, and is left open for the caller. */
+int SchdfdWaitReadable(SignedSocket fd)
+{
+    int ret = SchdfdRegister(fd);
+    if (ret != 0) {
+        LOG_ERROR(ret, "fd %d SchdfdRegister failed", fd);
+        return ret;
+    }
+    ret = SchdfdNetpollAdd(fd);
+    if (ret == 0) {
+        ret = SchdfdWait(fd, SHCDPOLL_READ);
+    } else {
+        LOG_ERROR(ret, "fd %d SchdfdNetpollAdd failed", fd);
+    }
+    (void)SchdfdDeregister(fd);
+    return ret;
+}
+#endif
+
 #ifdef MRT_WINDOWS
 /* Requesting to cancel IOCP operation will result in the following four situations
  * 1.The request was not submitted in a timely manner, and the IO operation was completed normally.
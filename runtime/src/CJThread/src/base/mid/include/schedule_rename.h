@@ -31,6 +31,7 @@
 #define SchdfdLock                               CJ_SchdfdLock
 #define SchdfdUnlock                             CJ_SchdfdUnlock
 #define SchdfdRegisterAndNetpollAdd              CJ_SchdfdRegisterAndNetpollAdd
+#define SchdfdWaitReadable                       CJ_MRT_SchdfdWaitReadable
 #define SchdfdPdPut                              CJ_SchdfdPdPut
 #define SchdfdPdRemove                           CJ_SchdfdPdRemove
 #define g_keepAliceCfg                           CJ_GKeepAliceCfg
@@ -303,6 +304,7 @@
 #define ProcessorStopBoundCJThread              CJ_ProcessorStopBoundCJThread
 #define ProcessorNewId                          CJ_ProcessorNewId
 #define ProcessorId                             CJ_ProcessorId
+#define ProcessorLocalId                        CJ_MRT_ProcessorLocalId
 #define ProcessorCanSpin                        CJ_ProcessorCanSpin
 
 /* schdpoll */
@@ -413,6 +415,7 @@
 #define ScheduleGetTraceReader                  CJ_ScheduleGetTraceReader
 #define ScheduleTraceEventOrigin                CJ_ScheduleTraceEventOrigin
 #define ScheduleTraceEvent                      CJ_ScheduleTraceEvent
+#define ScheduleTraceEventEnabled               CJ_ScheduleTraceEventEnabled
 
 /* windows global value */
 #define g_localTlsOffset                        CJ_GLocalTlsOffset
@@ -53,6 +53,10 @@
 #define TraceEvent                                CJ_TraceEvent
 #define TraceStackTableDump                       CJ_TraceStackTableDump
 #define TraceDump                                 CJ_TraceDump
+#define TraceDumpChunk                            CJ_TraceDumpChunk
+#define TraceExportStart                          CJ_TraceExportStart
+#define TraceExportChunk                          CJ_TraceExportChunk
+#define TraceExportStop                           CJ_TraceExportStop
 #define TraceReaderAvailable                      CJ_TraceReaderAvailable
 #define TraceReaderGet                            CJ_TraceReaderGet
 #define TraceRegister                             CJ_TraceRegister
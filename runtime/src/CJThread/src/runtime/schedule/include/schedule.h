@@ -468,9 +468,16 @@ enum TraceEvent {
     TRACE_EV_CJTHREAD_BLOCK_NET = 0x010F,     // 0000 0001 0000 1111 cjthread block for net [timestamp, stackId]
     TRACE_EV_CJTHREAD_SYSCALL = 0x0110,       // 0000 0001 0001 0000 cjthread syscall start [timestamp, stackId]
     TRACE_EV_CJTHREAD_SYSEXIT = 0x0111,       // 0000 0001 0001 0001 cjthread syscall end [timestamp, CJThreadId]
-    TRACE_EV_GC_START = 0x0212,               // 0000 0010 0001 0010 GC start [timestamp]
-    TRACE_EV_GC_DONE = 0x0213,                // 0000 0010 0001 0011 GC end [timestamp]
-    TRACE_EV_COUNT = 0x0014,                  // 0000 0000 0001 0100 count evnet
+    TRACE_EV_GC_START = 0x0212,               // 0000 0010 0001 0010 GC start [timestamp, gcIndex, reason]
+    TRACE_EV_GC_DONE = 0x0213,                // 0000 0010 0001 0011 GC end [timestamp, collected bytes]
+    TRACE_EV_GC_STW_START = 0x0214,           // 0000 0010 0001 0100 stop the world start [timestamp]
+    TRACE_EV_GC_STW_DONE = 0x0215,            // 0000 0010 0001 0101 stop the world end [timestamp]
+    TRACE_EV_GC_PHASE = 0x0216,               // 0000 0010 0001 0110 GC phase transition [timestamp, phase]
+    // 0000 0010 0001 0111 heap region allocation [timestamp, region bytes, heap used bytes]
+    TRACE_EV_HEAP_ALLOC_REGION = 0x0217,
+    TRACE_EV_FINALIZER_START = 0x0218,        // 0000 0010 0001 1000 finalizers run start [timestamp, count]
+    TRACE_EV_FINALIZER_DONE = 0x0219,         // 0000 0010 0001 1001 finalizers run end [timestamp]
+    TRACE_EV_COUNT = 0x001A,                  // 0000 0000 0001 1010 count evnet
 };
 
 enum TraceStackFrames {
@@ -1333,6 +1340,14 @@ void *CJThreadResultGet(CJThreadHandle cjthread);
  */
 unsigned int ProcessorId(void);
 
+/**
+ * @brief Get the id of the processor running the current cjthread, without logging an error if there is none.
+ * @par Used to index processor-local data, such as the caches of std.objectpool. The cjthread may run on
+ * another processor as soon as it is scheduled again, so the id is a hint only.
+ * @retval processor id, or UINT_MAX if the caller is not a cjthread running on a processor.
+ */
+unsigned int ProcessorLocalId(void);
+
 /**
  * @brief Check whether the current processor can spin.
  */
@@ -1487,6 +1502,13 @@ unsigned char *ScheduleDumpTrace(int *len);
  */
 void ScheduleTraceEvent(TraceEvent event, int skip, struct CJThread *cjthread, int argNum, ...);
 
+/**
+ * @brief Check whether an event is recorded by the trace, so that its arguments are computed only when needed.
+ * @param event    [IN] Event type
+ * @retval true if the trace is open for the event, otherwise false.
+ */
+bool ScheduleTraceEventEnabled(TraceEvent event);
+
 #ifdef CANGJIE_SANITIZER_SUPPORT
 /**
  * @brief acquire sanitizer context from specific cjthread
@@ -14,6 +14,7 @@
 #include "schdpoll.h"
 #include "basetime.h"
 #include "log.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #if defined(CANGJIE_SANITIZER_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
 #endif
@@ -59,10 +60,10 @@ int ProcessorGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
     }
 
     // Add to the global queue of the schedule.
-    pthread_mutex_lock(&sch->schdCJThread.mutex);
+    MapleRuntime::ContentionProfiler::Lock(&sch->schdCJThread.mutex, MapleRuntime::LockKind::SCHEDULE_GLOBAL_QUEUE);
     DulinkMove(&sch->schdCJThread.runq, &tempDulink, 0);
     sch->schdCJThread.num += (length + num);
-    pthread_mutex_unlock(&sch->schdCJThread.mutex);
+    MapleRuntime::ContentionProfiler::Unlock(&sch->schdCJThread.mutex);
 
     return 0;
 }
@@ -111,10 +112,10 @@ struct CJThread *ProcessorGlobalRead(void *schedule, bool batch)
         return nullptr;
     }
     runDulink = &schdCJThread->runq;
-    pthread_mutex_lock(&(schdCJThread->mutex));
+    MapleRuntime::ContentionProfiler::Lock(&schdCJThread->mutex, MapleRuntime::LockKind::SCHEDULE_GLOBAL_QUEUE);
 
     if (schdCJThread->num == 0) {
-        pthread_mutex_unlock(&(schdCJThread->mutex));
+        MapleRuntime::ContentionProfiler::Unlock(&(schdCJThread->mutex));
         return nullptr;
     }
 
@@ -133,13 +134,13 @@ struct CJThread *ProcessorGlobalRead(void *schedule, bool batch)
     DulinkRemove(&(cjthreadNext->schdDulink));
 
     if (readNum == 1) {
-        pthread_mutex_unlock(&(schdCJThread->mutex));
+        MapleRuntime::ContentionProfiler::Unlock(&(schdCJThread->mutex));
         return cjthreadNext;
     }
     --readNum;
     DulinkInit(&tempDulink);
     DulinkMove(&tempDulink, runDulink, readNum);
-    pthread_mutex_unlock(&(schdCJThread->mutex));
+    MapleRuntime::ContentionProfiler::Unlock(&(schdCJThread->mutex));
 
     // The rest of the cjthreads are placed in the local queue. If batch is false or only
     // one cjthread is obtained, the loop will not be entered.
@@ -1142,6 +1143,15 @@ unsigned int ProcessorId(void)
     return processor->processorId;
 }
 
+unsigned int ProcessorLocalId(void)
+{
+    struct Processor *processor = ProcessorGetWithCheck();
+    if (processor == nullptr) {
+        return UINT_MAX;
+    }
+    return processor->processorId;
+}
+
 #if defined(CANGJIE_TSAN_SUPPORT)
 
 void* ProcessorGetHandle(void)
@@ -14,6 +14,7 @@
 #include "securec.h"
 #include "basetime.h"
 #include "Base/Log.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #if defined(CANGJIE_ASAN_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
 #endif
@@ -1330,12 +1331,13 @@ int ScheduleGlobalWrite(struct CJThread *cjthreadList[], unsigned int num)
     schedule = cjthreadList[0]->schedule;
     globalQueue = &schedule->schdCJThread.runq;
 
-    pthread_mutex_lock(&schedule->schdCJThread.mutex);
+    MapleRuntime::ContentionProfiler::Lock(&schedule->schdCJThread.mutex,
+                                           MapleRuntime::LockKind::SCHEDULE_GLOBAL_QUEUE);
     for (i = 0; i < num; i++) {
         DulinkPushtail(globalQueue, cjthreadList[i]);
     }
     schedule->schdCJThread.num += num;
-    pthread_mutex_unlock(&schedule->schdCJThread.mutex);
+    MapleRuntime::ContentionProfiler::Unlock(&schedule->schdCJThread.mutex);
 
     return 0;
 }
@@ -2113,10 +2115,15 @@ void ScheduleTraceEventOrigin(TraceEvent event, int skip, struct CJThread *cjthr
     va_end(args);
 }
 
+bool ScheduleTraceEventEnabled(TraceEvent event)
+{
+    return g_scheduleManager.trace.openType && (g_scheduleManager.trace.openType & event);
+}
+
 void ScheduleTraceEvent(TraceEvent event, int skip, struct CJThread *cjthread, int argNum, ...)
 {
     va_list args;
-    if (!g_scheduleManager.trace.openType || !(g_scheduleManager.trace.openType & event)) {
+    if (!ScheduleTraceEventEnabled(event)) {
         return;
     }
     if (g_scheduleManager.trace.hooks.traceRecordEvent == nullptr) {
@@ -9,6 +9,7 @@
 #include <unistd.h>
 #include "schedule_impl.h"
 #include "log.h"
+#include "CpuProfiler/CpuProfiler.h"
 #if defined(CANGJIE_ASAN_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
 #endif
@@ -99,6 +100,7 @@ void *ThreadEntry(void *arg)
     cjthread0->thread = thread;
 
     thread->tid = GetSystemThreadId();
+    MapleRuntime::CpuProfiler::AttachThread();
 
     // Initialize the thread and set the cjthread running context.
     CJThreadSet(cjthread0);
@@ -120,6 +122,7 @@ void *ThreadEntry(void *arg)
     // A thread may enter the exit process without any scheduling.
     // In this case, need to unbind the thread and exit.
     ProcessorRelease();
+    MapleRuntime::CpuProfiler::DetachThread();
 
     return nullptr;
 }
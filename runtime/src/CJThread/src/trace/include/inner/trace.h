@@ -72,6 +72,16 @@ extern "C" {
 */
 #define ERRNO_TRACE_STACK_EVENT ((MID_TRACE) | 0x00A)
 
+/**
+* @brief 0x1015000B trace export format is invalid
+*/
+#define ERRNO_TRACE_EXPORT_FORMAT ((MID_TRACE) | 0x00B)
+
+/**
+* @brief 0x1015000C trace buffer cannot be exported
+*/
+#define ERRNO_TRACE_EXPORT_PARSE ((MID_TRACE) | 0x00C)
+
 /**
  * @brief start trace
  * @par start trace
@@ -122,6 +132,13 @@ unsigned long long TraceStackId();
  */
 unsigned char *TraceDump(int *len);
 
+/**
+ * @brief Outputs the raw trace data, i.e., the header, a traceBuf or the footer, without conversion.
+ * @param  len             [OUT]  Byte array length
+ * @retval NULL or charArrayPointer
+ */
+unsigned char *TraceDumpChunk(int *len);
+
 /**
  * @brief Obtains the cjthread of the blocked dump trace event
  * @par Obtains the cjthread of the blocked dump trace event.
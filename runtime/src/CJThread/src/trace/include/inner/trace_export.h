@@ -0,0 +1,50 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_TRACE_EXPORT_H
+#define MRT_TRACE_EXPORT_H
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/**
+ * @brief Create the trace exporter selected by cjTraceFormat.
+ * @par The trace data is converted to the Chrome trace event json if cjTraceFormat is "chrome", or to
+ * the Perfetto protobuf trace if it is "perfetto", while it is dumped. The raw trace data is dumped
+ * if cjTraceFormat is not set or invalid.
+ * @attention called when trace starts, after the start time of trace is recorded.
+ * @retval NULL
+ */
+void TraceExportStart(void);
+
+/**
+ * @brief Convert trace data returned by TraceDumpChunk in the format of the exporter.
+ * @par Events are converted as soon as their buffer is dumped. Only the state of cjthreads running on
+ * processors, pending GC spans and events waiting for their call stacks are kept between buffers.
+ * @attention the converted data is valid until the next call. It is returned as is if no exporter.
+ * @param  data            [IN]  Raw trace data
+ * @param  len             [IN/OUT]  Byte array length
+ * @retval charArrayPointer
+ */
+unsigned char *TraceExportChunk(unsigned char *data, int *len);
+
+/**
+ * @brief Destroy the trace exporter.
+ * @attention called when trace stops, after all trace data is dumped.
+ * @retval NULL
+ */
+void TraceExportStop(void);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif
+#endif
+#endif /* MRT_TRACE_EXPORT_H */
@@ -11,6 +11,7 @@
 #include "schedule_impl.h"
 #include "UnwindStack/GcStackInfo.h"
 #include "trace.h"
+#include "trace_export.h"
 
 #ifdef  __cplusplus
 extern "C" {
@@ -49,6 +50,7 @@ bool TraceStart(unsigned short traceType)
     g_scheduleManager.trace.footerWritten = false;
     g_scheduleManager.trace.stringId.store(1);
     g_scheduleManager.trace.stackId.store(SpecialStackId::OTHERS);
+    TraceExportStart();
 
     TraceRecordStartEvent();
     return true;
@@ -96,6 +98,7 @@ bool TraceDeregisterBeforeStop()
         free(traceBufNode);
     }
     g_scheduleManager.trace.shutdown = false;
+    TraceExportStop();
     TraceDeregister();
     return true;
 }
@@ -377,7 +380,7 @@ unsigned char *TraceDumpFooter(int *len)
     return g_scheduleManager.trace.reading->arr;
 }
 
-unsigned char *TraceDump(int *len)
+unsigned char *TraceDumpChunk(int *len)
 {
     pthread_mutex_lock(&g_scheduleManager.trace.lock);
 
@@ -428,6 +431,11 @@ unsigned char *TraceDump(int *len)
     return nullptr;
 }
 
+unsigned char *TraceDump(int *len)
+{
+    return TraceExportChunk(TraceDumpChunk(len), len);
+}
+
 bool TraceReaderAvailable(void)
 {
     return g_scheduleManager.trace.reader != nullptr &&
@@ -519,6 +527,10 @@ bool TraceRecordStackEvent(unsigned long long stackId, int skip, void *mutator)
                                   funcNameStringIds, fileNameStringIds)) {
         return false;
     }
+    /* Only the string ids of the first skip frames are recorded. */
+    if (stackSize > skip) {
+        stackSize = skip;
+    }
     atomic_fetch_add(&g_scheduleManager.trace.eventCount, 1);
     traceBuf = TraceBufAquire(&processorId);
     if (!TraceCheckEvSizeAndFlush(traceBuf, processorId, TRACE_STACK_EVENT_MAXSIZE, true)) {
@@ -0,0 +1,793 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "basetime.h"
+#include "log.h"
+#include "schedule_impl.h"
+#include "trace.h"
+#include "trace_export.h"
+
+namespace {
+/* Tracks of the exported timeline. Each processor has its own track after TRACK_PROCESSOR_BASE. */
+enum TraceExportTrack : unsigned long long {
+    TRACK_PROCESS = 1,
+    TRACK_GC,
+    TRACK_GC_PHASE,
+    TRACK_STW,
+    TRACK_FINALIZER,
+    TRACK_HEAP,
+    TRACK_PROCESSOR_BASE = 0x100,
+};
+
+constexpr int TRACE_EXPORT_MAX_ARGS = 16;
+/* Names of GCPhase in Heap/Collector/Collector.h, indexed by the phase. */
+const char *const TRACE_GC_PHASE_NAMES[] = {
+    "undef", "idle", "finish", "reclaim satb node", "", "", "", "", "init", "enum", "trace", "clear satb buffer",
+    "post trace", "preforward", "forward",
+};
+
+struct TraceExportArg {
+    const char *name;
+    bool isString;
+    unsigned long long value;
+    std::string str;
+};
+
+/* A slice, or an instant event if begin equals to end, on a track. Timestamps are in nanoseconds. */
+struct TraceExportRecord {
+    unsigned long long track;
+    std::string name;
+    unsigned long long begin;
+    unsigned long long end;
+    bool isSlice;
+    std::vector<TraceExportArg> args;
+
+    void AddArg(const char *argName, unsigned long long value)
+    {
+        args.push_back(TraceExportArg{ argName, false, value, std::string() });
+    }
+
+    void AddArg(const char *argName, std::string value)
+    {
+        args.push_back(TraceExportArg{ argName, true, 0, std::move(value) });
+    }
+};
+
+class TraceChunkReader {
+public:
+    TraceChunkReader(const unsigned char *data, int len) : data(data), len(static_cast<size_t>(len)) {}
+
+    bool AtEnd() const { return pos >= len; }
+
+    bool Failed() const { return failed; }
+
+    unsigned char Byte()
+    {
+        if (pos >= len) {
+            failed = true;
+            return 0;
+        }
+        return data[pos++];
+    }
+
+    /* Inverse of TraceUint64. */
+    unsigned long long Uint64()
+    {
+        unsigned long long value = 0;
+        for (unsigned int shift = 0; pos < len && shift < 64; shift += TRACE_UINT64_SHIFTS) { // 64: bits of value
+            unsigned char byte = data[pos++];
+            value |= static_cast<unsigned long long>(byte & (TRACE_UINT64_SHIFT_THRESHOLD - 1)) << shift;
+            if (byte < TRACE_UINT64_SHIFT_THRESHOLD) {
+                return value;
+            }
+        }
+        failed = true;
+        return 0;
+    }
+
+    const char *Bytes(size_t count)
+    {
+        if (len - pos < count) {
+            failed = true;
+            return nullptr;
+        }
+        const char *bytes = reinterpret_cast<const char *>(data + pos);
+        pos += count;
+        return bytes;
+    }
+
+private:
+    const unsigned char *data;
+    size_t len;
+    size_t pos = 0;
+    bool failed = false;
+};
+
+/* TraceExporter parses the raw trace data buffer by buffer and writes timeline events of them. The buffers of a
+ * processor are dumped in order, but buffers of different processors are interleaved, so a record is only built from
+ * the events of one buffer sequence. The call stack of an event is recorded after the event by the same thread, so a
+ * record with a stack id is held until its stack event is parsed.
+ */
+class TraceExporter {
+public:
+    TraceExporter(unsigned long long ticksStart, unsigned long long timeStart)
+        : timeStart(timeStart), ticksStart(ticksStart) {}
+
+    virtual ~TraceExporter() = default;
+
+    const std::string &Convert(const unsigned char *data, int len);
+
+protected:
+    virtual void WriteHeader() = 0;
+    virtual void WriteTrack(unsigned long long track, const std::string &name, bool isCounter) = 0;
+    virtual void WriteRecord(const TraceExportRecord &record) = 0;
+    virtual void WriteCounter(unsigned long long track, const char *name, unsigned long long time,
+                              unsigned long long value) = 0;
+    virtual void WriteTrailer() = 0;
+
+    std::string out;
+    unsigned long long timeStart;
+
+private:
+    struct CJThreadRun {
+        unsigned long long cjthreadId;
+        unsigned long long begin;
+    };
+
+    struct PendingSpan {
+        bool started = false;
+        unsigned long long begin = 0;
+        unsigned long long arg = 0;
+        unsigned long long arg2 = 0;
+    };
+
+    void Calibrate();
+    unsigned long long TicksToNanos(unsigned long long ticks) const;
+    void ParseEvent(TraceChunkReader &reader);
+    void ParseString(TraceChunkReader &reader);
+    void ParseStack(TraceChunkReader &reader);
+    void HandleEvent(unsigned char event, unsigned long long time, const unsigned long long *args, int argNum);
+    void HandleGCEvent(unsigned char event, unsigned long long time, const unsigned long long *args, int argNum);
+    unsigned long long ProcessorTrack();
+    void BeginRun(unsigned long long time, unsigned long long cjthreadId);
+    void EndRun(unsigned long long time, const char *reason, unsigned long long stackId);
+    void AddInstant(const char *name, unsigned long long time, unsigned long long cjthreadId,
+                    unsigned long long stackId);
+    void Emit(TraceExportRecord &&record, unsigned long long stackId);
+    void Finish();
+
+    unsigned long long ticksStart;
+    double nanosPerTick = 1.0;
+    unsigned int processorId = 0;
+    unsigned long long ticks = 0;
+    unsigned long long lastTime = 0;
+    bool finished = false;
+    std::unordered_set<unsigned int> processorTracks;
+    std::unordered_map<unsigned int, CJThreadRun> runs;
+    std::unordered_map<unsigned long long, std::string> strings;
+    std::unordered_map<unsigned long long, TraceExportRecord> pendingRecords;
+    PendingSpan gc;
+    PendingSpan gcPhase;
+    PendingSpan stw;
+    PendingSpan finalizer;
+};
+
+const std::string &TraceExporter::Convert(const unsigned char *data, int len)
+{
+    out.clear();
+    if (len == TRACE_HEADER_LENGTH && memcmp(data, TRACE_HEADER, strlen(TRACE_HEADER)) == 0) {
+        WriteHeader();
+        WriteTrack(TRACK_GC, "GC", false);
+        WriteTrack(TRACK_GC_PHASE, "GC phase", false);
+        WriteTrack(TRACK_STW, "stop the world", false);
+        WriteTrack(TRACK_FINALIZER, "finalizer", false);
+        WriteTrack(TRACK_HEAP, "heap used bytes", true);
+        return out;
+    }
+    Calibrate();
+    TraceChunkReader reader(data, len);
+    while (!reader.AtEnd() && !reader.Failed() && !finished) {
+        ParseEvent(reader);
+    }
+    if (reader.Failed()) {
+        LOG_ERROR(ERRNO_TRACE_EXPORT_PARSE, "trace buffer of processor-%u is truncated", processorId);
+    }
+    return out;
+}
+
+/* The frequency of cpu ticks is only written in the footer. The ratio since trace starts is used instead, whose error
+ * is no more than the error of reading the clocks for events before now.
+ */
+void TraceExporter::Calibrate()
+{
+    unsigned long long ticksNow = CurrentCPUTicks();
+    unsigned long long timeNow = CurrentNanotimeGet();
+    if (ticksNow > ticksStart && timeNow > timeStart) {
+        nanosPerTick = static_cast<double>(timeNow - timeStart) / static_cast<double>(ticksNow - ticksStart);
+    }
+}
+
+unsigned long long TraceExporter::TicksToNanos(unsigned long long eventTicks) const
+{
+    if (eventTicks <= ticksStart) {
+        return timeStart;
+    }
+    return timeStart + static_cast<unsigned long long>(static_cast<double>(eventTicks - ticksStart) * nanosPerTick);
+}
+
+void TraceExporter::ParseEvent(TraceChunkReader &reader)
+{
+    unsigned char event = reader.Byte();
+    switch (event) {
+        case TRACE_EV_STRING & TRACE_EFFECTIVE_EVENT:
+            ParseString(reader);
+            return;
+        case TRACE_EV_STACK & TRACE_EFFECTIVE_EVENT:
+            ParseStack(reader);
+            return;
+        case TRACE_EV_BATCH & TRACE_EFFECTIVE_EVENT:
+            (void)reader.Byte();
+            processorId = static_cast<unsigned int>(reader.Uint64());
+            ticks = reader.Uint64();
+            return;
+        case TRACE_EV_FREQUENCY & TRACE_EFFECTIVE_EVENT:
+            (void)reader.Byte();
+            (void)reader.Uint64();
+            Finish();
+            return;
+        default:
+            break;
+    }
+    int argNum = reader.Byte();
+    ticks += reader.Uint64();
+    unsigned long long args[TRACE_EXPORT_MAX_ARGS] = { 0 };
+    for (int i = 0; i < argNum; ++i) {
+        unsigned long long arg = reader.Uint64();
+        if (i < TRACE_EXPORT_MAX_ARGS) {
+            args[i] = arg;
+        }
+    }
+    if (reader.Failed()) {
+        return;
+    }
+    lastTime = TicksToNanos(ticks);
+    HandleEvent(event, lastTime, args, argNum < TRACE_EXPORT_MAX_ARGS ? argNum : TRACE_EXPORT_MAX_ARGS);
+}
+
+void TraceExporter::ParseString(TraceChunkReader &reader)
+{
+    unsigned long long stringId = reader.Uint64();
+    unsigned long long len = reader.Uint64();
+    const char *str = reader.Bytes(len);
+    if (str != nullptr) {
+        strings[stringId] = std::string(str, len);
+    }
+}
+
+/* Strings of a stack are recorded for the stack only, so they are released once the stack is built. */
+void TraceExporter::ParseStack(TraceChunkReader &reader)
+{
+    (void)reader.Byte();
+    unsigned long long stackId = reader.Uint64();
+    unsigned long long frameNum = reader.Uint64();
+    std::string stack;
+    for (unsigned long long i = 0; i < frameNum && !reader.Failed(); ++i) {
+        (void)reader.Uint64();
+        unsigned long long funcNameId = reader.Uint64();
+        unsigned long long fileNameId = reader.Uint64();
+        unsigned long long line = reader.Uint64();
+        auto funcName = strings.find(funcNameId);
+        auto fileName = strings.find(fileNameId);
+        stack += (i == 0) ? "" : "\n";
+        stack += (funcName == strings.end()) ? TRACE_UNKNOWN_STRING : funcName->second;
+        stack += " (";
+        stack += (fileNameId == 1) ? TRACE_RUNTIME_STRING :
+            (fileName == strings.end()) ? TRACE_UNKNOWN_STRING : fileName->second;
+        stack += ":" + std::to_string(line) + ")";
+        // string 1 is shared by all stacks.
+        if (funcNameId > 1) {
+            strings.erase(funcNameId);
+        }
+        if (fileNameId > 1) {
+            strings.erase(fileNameId);
+        }
+    }
+    auto pending = pendingRecords.find(stackId);
+    if (pending == pendingRecords.end()) {
+        return;
+    }
+    pending->second.AddArg("stack", std::move(stack));
+    WriteRecord(pending->second);
+    pendingRecords.erase(pending);
+}
+
+void TraceExporter::HandleEvent(unsigned char event, unsigned long long time, const unsigned long long *args,
+                                int argNum)
+{
+    unsigned long long lastArg = argNum > 0 ? args[argNum - 1] : 0;
+    switch (event) {
+        case TRACE_EV_PROC_WAKE & TRACE_EFFECTIVE_EVENT: {
+            TraceExportRecord record{ ProcessorTrack(), "processor wake", time, time, false, {} };
+            record.AddArg("thread", args[0]);
+            Emit(std::move(record), 0);
+            break;
+        }
+        case TRACE_EV_PROC_STOP & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "processor stop", 0);
+            break;
+        case TRACE_EV_CJTHREAD_CREATE & TRACE_EFFECTIVE_EVENT:
+            AddInstant("create", time, args[0], argNum > 1 ? lastArg : 0);
+            break;
+        case TRACE_EV_CJTHREAD_START & TRACE_EFFECTIVE_EVENT:
+            BeginRun(time, args[0]);
+            break;
+        case TRACE_EV_CJTHREAD_END & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "end", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_RESCHED & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "resched", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_SLEEP & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "sleep", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_BLOCK & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "block", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_BLOCK_SYNC & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "block sync", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_BLOCK_NET & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "block net", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_SYSCALL & TRACE_EFFECTIVE_EVENT:
+            EndRun(time, "syscall", lastArg);
+            break;
+        case TRACE_EV_CJTHREAD_UNBLOCK & TRACE_EFFECTIVE_EVENT:
+            AddInstant(lastArg == CJTHREAD_NET_UNBLOCK ? "netpoll wakeup" : "unblock", time, args[0],
+                       argNum > 1 ? lastArg : 0);
+            break;
+        case TRACE_EV_CJTHREAD_SYSEXIT & TRACE_EFFECTIVE_EVENT:
+            AddInstant("syscall exit", time, args[0], 0);
+            break;
+        default:
+            HandleGCEvent(event, time, args, argNum);
+            break;
+    }
+}
+
+void TraceExporter::HandleGCEvent(unsigned char event, unsigned long long time, const unsigned long long *args,
+                                  int argNum)
+{
+    (void)argNum;
+    switch (event) {
+        case TRACE_EV_GC_START & TRACE_EFFECTIVE_EVENT:
+            gc = PendingSpan{ true, time, args[0], args[1] };
+            break;
+        case TRACE_EV_GC_DONE & TRACE_EFFECTIVE_EVENT: {
+            if (!gc.started) {
+                break;
+            }
+            TraceExportRecord record{ TRACK_GC, "GC " + std::to_string(gc.arg), gc.begin, time, true, {} };
+            record.AddArg("reason", gc.arg2);
+            record.AddArg("collected bytes", args[0]);
+            Emit(std::move(record), 0);
+            gc.started = false;
+            break;
+        }
+        case TRACE_EV_GC_PHASE & TRACE_EFFECTIVE_EVENT: {
+            const size_t phaseNum = sizeof(TRACE_GC_PHASE_NAMES) / sizeof(TRACE_GC_PHASE_NAMES[0]);
+            if (gcPhase.started && gcPhase.arg < phaseNum) {
+                Emit(TraceExportRecord{ TRACK_GC_PHASE, TRACE_GC_PHASE_NAMES[gcPhase.arg], gcPhase.begin, time,
+                                        true, {} }, 0);
+            }
+            // idle and undef phases are the gaps between GCs.
+            gcPhase = PendingSpan{ args[0] > 1, time, args[0], 0 };
+            break;
+        }
+        case TRACE_EV_GC_STW_START & TRACE_EFFECTIVE_EVENT:
+            stw = PendingSpan{ true, time, 0, 0 };
+            break;
+        case TRACE_EV_GC_STW_DONE & TRACE_EFFECTIVE_EVENT:
+            if (stw.started) {
+                Emit(TraceExportRecord{ TRACK_STW, "stop the world", stw.begin, time, true, {} }, 0);
+                stw.started = false;
+            }
+            break;
+        case TRACE_EV_HEAP_ALLOC_REGION & TRACE_EFFECTIVE_EVENT:
+            WriteCounter(TRACK_HEAP, "heap used bytes", time, args[1]);
+            break;
+        case TRACE_EV_FINALIZER_START & TRACE_EFFECTIVE_EVENT:
+            finalizer = PendingSpan{ true, time, args[0], 0 };
+            break;
+        case TRACE_EV_FINALIZER_DONE & TRACE_EFFECTIVE_EVENT: {
+            if (!finalizer.started) {
+                break;
+            }
+            TraceExportRecord record{ TRACK_FINALIZER, "finalizers", finalizer.begin, time, true, {} };
+            record.AddArg("count", finalizer.arg);
+            Emit(std::move(record), 0);
+            finalizer.started = false;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+unsigned long long TraceExporter::ProcessorTrack()
+{
+    unsigned long long track = TRACK_PROCESSOR_BASE + processorId;
+    if (processorTracks.insert(processorId).second) {
+        WriteTrack(track, "processor " + std::to_string(processorId), false);
+    }
+    return track;
+}
+
+void TraceExporter::BeginRun(unsigned long long time, unsigned long long cjthreadId)
+{
+    EndRun(time, "unknown", 0);
+    runs[processorId] = CJThreadRun{ cjthreadId, time };
+}
+
+void TraceExporter::EndRun(unsigned long long time, const char *reason, unsigned long long stackId)
+{
+    auto run = runs.find(processorId);
+    if (run == runs.end()) {
+        return;
+    }
+    TraceExportRecord record{ ProcessorTrack(), "cjthread " + std::to_string(run->second.cjthreadId),
+                              run->second.begin, time, true, {} };
+    record.AddArg("cjthread", run->second.cjthreadId);
+    record.AddArg("end", std::string(reason));
+    runs.erase(run);
+    Emit(std::move(record), stackId);
+}
+
+void TraceExporter::AddInstant(const char *name, unsigned long long time, unsigned long long cjthreadId,
+                               unsigned long long stackId)
+{
+    TraceExportRecord record{ ProcessorTrack(), std::string(name) + " cjthread " + std::to_string(cjthreadId),
+                              time, time, false, {} };
+    record.AddArg("cjthread", cjthreadId);
+    Emit(std::move(record), stackId);
+}
+
+void TraceExporter::Emit(TraceExportRecord &&record, unsigned long long stackId)
+{
+    // stacks of special ids are recorded once when trace starts, which may be dumped after any other buffer.
+    static const char *const specialStacks[] = {
+        nullptr, TRACE_UNKNOWN_STRING, TRACE_EXIT_STRING, TRACE_RESCHED_STRING, TRACE_NET_BLOCK_STRING,
+        TRACE_NET_UNBLOCK_STRING, TRACE_UNBLOCK_STRING,
+    };
+    if (stackId == 0) {
+        WriteRecord(record);
+    } else if (stackId < SpecialStackId::OTHERS) {
+        record.AddArg("stack", std::string(specialStacks[stackId]));
+        WriteRecord(record);
+    } else {
+        pendingRecords[stackId] = std::move(record);
+    }
+}
+
+/* Close what is still running when trace stops, and write records whose stacks are never recorded. */
+void TraceExporter::Finish()
+{
+    for (auto &run : runs) {
+        processorId = run.first;
+        TraceExportRecord record{ ProcessorTrack(), "cjthread " + std::to_string(run.second.cjthreadId),
+                                  run.second.begin, lastTime, true, {} };
+        record.AddArg("cjthread", run.second.cjthreadId);
+        WriteRecord(record);
+    }
+    runs.clear();
+    for (auto &pending : pendingRecords) {
+        WriteRecord(pending.second);
+    }
+    pendingRecords.clear();
+    strings.clear();
+    WriteTrailer();
+    finished = true;
+}
+
+/* Trace event format of chrome://tracing and ui.perfetto.dev, one json object per line. Tracks are threads. */
+class ChromeTraceExporter : public TraceExporter {
+public:
+    using TraceExporter::TraceExporter;
+
+protected:
+    void WriteHeader() override
+    {
+        out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+        out += "{\"ph\":\"M\",\"pid\":" + std::to_string(pid) +
+            ",\"tid\":0,\"name\":\"process_name\",\"args\":{\"name\":\"cangjie\"}}";
+    }
+
+    void WriteTrack(unsigned long long track, const std::string &name, bool isCounter) override
+    {
+        if (isCounter) {
+            return;
+        }
+        out += ",\n{\"ph\":\"M\",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(track) +
+            ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        AppendString(name);
+        out += "}}";
+    }
+
+    void WriteRecord(const TraceExportRecord &record) override
+    {
+        out += record.isSlice ? ",\n{\"ph\":\"X\"" : ",\n{\"ph\":\"i\",\"s\":\"t\"";
+        out += ",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(record.track) + ",\"ts\":";
+        AppendTime(record.begin);
+        if (record.isSlice) {
+            out += ",\"dur\":";
+            AppendMicros(record.end - record.begin);
+        }
+        out += ",\"name\":";
+        AppendString(record.name);
+        out += ",\"args\":{";
+        for (size_t i = 0; i < record.args.size(); ++i) {
+            out += (i == 0) ? "\"" : ",\"";
+            out += record.args[i].name;
+            out += "\":";
+            if (record.args[i].isString) {
+                AppendString(record.args[i].str);
+            } else {
+                out += std::to_string(record.args[i].value);
+            }
+        }
+        out += "}}";
+    }
+
+    void WriteCounter(unsigned long long track, const char *name, unsigned long long time,
+                      unsigned long long value) override
+    {
+        out += ",\n{\"ph\":\"C\",\"pid\":" + std::to_string(pid) + ",\"tid\":" + std::to_string(track) + ",\"ts\":";
+        AppendTime(time);
+        out += ",\"name\":\"";
+        out += name;
+        out += "\",\"args\":{\"value\":" + std::to_string(value) + "}}";
+    }
+
+    void WriteTrailer() override { out += "\n]}\n"; }
+
+private:
+    /* microseconds since trace starts. */
+    void AppendTime(unsigned long long time) { AppendMicros(time - timeStart); }
+
+    void AppendMicros(unsigned long long nanos)
+    {
+        constexpr unsigned long long nanosPerMicro = 1000;
+        std::string fraction = std::to_string(nanos % nanosPerMicro);
+        out += std::to_string(nanos / nanosPerMicro) + "." + std::string(3 - fraction.size(), '0') + fraction;
+    }
+
+    void AppendString(const std::string &str)
+    {
+        static const char hexDigits[] = "0123456789abcdef";
+        out += '"';
+        for (unsigned char c : str) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += static_cast<char>(c);
+            } else if (c == '\n') {
+                out += "\\n";
+            } else if (c < 0x20) { // 0x20: first printable character
+                out += "\\u00";
+                out += hexDigits[c >> 4];   // 4: bits of a hex digit
+                out += hexDigits[c & 0xf];
+            } else {
+                out += static_cast<char>(c);
+            }
+        }
+        out += '"';
+    }
+
+    unsigned long long pid = static_cast<unsigned long long>(getpid());
+};
+
+/* Perfetto trace of track events, i.e., protos/perfetto/trace/trace.proto. Every packet is a field of Trace. */
+class PerfettoTraceExporter : public TraceExporter {
+public:
+    using TraceExporter::TraceExporter;
+
+protected:
+    void WriteHeader() override
+    {
+        std::string process;
+        AppendVarintField(process, PROCESS_DESCRIPTOR_PID, static_cast<unsigned long long>(getpid()));
+        AppendBytesField(process, PROCESS_DESCRIPTOR_NAME, "cangjie");
+        std::string track;
+        AppendVarintField(track, TRACK_DESCRIPTOR_UUID, TRACK_PROCESS);
+        AppendBytesField(track, TRACK_DESCRIPTOR_PROCESS, process);
+        std::string packet;
+        AppendVarintField(packet, PACKET_SEQUENCE_ID, SEQUENCE_ID);
+        AppendVarintField(packet, PACKET_SEQUENCE_FLAGS, SEQ_INCREMENTAL_STATE_CLEARED);
+        AppendBytesField(packet, PACKET_TRACK_DESCRIPTOR, track);
+        AppendBytesField(out, TRACE_PACKET, packet);
+    }
+
+    void WriteTrack(unsigned long long uuid, const std::string &name, bool isCounter) override
+    {
+        std::string track;
+        AppendVarintField(track, TRACK_DESCRIPTOR_UUID, uuid);
+        AppendVarintField(track, TRACK_DESCRIPTOR_PARENT_UUID, TRACK_PROCESS);
+        AppendBytesField(track, TRACK_DESCRIPTOR_NAME, name);
+        if (isCounter) {
+            std::string counter;
+            AppendVarintField(counter, COUNTER_DESCRIPTOR_UNIT, UNIT_SIZE_BYTES);
+            AppendBytesField(track, TRACK_DESCRIPTOR_COUNTER, counter);
+        }
+        std::string packet;
+        AppendVarintField(packet, PACKET_SEQUENCE_ID, SEQUENCE_ID);
+        AppendBytesField(packet, PACKET_TRACK_DESCRIPTOR, track);
+        AppendBytesField(out, TRACE_PACKET, packet);
+    }
+
+    void WriteRecord(const TraceExportRecord &record) override
+    {
+        std::string event;
+        AppendVarintField(event, TRACK_EVENT_TYPE, record.isSlice ? TYPE_SLICE_BEGIN : TYPE_INSTANT);
+        AppendVarintField(event, TRACK_EVENT_TRACK_UUID, record.track);
+        AppendBytesField(event, TRACK_EVENT_NAME, record.name);
+        for (const TraceExportArg &arg : record.args) {
+            std::string annotation;
+            AppendBytesField(annotation, DEBUG_ANNOTATION_NAME, arg.name);
+            if (arg.isString) {
+                AppendBytesField(annotation, DEBUG_ANNOTATION_STRING_VALUE, arg.str);
+            } else {
+                AppendVarintField(annotation, DEBUG_ANNOTATION_UINT_VALUE, arg.value);
+            }
+            AppendBytesField(event, TRACK_EVENT_DEBUG_ANNOTATIONS, annotation);
+        }
+        AppendEventPacket(record.begin, event);
+        if (record.isSlice) {
+            event.clear();
+            AppendVarintField(event, TRACK_EVENT_TYPE, TYPE_SLICE_END);
+            AppendVarintField(event, TRACK_EVENT_TRACK_UUID, record.track);
+            AppendEventPacket(record.end, event);
+        }
+    }
+
+    void WriteCounter(unsigned long long track, const char *name, unsigned long long time,
+                      unsigned long long value) override
+    {
+        (void)name;
+        std::string event;
+        AppendVarintField(event, TRACK_EVENT_TYPE, TYPE_COUNTER);
+        AppendVarintField(event, TRACK_EVENT_TRACK_UUID, track);
+        AppendVarintField(event, TRACK_EVENT_COUNTER_VALUE, value);
+        AppendEventPacket(time, event);
+    }
+
+    void WriteTrailer() override {}
+
+private:
+    // field numbers and enum values in perfetto protos.
+    static constexpr unsigned int TRACE_PACKET = 1;
+    static constexpr unsigned int PACKET_TIMESTAMP = 8;
+    static constexpr unsigned int PACKET_SEQUENCE_ID = 10;
+    static constexpr unsigned int PACKET_TRACK_EVENT = 11;
+    static constexpr unsigned int PACKET_SEQUENCE_FLAGS = 13;
+    static constexpr unsigned int PACKET_TIMESTAMP_CLOCK_ID = 58;
+    static constexpr unsigned int PACKET_TRACK_DESCRIPTOR = 60;
+    static constexpr unsigned int TRACK_DESCRIPTOR_UUID = 1;
+    static constexpr unsigned int TRACK_DESCRIPTOR_NAME = 2;
+    static constexpr unsigned int TRACK_DESCRIPTOR_PROCESS = 3;
+    static constexpr unsigned int TRACK_DESCRIPTOR_PARENT_UUID = 5;
+    static constexpr unsigned int TRACK_DESCRIPTOR_COUNTER = 8;
+    static constexpr unsigned int PROCESS_DESCRIPTOR_PID = 1;
+    static constexpr unsigned int PROCESS_DESCRIPTOR_NAME = 6;
+    static constexpr unsigned int COUNTER_DESCRIPTOR_UNIT = 3;
+    static constexpr unsigned int TRACK_EVENT_DEBUG_ANNOTATIONS = 4;
+    static constexpr unsigned int TRACK_EVENT_TYPE = 9;
+    static constexpr unsigned int TRACK_EVENT_TRACK_UUID = 11;
+    static constexpr unsigned int TRACK_EVENT_NAME = 23;
+    static constexpr unsigned int TRACK_EVENT_COUNTER_VALUE = 30;
+    static constexpr unsigned int DEBUG_ANNOTATION_UINT_VALUE = 3;
+    static constexpr unsigned int DEBUG_ANNOTATION_STRING_VALUE = 6;
+    static constexpr unsigned int DEBUG_ANNOTATION_NAME = 10;
+    static constexpr unsigned long long TYPE_SLICE_BEGIN = 1;
+    static constexpr unsigned long long TYPE_SLICE_END = 2;
+    static constexpr unsigned long long TYPE_INSTANT = 3;
+    static constexpr unsigned long long TYPE_COUNTER = 4;
+    static constexpr unsigned long long UNIT_SIZE_BYTES = 3;
+    static constexpr unsigned long long SEQ_INCREMENTAL_STATE_CLEARED = 1;
+    static constexpr unsigned long long BUILTIN_CLOCK_MONOTONIC = 3;
+    static constexpr unsigned long long SEQUENCE_ID = 1;
+    static constexpr unsigned int WIRE_TYPE_VARINT = 0;
+    static constexpr unsigned int WIRE_TYPE_BYTES = 2;
+    static constexpr unsigned int WIRE_TYPE_BITS = 3;
+
+    static void AppendVarint(std::string &buf, unsigned long long value)
+    {
+        for (; value >= TRACE_UINT64_SHIFT_THRESHOLD; value >>= TRACE_UINT64_SHIFTS) {
+            buf += static_cast<char>(TRACE_UINT64_SHIFT_THRESHOLD | (value & (TRACE_UINT64_SHIFT_THRESHOLD - 1)));
+        }
+        buf += static_cast<char>(value);
+    }
+
+    static void AppendVarintField(std::string &buf, unsigned int field, unsigned long long value)
+    {
+        AppendVarint(buf, (static_cast<unsigned long long>(field) << WIRE_TYPE_BITS) | WIRE_TYPE_VARINT);
+        AppendVarint(buf, value);
+    }
+
+    static void AppendBytesField(std::string &buf, unsigned int field, const std::string &bytes)
+    {
+        AppendVarint(buf, (static_cast<unsigned long long>(field) << WIRE_TYPE_BITS) | WIRE_TYPE_BYTES);
+        AppendVarint(buf, bytes.size());
+        buf += bytes;
+    }
+
+    void AppendEventPacket(unsigned long long time, const std::string &event)
+    {
+        std::string packet;
+        AppendVarintField(packet, PACKET_TIMESTAMP, time);
+        AppendVarintField(packet, PACKET_TIMESTAMP_CLOCK_ID, BUILTIN_CLOCK_MONOTONIC);
+        AppendVarintField(packet, PACKET_SEQUENCE_ID, SEQUENCE_ID);
+        AppendBytesField(packet, PACKET_TRACK_EVENT, event);
+        AppendBytesField(out, TRACE_PACKET, packet);
+    }
+};
+
+TraceExporter *g_traceExporter = nullptr;
+} // namespace
+
+#ifdef  __cplusplus
+extern "C" {
+#endif
+
+void TraceExportStart(void)
+{
+    TraceExportStop();
+    const char *format = std::getenv("cjTraceFormat");
+    if (format == nullptr || strcmp(format, "raw") == 0) {
+        return;
+    }
+    unsigned long long ticksStart = g_scheduleManager.trace.ticksStart;
+    unsigned long long timeStart = g_scheduleManager.trace.timeStart;
+    if (strcmp(format, "chrome") == 0) {
+        g_traceExporter = new (std::nothrow) ChromeTraceExporter(ticksStart, timeStart);
+    } else if (strcmp(format, "perfetto") == 0) {
+        g_traceExporter = new (std::nothrow) PerfettoTraceExporter(ticksStart, timeStart);
+    } else {
+        LOG_ERROR(ERRNO_TRACE_EXPORT_FORMAT, "unsupported cjTraceFormat %s, trace is dumped raw", format);
+        return;
+    }
+    if (g_traceExporter == nullptr) {
+        LOG_ERROR(ERRNO_TRACE_MALLOC_FAILED, "new trace exporter failed");
+    }
+}
+
+unsigned char *TraceExportChunk(unsigned char *data, int *len)
+{
+    if (g_traceExporter == nullptr || data == nullptr) {
+        return data;
+    }
+    const std::string &converted = g_traceExporter->Convert(data, *len);
+    *len = static_cast<int>(converted.size());
+    return reinterpret_cast<unsigned char *>(const_cast<char *>(converted.data()));
+}
+
+void TraceExportStop(void)
+{
+    delete g_traceExporter;
+    g_traceExporter = nullptr;
+}
+
+#ifdef  __cplusplus
+}
+#endif
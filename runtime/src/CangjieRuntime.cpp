@@ -22,6 +22,7 @@
 #endif
 #include "Common/ScopedObjectAccess.h"
 #include "Concurrency/Concurrency.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #include "Heap/Collector/FinalizerProcessor.h"
 #include "Heap/Heap.h"
 #include "LoaderManager.h"
@@ -172,6 +173,7 @@ void CangjieRuntime::Init()
     loaderManager->Init();
     objectManager = NewAndInit<ObjectManager>();
     exceptionManager = NewAndInit<ExceptionManager>();
+    ContentionProfiler::Instance().InitFromEnv();
 
     LOG(RTLOG_INFO, "Cangjie runtime started.");
     // Record runtime parameter to report. heap growth value needs to plus 1.
@@ -411,6 +411,7 @@ bool MRT_NewForeignCJThread()
         ThreadLocal::SetSchedule(scheduler);
         ThreadLocal::SetProtectAddr(nullptr);
         ScheduleNetpollInit(); // Initializes netpool only on the first execution.
+        CpuProfiler::AttachThread();
     }
 
     void* cjthread = ThreadLocal::GetForeignCJThread();
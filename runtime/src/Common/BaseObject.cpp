@@ -5,6 +5,7 @@
 // See https://cangjie-lang.cn/pages/LICENSE for license information.
 
 #include "BaseObject.h"
+#include "BaseObject.inline.h"
 #include "Heap/Allocator/RegionInfo.h"
 #include "Heap/Collector/FinalizerProcessor.h"
 #include "Mutator/Mutator.h"
@@ -47,93 +48,11 @@ void BaseObject::DumpObject(int logtype, bool isSimple) const
 }
 #endif
 
-static void ForEachRefFieldInNonArrayObject(ObjectPtr obj, const RefFieldVisitor& visitor)
-{
-    GCTib gcTib = obj->GetGCTib();
-    // gcTib record payload data, skip the TypeInfo
-    MAddress objAddr = reinterpret_cast<MAddress>(obj) + TYPEINFO_PTR_SIZE;
-    gcTib.ForEachBitmapWord(objAddr, visitor);
-}
-
-// Call func on each element in an object array.
-static void ForEachElementInArray(ObjectPtr obj, const RefFieldVisitor& visitor)
-{
-    // take array length and content.
-    MArray* mArray = reinterpret_cast<MArray*>(obj);
-    MIndex arrayLengthVal = mArray->GetLength();
-    TypeInfo* componentTypeInfo = mArray->GetComponentTypeInfo();
-    if (componentTypeInfo->IsStructType()) {
-        GCTib gcTib = componentTypeInfo->GetGCTib();
-        MAddress contentAddr = reinterpret_cast<Uptr>(mArray) + MArray::GetContentOffset();
-        for (MIndex i = 0; i < arrayLengthVal; ++i) {
-            gcTib.ForEachBitmapWord(contentAddr, visitor);
-            contentAddr += mArray->GetElementSize();
-        }
-    } else if (componentTypeInfo->IsObjectType() || componentTypeInfo->IsArrayType() ||
-               componentTypeInfo->IsInterface()) {
-        RefField<>* arrayContent = reinterpret_cast<RefField<>*>(mArray->ConvertToCArray());
-        // for each object in array.
-        for (MIndex i = 0; i < arrayLengthVal; ++i) {
-            visitor(arrayContent[i]);
-        }
-    } else {
-        LOG(RTLOG_FATAL, "array object %p has wrong component type", mArray);
-    }
-}
-
-void BaseObject::ForEachRefField(const RefFieldVisitor& visitor)
-{
-    TypeInfo* typeInfo = GetTypeInfo();
-    if (typeInfo->HasRefField()) {
-        if (UNLIKELY(typeInfo->IsRawArray())) {
-            ForEachElementInArray(this, visitor);
-        } else {
-            ForEachRefFieldInNonArrayObject(this, visitor);
-        }
-    }
-};
+void BaseObject::ForEachRefField(const RefFieldVisitor& visitor) { ScanRefFields(visitor); }
 
 void BaseObject::ForEachRefInStruct(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd)
 {
-    TypeInfo* typeInfo = GetTypeInfo();
-    if (typeInfo->HasRefField()) {
-        if (UNLIKELY(typeInfo->IsRawArray())) {
-            ForEachAggRefFieldInArray(visitor, aggStart, aggEnd);
-        } else {
-            ForEachAggRefFieldInNonArray(visitor, aggStart, aggEnd);
-        }
-    }
-}
-
-void BaseObject::ForEachAggRefFieldInArray(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd)
-{
-    // take array length and content.
-    MArray* mArray = static_cast<MArray*>(this);
-    MIndex arrayLen = mArray->GetLength();
-    TypeInfo* component = mArray->GetComponentTypeInfo();
-    if (component->IsStructType()) {
-        GCTib gcTib = component->GetGCTib();
-        MAddress contentAddr = reinterpret_cast<Uptr>(this) + MArray::GetContentOffset();
-        size_t contentSize = mArray->GetElementSize();
-        // MIndex is enough to describe the size;
-        MIndex startIndex = static_cast<MIndex>((aggStart - contentAddr) / contentSize);
-        size_t alignedStart = startIndex * contentSize + contentAddr;
-        MRT_ASSERT((alignedStart + contentSize) >= aggEnd, "aggregate element is not align\n");
-        MAddress currentAddr = alignedStart;
-        for (U64 i = startIndex; (i < arrayLen) && (currentAddr < aggEnd); ++i) {
-            gcTib.ForEachBitmapWord(currentAddr, visitor);
-            currentAddr += contentSize;
-        }
-    } else {
-        LOG(RTLOG_FATAL, "this interface mustn't be invoked by array whose element is not record");
-    }
-}
-
-void BaseObject::ForEachAggRefFieldInNonArray(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd) const
-{
-    // gcTib record payload data, skip the TypeInfo
-    GetGCTib().ForEachBitmapWordInRange(reinterpret_cast<MAddress>(this) + TYPEINFO_PTR_SIZE, visitor, aggStart,
-                                        aggEnd);
+    ScanRefsInStruct(visitor, aggStart, aggEnd);
 }
 
 size_t BaseObject::GetSize() const
@@ -33,7 +33,16 @@ public:
 
     void ForEachRefField(const RefFieldVisitor& visitor);
 
+    // same as ForEachRefField, but specialized for each visitor type so that visitor is inlined into the scan loops.
+    // defined in BaseObject.inline.h.
+    template<typename Visitor>
+    void ScanRefFields(Visitor&& visitor);
+
     void ForEachRefInStruct(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd);
+
+    // same as ForEachRefInStruct, but specialized for each visitor type. defined in BaseObject.inline.h.
+    template<typename Visitor>
+    void ScanRefsInStruct(Visitor&& visitor, MAddress aggStart, MAddress aggEnd);
     // size in bytes
     size_t GetSize() const;
 
@@ -98,8 +107,6 @@ private:
     // We cannot explicit construct BaseObject and destruct it
     BaseObject() = delete;
     ~BaseObject() = delete;
-    void ForEachAggRefFieldInArray(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd);
-    void ForEachAggRefFieldInNonArray(const RefFieldVisitor& visitor, MAddress aggStart, MAddress aggEnd) const;
 
     // The only contract between Managed Heap and other modules
     StateWord stateWord;
@@ -0,0 +1,102 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+#ifndef MRT_BASE_OBJECT_INLINE_H
+#define MRT_BASE_OBJECT_INLINE_H
+
+#include "Common/BaseObject.h"
+#include "ObjectModel/MArray.h"
+#include "ObjectModel/MArray.inline.h"
+
+namespace MapleRuntime {
+// referents of ref-array elements this far ahead are prefetched, so that the visitor rarely waits for their headers.
+constexpr MIndex REF_ARRAY_PREFETCH_DISTANCE = 8;
+constexpr int REF_ARRAY_PREFETCH_LOCALITY = 3;
+
+template<typename Visitor>
+inline void ScanRefArray(RefField<>* arrayContent, MIndex length, Visitor&& visitor)
+{
+    MIndex i = 0;
+    if (length > REF_ARRAY_PREFETCH_DISTANCE) {
+        for (; i < length - REF_ARRAY_PREFETCH_DISTANCE; ++i) {
+            // prefetch never faults, so null or stale referents need no check here.
+            __builtin_prefetch(arrayContent[i + REF_ARRAY_PREFETCH_DISTANCE].GetTargetObject(), 0,
+                               REF_ARRAY_PREFETCH_LOCALITY);
+            visitor(arrayContent[i]);
+        }
+    }
+    for (; i < length; ++i) {
+        visitor(arrayContent[i]);
+    }
+}
+
+template<typename Visitor>
+inline void BaseObject::ScanRefFields(Visitor&& visitor)
+{
+    TypeInfo* typeInfo = GetTypeInfo();
+    if (!typeInfo->HasRefField()) {
+        return;
+    }
+    if (LIKELY(!typeInfo->IsRawArray())) {
+        // gcTib record payload data, skip the TypeInfo
+        typeInfo->GetGCTib().ForEachRef(reinterpret_cast<MAddress>(this) + TYPEINFO_PTR_SIZE, visitor);
+        return;
+    }
+
+    MArray* mArray = reinterpret_cast<MArray*>(this);
+    MIndex arrayLengthVal = mArray->GetLength();
+    TypeInfo* componentTypeInfo = mArray->GetComponentTypeInfo();
+    if (componentTypeInfo->IsObjectType() || componentTypeInfo->IsArrayType() || componentTypeInfo->IsInterface()) {
+        ScanRefArray(reinterpret_cast<RefField<>*>(mArray->ConvertToCArray()), arrayLengthVal, visitor);
+    } else if (componentTypeInfo->IsStructType()) {
+        GCTib gcTib = componentTypeInfo->GetGCTib();
+        MAddress contentAddr = reinterpret_cast<Uptr>(mArray) + MArray::GetContentOffset();
+        size_t elementSize = mArray->GetElementSize();
+        for (MIndex i = 0; i < arrayLengthVal; ++i) {
+            gcTib.ForEachRef(contentAddr, visitor);
+            contentAddr += elementSize;
+        }
+    } else {
+        LOG(RTLOG_FATAL, "array object %p has wrong component type", mArray);
+    }
+}
+template<typename Visitor>
+inline void BaseObject::ScanRefsInStruct(Visitor&& visitor, MAddress aggStart, MAddress aggEnd)
+{
+    TypeInfo* typeInfo = GetTypeInfo();
+    if (!typeInfo->HasRefField()) {
+        return;
+    }
+    if (LIKELY(!typeInfo->IsRawArray())) {
+        // gcTib record payload data, skip the TypeInfo
+        typeInfo->GetGCTib().ForEachRefInRange(reinterpret_cast<MAddress>(this) + TYPEINFO_PTR_SIZE, visitor, aggStart,
+                                               aggEnd);
+        return;
+    }
+
+    // take array length and content.
+    MArray* mArray = reinterpret_cast<MArray*>(this);
+    MIndex arrayLen = mArray->GetLength();
+    TypeInfo* component = mArray->GetComponentTypeInfo();
+    if (!component->IsStructType()) {
+        LOG(RTLOG_FATAL, "this interface mustn't be invoked by array whose element is not record");
+        return;
+    }
+    GCTib gcTib = component->GetGCTib();
+    MAddress contentAddr = reinterpret_cast<Uptr>(this) + MArray::GetContentOffset();
+    size_t contentSize = mArray->GetElementSize();
+    // MIndex is enough to describe the size;
+    MIndex startIndex = static_cast<MIndex>((aggStart - contentAddr) / contentSize);
+    size_t alignedStart = startIndex * contentSize + contentAddr;
+    MRT_ASSERT((alignedStart + contentSize) >= aggEnd, "aggregate element is not align\n");
+    MAddress currentAddr = alignedStart;
+    for (U64 i = startIndex; (i < arrayLen) && (currentAddr < aggEnd); ++i) {
+        gcTib.ForEachRef(currentAddr, visitor);
+        currentAddr += contentSize;
+    }
+}
+} // namespace MapleRuntime
+#endif // MRT_BASE_OBJECT_INLINE_H
@@ -46,8 +46,29 @@ extern "C" MRT_EXPORT size_t CJ_MCC_GetGCCount() __attribute__((alias("MCC_GetGC
 extern "C" MRT_EXPORT bool CJ_MCC_IsGCRunning() __attribute__((alias("MCC_IsGCRunning")));
 extern "C" MRT_EXPORT uint64_t CJ_MCC_GetGCTimeUs() __attribute__((alias("MCC_GetGCTimeUs")));
 extern "C" MRT_EXPORT size_t CJ_MCC_GetGCFreedSize() __attribute__((alias("MCC_GetGCFreedSize")));
+extern "C" MRT_EXPORT uint64_t CJ_MCC_GetGCPauseTimeNs() __attribute__((alias("MCC_GetGCPauseTimeNs")));
+extern "C" MRT_EXPORT size_t CJ_MCC_GetThreadAllocatedBytes() __attribute__((alias("MCC_GetThreadAllocatedBytes")));
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapDirtySize() __attribute__((alias("MCC_GetHeapDirtySize")));
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapReleasedSize() __attribute__((alias("MCC_GetHeapReleasedSize")));
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapScavengedSize() __attribute__((alias("MCC_GetHeapScavengedSize")));
+extern "C" MRT_EXPORT void CJ_MCC_ReleaseHeapMemory() __attribute__((alias("MCC_ReleaseHeapMemory")));
 extern "C" MRT_EXPORT size_t CJ_MCC_StartCpuProfiling() __attribute__((alias("MCC_StartCpuProfiling")));
 extern "C" MRT_EXPORT size_t CJ_MCC_StopCpuProfiling(int fd) __attribute__((alias("MCC_StopCpuProfiling")));
+extern "C" MRT_EXPORT bool CJ_MCC_StopCpuProfilingWithFormat(int fd, int format)
+    __attribute__((alias("MCC_StopCpuProfilingWithFormat")));
+extern "C" MRT_EXPORT bool CJ_MCC_StartAllocSampling(size_t intervalBytes)
+    __attribute__((alias("MCC_StartAllocSampling")));
+extern "C" MRT_EXPORT bool CJ_MCC_StopAllocSampling() __attribute__((alias("MCC_StopAllocSampling")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpAllocSamples(int fd) __attribute__((alias("MCC_DumpAllocSamples")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpAllocSamplesWithFormat(int fd, int format)
+    __attribute__((alias("MCC_DumpAllocSamplesWithFormat")));
+extern "C" MRT_EXPORT bool CJ_MCC_StartLockProfiling(uint32_t rate) __attribute__((alias("MCC_StartLockProfiling")));
+extern "C" MRT_EXPORT bool CJ_MCC_StopLockProfiling() __attribute__((alias("MCC_StopLockProfiling")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpLockProfile(int fd) __attribute__((alias("MCC_DumpLockProfile")));
+extern "C" MRT_EXPORT bool CJ_MCC_DumpLockProfileWithFormat(int fd, int format)
+    __attribute__((alias("MCC_DumpLockProfileWithFormat")));
+extern "C" MRT_EXPORT bool CJ_MCC_GetLockContentionStats(int kind, uint64_t* contentions, uint64_t* delayNanos)
+    __attribute__((alias("MCC_GetLockContentionStats")));
 extern "C" MRT_EXPORT void CJ_MCC_SetGCThreshold(uint64_t GCThreshold) __attribute__((alias("MCC_SetGCThreshold")));
 extern "C" MRT_EXPORT void* CJ_MCC_PostThrowException(ExceptionWrapper* mExceptionWrapper)
     __attribute__((alias("MCC_PostThrowException")));
@@ -27,6 +27,8 @@
 #endif
 #include "Common/ScopedObjectAccess.h"
 #include "ExceptionManager.inline.h"
+#include "Heap/Allocator/AllocSampler.h"
+#include "Heap/Allocator/RegionSpace.h"
 #include "Heap/Barrier/Barrier.h"
 #include "Heap/Collector/CollectorResources.h"
 #include "Heap/Heap.h"
@@ -41,7 +43,9 @@
 #endif
 #include "Sync/Sync.h"
 #include "UnwindStack/GcStackInfo.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #include "CpuProfiler/CpuProfiler.h"
+#include "CpuProfiler/ProfileWriter.h"
 #ifdef __OHOS__
 #include "schedule.h"
 #include "Base/SpinLock.h"
@@ -430,6 +434,33 @@ extern "C" uint64_t MCC_GetGCTimeUs() { return g_gcTotalTimeUs; }
 
 extern "C" size_t MCC_GetGCFreedSize() { return g_gcCollectedTotalBytes; }
 
+extern "C" uint64_t MCC_GetGCPauseTimeNs() { return g_stwTotalTimeNs; }
+
+extern "C" size_t MCC_GetThreadAllocatedBytes()
+{
+    Mutator* mutator = Mutator::GetMutator();
+    return mutator == nullptr ? 0 : mutator->GetAllocatedBytes();
+}
+
+extern "C" size_t MCC_GetHeapDirtySize()
+{
+    RegionManager& manager = reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator()).GetRegionManager();
+    return (manager.GetDirtyUnitCount() + manager.GetLazyReleasedUnitCount()) * RegionInfo::UNIT_SIZE;
+}
+
+extern "C" size_t MCC_GetHeapReleasedSize()
+{
+    RegionManager& manager = reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator()).GetRegionManager();
+    return manager.GetReleasedUnitCount() * RegionInfo::UNIT_SIZE;
+}
+
+extern "C" size_t MCC_GetHeapScavengedSize()
+{
+    return reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator()).GetRegionManager().GetScavengedSize();
+}
+
+extern "C" void MCC_ReleaseHeapMemory() { Heap::GetHeap().GetFinalizerProcessor().NotifyToReleaseGarbage(); }
+
 extern "C" bool MCC_StartCpuProfiling()
 {
     return CpuProfiler::GetInstance().StartCpuProfilerForFile();
@@ -437,7 +468,67 @@ extern "C" bool MCC_StartCpuProfiling()
 
 extern "C" bool MCC_StopCpuProfiling(int fd)
 {
-    return CpuProfiler::GetInstance().StopCpuProfilerForFile(fd);
+    return CpuProfiler::GetInstance().StopCpuProfilerForFile(fd, ProfileWriter::FormatFromEnv());
+}
+
+extern "C" bool MCC_StopCpuProfilingWithFormat(int fd, int format)
+{
+    if (!ProfileWriter::IsValidFormat(format)) {
+        LOG(RTLOG_ERROR, "Unsupported profile format %d", format);
+        return false;
+    }
+    return CpuProfiler::GetInstance().StopCpuProfilerForFile(fd, static_cast<ProfileFormat>(format));
+}
+
+extern "C" bool MCC_StartAllocSampling(size_t intervalBytes)
+{
+    return AllocSampler::Instance().Start(intervalBytes);
+}
+
+extern "C" bool MCC_StopAllocSampling() { return AllocSampler::Instance().Stop(); }
+
+extern "C" bool MCC_DumpAllocSamples(int fd)
+{
+    return AllocSampler::Instance().Dump(fd, ProfileWriter::FormatFromEnv());
+}
+
+extern "C" bool MCC_DumpAllocSamplesWithFormat(int fd, int format)
+{
+    if (!ProfileWriter::IsValidFormat(format)) {
+        LOG(RTLOG_ERROR, "Unsupported profile format %d", format);
+        return false;
+    }
+    return AllocSampler::Instance().Dump(fd, static_cast<ProfileFormat>(format));
+}
+
+extern "C" bool MCC_StartLockProfiling(uint32_t rate) { return ContentionProfiler::Instance().Start(rate); }
+
+extern "C" bool MCC_StopLockProfiling() { return ContentionProfiler::Instance().Stop(); }
+
+extern "C" bool MCC_DumpLockProfile(int fd)
+{
+    return ContentionProfiler::Instance().Dump(fd, ProfileWriter::FormatFromEnv());
+}
+
+extern "C" bool MCC_DumpLockProfileWithFormat(int fd, int format)
+{
+    if (!ProfileWriter::IsValidFormat(format)) {
+        LOG(RTLOG_ERROR, "Unsupported profile format %d", format);
+        return false;
+    }
+    return ContentionProfiler::Instance().Dump(fd, static_cast<ProfileFormat>(format));
+}
+
+extern "C" bool MCC_GetLockContentionStats(int kind, uint64_t* contentions, uint64_t* delayNanos)
+{
+    if (kind < 0 || kind >= static_cast<int>(LockKind::LOCK_KIND_NUM) || contentions == nullptr ||
+        delayNanos == nullptr) {
+        return false;
+    }
+    LockContentionStats stats = ContentionProfiler::Instance().GetStats(static_cast<LockKind>(kind));
+    *contentions = stats.contentions;
+    *delayNanos = stats.delayNanos;
+    return true;
 }
 
 extern "C" void MCC_SetGCThreshold(uint64_t GCThreshold) { Runtime::Current().SetGCThreshold(GCThreshold); }
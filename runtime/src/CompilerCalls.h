@@ -66,10 +66,35 @@ extern "C" size_t MCC_GetNativeThreadNumber();
 extern "C" size_t MCC_GetGCCount();
 extern "C" uint64_t MCC_GetGCTimeUs();
 extern "C" size_t MCC_GetGCFreedSize();
+// total time of stop-the-world pauses.
+extern "C" uint64_t MCC_GetGCPauseTimeNs();
+// bytes allocated by current cjthread.
+extern "C" size_t MCC_GetThreadAllocatedBytes();
 extern "C" bool MCC_IsGCRunning();
 
+// free heap memory kept by runtime and returned to system
+extern "C" size_t MCC_GetHeapDirtySize();
+extern "C" size_t MCC_GetHeapReleasedSize();
+extern "C" size_t MCC_GetHeapScavengedSize();
+// Called when system reports memory pressure, free heap memory is returned to system asynchronously.
+extern "C" void MCC_ReleaseHeapMemory();
+
 extern "C" bool MCC_StartCpuProfiling();
 extern "C" bool MCC_StopCpuProfiling(int fd);
+// format is a ProfileFormat, i.e., 0 for .cpuprofile json, 1 for pprof and 2 for collapsed stacks.
+extern "C" bool MCC_StopCpuProfilingWithFormat(int fd, int format);
+// sample about one allocation every intervalBytes per thread, 0 for default interval.
+extern "C" bool MCC_StartAllocSampling(size_t intervalBytes);
+extern "C" bool MCC_StopAllocSampling();
+extern "C" bool MCC_DumpAllocSamples(int fd);
+extern "C" bool MCC_DumpAllocSamplesWithFormat(int fd, int format);
+// record about one in `rate` contended lock acquisitions with stacks, 0 for every one.
+extern "C" bool MCC_StartLockProfiling(uint32_t rate);
+extern "C" bool MCC_StopLockProfiling();
+extern "C" bool MCC_DumpLockProfile(int fd);
+extern "C" bool MCC_DumpLockProfileWithFormat(int fd, int format);
+// kind is a LockKind. Return false if kind is invalid.
+extern "C" bool MCC_GetLockContentionStats(int kind, uint64_t* contentions, uint64_t* delayNanos);
 // for general array allocation
 extern "C" ArrayRef MCC_NewArray(const TypeInfo* arrayInfo, MIndex nElems);
 
@@ -0,0 +1,358 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "CpuProfiler/ContentionProfiler.h"
+
+#include <algorithm>
+#include <unistd.h>
+#include <unwind.h>
+
+#include "Base/CString.h"
+#include "Base/Log.h"
+#include "os/Loader.h"
+#include "StackManager.h"
+
+namespace MapleRuntime {
+namespace {
+constexpr uint64_t NS_PER_US = 1000;
+constexpr uint64_t NS_PER_MS = 1000 * 1000;
+// pointer hash of lock addresses, whose low bits are always zero.
+constexpr uint32_t LOCK_ADDRESS_SHIFT = 4;
+
+const char* const LOCK_KIND_NAMES[] = {
+    "CJMutex", "CJMonitor", "CJMultiConditionMonitor", "GCThreadPool", "ScheduleGlobalQueue", "TypeInfoBucket",
+};
+
+struct NativeUnwindState {
+    std::vector<uint64_t>* frames;
+    size_t skip;
+};
+
+_Unwind_Reason_Code CollectNativeFrame(struct _Unwind_Context* context, void* arg)
+{
+    NativeUnwindState* state = static_cast<NativeUnwindState*>(arg);
+    uintptr_t pc = _Unwind_GetIP(context);
+    if (pc == 0) {
+        return _URC_END_OF_STACK;
+    }
+    if (state->skip > 0) {
+        --state->skip;
+        return _URC_NO_REASON;
+    }
+    state->frames->push_back(static_cast<uint64_t>(pc));
+    return state->frames->size() < ContentionProfiler::MAX_CONTENTION_FRAMES ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+
+// runtime locks are taken by gc and scheduler threads as well, which have no cangjie frames.
+void RecordNativeFrames(std::vector<uint64_t>& frames)
+{
+    // skip frames of the profiler itself.
+    constexpr size_t profilerFrames = 2;
+    NativeUnwindState state = { &frames, profilerFrames };
+    (void)_Unwind_Backtrace(CollectNativeFrame, &state);
+}
+} // namespace
+
+struct ContentionProfiler::Sample {
+    SiteKey key;
+    uint64_t delay;
+    Sample* next;
+};
+
+std::atomic<bool> ContentionProfiler::enabled = { false };
+
+ContentionProfiler& ContentionProfiler::Instance() noexcept
+{
+    static ContentionProfiler instance;
+    return instance;
+}
+
+const char* ContentionProfiler::GetLockKindName(LockKind kind)
+{
+    size_t index = static_cast<size_t>(kind);
+    return index < static_cast<size_t>(LockKind::LOCK_KIND_NUM) ? LOCK_KIND_NAMES[index] : "<unknown>";
+}
+
+void ContentionProfiler::InitFromEnv()
+{
+    auto env = std::getenv("cjLockProfileRate");
+    if (env == nullptr) {
+        return;
+    }
+    size_t rate = CString::ParsePosNumFromEnv(env);
+    if (rate == 0 || rate > UINT32_MAX) {
+        LOG(RTLOG_ERROR, "Unsupported cjLockProfileRate parameter. It should be a positive integer.\n");
+        return;
+    }
+    (void)Start(static_cast<uint32_t>(rate));
+}
+
+bool ContentionProfiler::Start(uint32_t rate)
+{
+    std::lock_guard<std::mutex> lg(siteMutex);
+    if (IsEnabled()) {
+        LOG(RTLOG_ERROR, "Start lock profiling repeatedly.");
+        return false;
+    }
+    sampleRate = rate == 0 ? 1 : rate;
+    startTime = TimeUtil::NanoSeconds();
+    RecordSamples(queuedSamples.exchange(nullptr, std::memory_order_acquire));
+    sites.clear();
+    // waits left by a previous session would be reported with the delay since their begin time.
+    for (PendingWait& pending : pendingWaits) {
+        pending.lock.store(nullptr, std::memory_order_relaxed);
+        pending.beginTime.store(0, std::memory_order_relaxed);
+    }
+    sampleCounter.store(0, std::memory_order_relaxed);
+    for (size_t i = 0; i < static_cast<size_t>(LockKind::LOCK_KIND_NUM); ++i) {
+        contentions[i].store(0, std::memory_order_relaxed);
+        delays[i].store(0, std::memory_order_relaxed);
+    }
+    enabled.store(true, std::memory_order_relaxed);
+    VLOG(REPORT, "lock profiling started, sample rate 1/%u", sampleRate);
+    return true;
+}
+
+bool ContentionProfiler::Stop()
+{
+    std::lock_guard<std::mutex> lg(siteMutex);
+    if (!IsEnabled()) {
+        LOG(RTLOG_ERROR, "Lock profiling is not started.");
+        return false;
+    }
+    enabled.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+bool ContentionProfiler::ShouldSample()
+{
+    return sampleRate <= 1 || sampleCounter.fetch_add(1, std::memory_order_relaxed) % sampleRate == 0;
+}
+
+ContentionProfiler::PendingWait& ContentionProfiler::GetPendingWait(const void* lock)
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(lock);
+    return pendingWaits[(address >> LOCK_ADDRESS_SHIFT) % PENDING_WAIT_SLOTS];
+}
+
+void ContentionProfiler::OnWaiting(LockKind kind, const void* lock, uint64_t beginTime)
+{
+    PendingWait& pending = GetPendingWait(lock);
+    const void* expected = nullptr;
+    // the earliest waiter keeps the slot, whose delay is the longest.
+    if (pending.lock.compare_exchange_strong(expected, lock, std::memory_order_acq_rel)) {
+        pending.kind.store(kind, std::memory_order_relaxed);
+        pending.beginTime.store(beginTime, std::memory_order_release);
+    }
+}
+
+ContentionProfiler::Sample* ContentionProfiler::CaptureWaiter(LockKind kind)
+{
+    if (!IsEnabled() || !ShouldSample()) {
+        return nullptr;
+    }
+    Sample* sample = new (std::nothrow) Sample{ { kind, false, {} }, 0, nullptr };
+    if (sample == nullptr) {
+        return nullptr;
+    }
+    if (IsCangjieLock(kind)) {
+        StackManager::RecordLiteFrameInfos(sample->key.frames, MAX_CONTENTION_FRAMES);
+    } else {
+        RecordNativeFrames(sample->key.frames);
+    }
+    return sample;
+}
+
+void ContentionProfiler::WaitEnd(LockKind kind, const void* lock, uint64_t beginTime, Sample* sample)
+{
+    uint64_t now = TimeUtil::NanoSeconds();
+    uint64_t delay = now > beginTime ? now - beginTime : 0;
+    size_t index = static_cast<size_t>(kind);
+    contentions[index].fetch_add(1, std::memory_order_relaxed);
+    delays[index].fetch_add(delay, std::memory_order_relaxed);
+    if (IsCangjieLock(kind)) {
+        PendingWait& pending = GetPendingWait(lock);
+        uint64_t expected = beginTime;
+        // the slot is released by the holder if it has been recorded.
+        if (pending.lock.load(std::memory_order_acquire) == lock &&
+            pending.beginTime.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+            pending.lock.store(nullptr, std::memory_order_release);
+        }
+    }
+    if (sample == nullptr) {
+        return;
+    }
+    // the lock is held now, queue the sample without blocking. It is recorded once a lock is released.
+    sample->delay = delay;
+    Sample* head = queuedSamples.load(std::memory_order_relaxed);
+    do {
+        sample->next = head;
+    } while (!queuedSamples.compare_exchange_weak(head, sample, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void ContentionProfiler::OnUnlock(const void* lock)
+{
+    PendingWait& pending = GetPendingWait(lock);
+    if (pending.lock.load(std::memory_order_acquire) == lock) {
+        LockKind kind = pending.kind.load(std::memory_order_relaxed);
+        uint64_t beginTime = pending.beginTime.exchange(0, std::memory_order_acq_rel);
+        // otherwise, the waiter is still registering itself, or has been recorded by another holder.
+        if (beginTime != 0) {
+            pending.lock.store(nullptr, std::memory_order_release);
+            uint64_t now = TimeUtil::NanoSeconds();
+            if (ShouldSample()) {
+                RecordSite(kind, true, now > beginTime ? now - beginTime : 0);
+            }
+        }
+    }
+    FlushSamples();
+}
+
+void ContentionProfiler::FlushSamples()
+{
+    if (queuedSamples.load(std::memory_order_relaxed) == nullptr) {
+        return;
+    }
+    std::lock_guard<std::mutex> lg(siteMutex);
+    RecordSamples(queuedSamples.exchange(nullptr, std::memory_order_acquire));
+}
+
+void ContentionProfiler::RecordSamples(Sample* samples)
+{
+    while (samples != nullptr) {
+        Sample* next = samples->next;
+        SiteStats& site = sites[std::move(samples->key)];
+        site.contentions += sampleRate;
+        site.delayNanos += samples->delay * sampleRate;
+        delete samples;
+        samples = next;
+    }
+}
+
+void ContentionProfiler::RecordSite(LockKind kind, bool isHolder, uint64_t delay)
+{
+    SiteKey key = { kind, isHolder, {} };
+    if (IsCangjieLock(kind)) {
+        StackManager::RecordLiteFrameInfos(key.frames, MAX_CONTENTION_FRAMES);
+    } else {
+        RecordNativeFrames(key.frames);
+    }
+    std::lock_guard<std::mutex> lg(siteMutex);
+    SiteStats& site = sites[std::move(key)];
+    site.contentions += sampleRate;
+    site.delayNanos += delay * sampleRate;
+}
+
+LockContentionStats ContentionProfiler::GetStats(LockKind kind) const
+{
+    size_t index = static_cast<size_t>(kind);
+    if (index >= static_cast<size_t>(LockKind::LOCK_KIND_NUM)) {
+        return { 0, 0 };
+    }
+    return { contentions[index].load(std::memory_order_relaxed), delays[index].load(std::memory_order_relaxed) };
+}
+
+void ContentionProfiler::SymbolizeSite(const SiteKey& key, std::vector<CString>& names, std::vector<CString>& files,
+                                       std::vector<int64_t>& lines)
+{
+    if (IsCangjieLock(key.kind)) {
+        std::vector<StackTraceElement> stackTrace;
+        StackManager::GetStackTraceByLiteFrameInfos(key.frames, stackTrace);
+        for (const auto& ste : stackTrace) {
+            names.push_back(ste.className.Length() > 0 ? ste.className + "." + ste.methodName : ste.methodName);
+            files.push_back(ste.fileName);
+            lines.push_back(ste.lineNumber);
+        }
+        return;
+    }
+    for (uint64_t pc : key.frames) {
+        Os::Loader::BinaryInfo binInfo;
+        (void)Os::Loader::GetBinaryInfoFromAddress(reinterpret_cast<void*>(pc), &binInfo);
+        CString name(binInfo.symbolName);
+        names.push_back(name.IsEmpty() ? CString::FormatString("0x%lx", pc) : name);
+        files.push_back(CString(binInfo.filePathName));
+        lines.push_back(0);
+    }
+}
+
+void ContentionProfiler::WriteProfile(ProfileWriter& writer)
+{
+    writer.Begin({ { "contentions", "count" }, { "delay", "nanoseconds" } }, 1, { "contentions", "count" },
+                 static_cast<int64_t>(sampleRate));
+    writer.SetDuration(TimeUtil::NanoSeconds() - startTime);
+    std::vector<uint64_t> frames;
+    std::vector<CString> names;
+    std::vector<CString> files;
+    std::vector<int64_t> lines;
+    for (const auto& it : sites) {
+        const SiteKey& key = it.first;
+        names.clear();
+        files.clear();
+        lines.clear();
+        SymbolizeSite(key, names, files, lines);
+        frames.clear();
+        // the lock kind is the leaf frame, and waiters and holders are told apart by the root frame.
+        frames.push_back(writer.InternFrame(GetLockKindName(key.kind), "", 0));
+        for (size_t i = 0; i < names.size(); ++i) {
+            frames.push_back(writer.InternFrame(names[i], files[i], lines[i]));
+        }
+        frames.push_back(writer.InternFrame(key.isHolder ? "(holder)" : "(waiter)", "", 0));
+        writer.AddSample(frames, { static_cast<int64_t>(it.second.contentions),
+                                   static_cast<int64_t>(it.second.delayNanos) });
+    }
+}
+
+bool ContentionProfiler::Dump(int fd, ProfileFormat format)
+{
+    std::lock_guard<std::mutex> lg(siteMutex);
+    RecordSamples(queuedSamples.exchange(nullptr, std::memory_order_acquire));
+    if (fd < 0 || sites.empty()) {
+        return false;
+    }
+    std::unique_ptr<ProfileWriter> writer = ProfileWriter::Create(format, fd);
+    if (writer != nullptr) {
+        WriteProfile(*writer);
+        return writer->Finish();
+    }
+
+    std::vector<std::pair<const SiteKey*, const SiteStats*>> sortedSites;
+    for (const auto& it : sites) {
+        sortedSites.emplace_back(&it.first, &it.second);
+    }
+    std::sort(sortedSites.begin(), sortedSites.end(),
+              [](const auto& a, const auto& b) { return a.second->delayNanos > b.second->delayNanos; });
+
+    CString report = CString::FormatString("lock contention: sample rate 1/%u, %zu sites in %lu ms\n", sampleRate,
+                                           sortedSites.size(), (TimeUtil::NanoSeconds() - startTime) / NS_PER_MS);
+    for (size_t i = 0; i < static_cast<size_t>(LockKind::LOCK_KIND_NUM); ++i) {
+        LockContentionStats stats = GetStats(static_cast<LockKind>(i));
+        report.Append(CString::FormatString("%s: %lu contentions, %lu us delay\n", LOCK_KIND_NAMES[i],
+                                            stats.contentions, stats.delayNanos / NS_PER_US));
+    }
+    std::vector<CString> names;
+    std::vector<CString> files;
+    std::vector<int64_t> lines;
+    for (const auto& it : sortedSites) {
+        const SiteKey& key = *it.first;
+        report.Append(CString::FormatString("%s %s: %lu contentions, %lu us delay\n", GetLockKindName(key.kind),
+                                            key.isHolder ? "holder" : "waiter", it.second->contentions,
+                                            it.second->delayNanos / NS_PER_US));
+        names.clear();
+        files.clear();
+        lines.clear();
+        SymbolizeSite(key, names, files, lines);
+        for (size_t i = 0; i < names.size(); ++i) {
+            report.Append(CString::FormatString("\tat %s(%s:%ld)\n", names[i].Str(), files[i].Str(), lines[i]));
+        }
+    }
+    if (write(fd, report.Str(), report.Length()) == -1) {
+        LOG(RTLOG_ERROR, "Write lock contention profile failed. msg: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+} // namespace MapleRuntime
@@ -0,0 +1,198 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_CONTENTION_PROFILER_H
+#define MRT_CONTENTION_PROFILER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <pthread.h>
+#include <vector>
+
+#include "Base/Macros.h"
+#include "Base/TimeUtils.h"
+#include "CpuProfiler/ProfileWriter.h"
+
+namespace MapleRuntime {
+enum class LockKind : uint8_t {
+    CJ_MUTEX = 0,
+    CJ_MONITOR,
+    CJ_MULTI_CONDITION_MONITOR,
+    GC_THREAD_POOL,
+    SCHEDULE_GLOBAL_QUEUE,
+    TYPE_INFO_BUCKET,
+    LOCK_KIND_NUM,
+};
+
+struct LockContentionStats {
+    uint64_t contentions;
+    uint64_t delayNanos;
+};
+
+// ContentionProfiler records where threads block on contended locks and for how long. Every contended acquisition is
+// counted per lock kind, and about one in (sampleRate) of them is recorded with the stack of the waiter. Sampled
+// values are scaled by the rate, so that sites are reported in proportion to their total delay.
+//
+// For cangjie mutexes and monitors, the thread which releases a mutex while a waiter is blocked on it is sampled as
+// well, with the delay of that waiter so far. So that the code holding a lock too long is found, not only the code
+// waiting for it. Only one waiter is tracked per mutex and waiters of different mutexes may share a slot, so holder
+// stacks are an approximation under heavy contention.
+//
+// The stack of a sampled waiter is captured before it blocks, and the sample is recorded into the sites only after a
+// lock is released, like go does at unlock. So that the profiler doesn't lengthen the critical sections it measures.
+//
+// Profiling can be enabled at startup with cjLockProfileRate, e.g., "1" to record every contention.
+class ContentionProfiler {
+public:
+    static constexpr size_t MAX_CONTENTION_FRAMES = 32;
+
+    // a sampled contention waiting to be recorded.
+    struct Sample;
+
+    static ContentionProfiler& Instance() noexcept;
+
+    static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    void InitFromEnv();
+    bool Start(uint32_t rate);
+    bool Stop();
+
+    // called before a thread blocks on a contended lock. Return the time when waiting begins, or 0 if not enabled.
+    static uint64_t WaitBegin() { return UNLIKELY(IsEnabled()) ? TimeUtil::NanoSeconds() : 0; }
+    // called before a thread blocks on a contended lock. Return the sample with the stack of the thread, or nullptr
+    // if the contention is not sampled.
+    Sample* CaptureWaiter(LockKind kind);
+    // called by a thread which is going to block on a cangjie mutex, so that its holder can be recorded.
+    void OnWaiting(LockKind kind, const void* lock, uint64_t beginTime);
+    // called after the thread acquires the lock with the time returned by WaitBegin and the captured sample, which
+    // is only queued here.
+    void WaitEnd(LockKind kind, const void* lock, uint64_t beginTime, Sample* sample);
+    // called by the thread which has released a cangjie mutex.
+    void OnUnlock(const void* lock);
+    // record queued samples, called after a lock is released.
+    void FlushSamples();
+
+    // acquire a runtime lock and record its contention, e.g., std::mutex or std::unique_lock.
+    template<typename Lockable>
+    static void Lock(Lockable& lockable, LockKind kind)
+    {
+        if (LIKELY(!IsEnabled())) {
+            lockable.lock();
+            return;
+        }
+        if (lockable.try_lock()) {
+            return;
+        }
+        Sample* sample = Instance().CaptureWaiter(kind);
+        uint64_t beginTime = TimeUtil::NanoSeconds();
+        lockable.lock();
+        Instance().WaitEnd(kind, &lockable, beginTime, sample);
+    }
+
+    static void Lock(pthread_mutex_t* mutex, LockKind kind)
+    {
+        if (LIKELY(!IsEnabled())) {
+            (void)pthread_mutex_lock(mutex);
+            return;
+        }
+        if (pthread_mutex_trylock(mutex) == 0) {
+            return;
+        }
+        Sample* sample = Instance().CaptureWaiter(kind);
+        uint64_t beginTime = TimeUtil::NanoSeconds();
+        (void)pthread_mutex_lock(mutex);
+        Instance().WaitEnd(kind, mutex, beginTime, sample);
+    }
+
+    // release a runtime lock acquired by Lock, and record the samples queued meanwhile.
+    template<typename Lockable>
+    static void Unlock(Lockable& lockable)
+    {
+        lockable.unlock();
+        if (UNLIKELY(IsEnabled())) {
+            Instance().FlushSamples();
+        }
+    }
+
+    static void Unlock(pthread_mutex_t* mutex)
+    {
+        (void)pthread_mutex_unlock(mutex);
+        if (UNLIKELY(IsEnabled())) {
+            Instance().FlushSamples();
+        }
+    }
+
+    // contentions and delay of all contended acquisitions since profiling started, which are not sampled.
+    LockContentionStats GetStats(LockKind kind) const;
+
+    // write contention sites ordered by delay, or as a pprof/collapsed profile. Return false if nothing is recorded.
+    bool Dump(int fd, ProfileFormat format);
+
+    static const char* GetLockKindName(LockKind kind);
+
+private:
+    struct SiteKey {
+        LockKind kind;
+        bool isHolder;
+        // lite frame triples of cangjie stacks, or native pcs of runtime locks.
+        std::vector<uint64_t> frames;
+        bool operator<(const SiteKey& other) const
+        {
+            if (kind != other.kind) {
+                return kind < other.kind;
+            }
+            if (isHolder != other.isHolder) {
+                return isHolder < other.isHolder;
+            }
+            return frames < other.frames;
+        }
+    };
+
+    struct SiteStats {
+        uint64_t contentions = 0;
+        uint64_t delayNanos = 0;
+    };
+
+    // a waiter which is still blocked on a cangjie mutex.
+    struct PendingWait {
+        std::atomic<const void*> lock = { nullptr };
+        std::atomic<uint64_t> beginTime = { 0 };
+        std::atomic<LockKind> kind = { LockKind::CJ_MUTEX };
+    };
+
+    static constexpr size_t PENDING_WAIT_SLOTS = 64;
+
+    ContentionProfiler() = default;
+    ~ContentionProfiler() = default;
+
+    static bool IsCangjieLock(LockKind kind) { return kind <= LockKind::CJ_MULTI_CONDITION_MONITOR; }
+    bool ShouldSample();
+    void RecordSite(LockKind kind, bool isHolder, uint64_t delay);
+    // caller holds siteMutex.
+    void RecordSamples(Sample* samples);
+    PendingWait& GetPendingWait(const void* lock);
+    void WriteProfile(ProfileWriter& writer);
+    void SymbolizeSite(const SiteKey& key, std::vector<CString>& names, std::vector<CString>& files,
+                       std::vector<int64_t>& lines);
+
+    static std::atomic<bool> enabled;
+    uint32_t sampleRate = 1;
+    uint64_t startTime = 0;
+    std::atomic<uint64_t> sampleCounter = { 0 };
+    std::atomic<uint64_t> contentions[static_cast<size_t>(LockKind::LOCK_KIND_NUM)] = {};
+    std::atomic<uint64_t> delays[static_cast<size_t>(LockKind::LOCK_KIND_NUM)] = {};
+    PendingWait pendingWaits[PENDING_WAIT_SLOTS];
+    // samples of acquired locks, pushed without blocking and recorded by FlushSamples.
+    std::atomic<Sample*> queuedSamples = { nullptr };
+
+    std::mutex siteMutex;
+    std::map<SiteKey, SiteStats> sites;
+};
+} // namespace MapleRuntime
+#endif // MRT_CONTENTION_PROFILER_H
@@ -7,6 +7,14 @@
 
 #include "CpuProfiler.h"
 #include "Mutator/MutatorManager.h"
+#ifdef CPU_PROFILER_SIGNAL_SAMPLING
+#include <cerrno>
+#include "Base/SysCall.h"
+#include "schedule.h"
+#include "Signal/SignalUtils.h"
+#include "SignalManager.h"
+#include "StackManager.h"
+#endif
 
 namespace MapleRuntime {
 CpuProfiler::~CpuProfiler()
@@ -30,14 +38,14 @@ bool CpuProfiler::StartCpuProfilerForFile()
     return true;
 }
 
-bool CpuProfiler::StopCpuProfilerForFile(const int fd)
+bool CpuProfiler::StopCpuProfilerForFile(const int fd, ProfileFormat format)
 {
     if (!generator.GetIsStart()) {
         LOG(RTLOG_ERROR, "CpuProfiler is not in profiling");
         return false;
     }
     // Sample data will be dump before sampling thread exit.
-    bool ret = generator.OpenFile(fd);
+    bool ret = generator.OpenFile(fd, format);
     if (!ret) {
         LOG(RTLOG_ERROR, "Open file failed");
     }
@@ -61,6 +69,11 @@ void CpuProfiler::SamplingThread(SamplesRecord& generator)
 {
     generator.InitProfileInfo();
     uint32_t interval = generator.GetSamplingInterval();
+#ifdef CPU_PROFILER_SIGNAL_SAMPLING
+    CpuProfiler& profiler = GetInstance();
+    // fall back to safepoint sampling if the timer is not available.
+    bool bySignal = profiler.StartSignalSampling(interval);
+#endif
     uint64_t startTime = SamplesRecord::GetMicrosecondsTimeStamp();
     generator.SetThreadStartTime(startTime);
     uint64_t endTime = startTime;
@@ -73,11 +86,25 @@ void CpuProfiler::SamplingThread(SamplesRecord& generator)
             usleep(ts);
             endTime = SamplesRecord::GetMicrosecondsTimeStamp();
         }
+#ifdef CPU_PROFILER_SIGNAL_SAMPLING
+        if (bySignal) {
+            profiler.DrainRawSamples();
+        } else {
+            DoSampleStack();
+        }
+#else
         DoSampleStack();
+#endif
         generator.ParseSampleData(endTime);
         // Save the sampling data to profileInfo.
-        generator.DoSingleTask(endTime);
+        while (generator.DoSingleTask(endTime)) {}
+    }
+#ifdef CPU_PROFILER_SIGNAL_SAMPLING
+    if (bySignal) {
+        profiler.StopSignalSampling();
+        profiler.DrainRawSamples();
     }
+#endif
     // Traverse the task queue until all sampling data is saved to profileInfo.
     generator.RunTaskLoop();
     generator.SetSampleStopTime(SamplesRecord::GetMicrosecondsTimeStamp());
@@ -89,4 +116,197 @@ void CpuProfiler::DoSampleStack()
 {
     MutatorManager::Instance().TransitionAllMutatorsToCpuProfile();
 }
-}
\ No newline at end of file
+
+#ifndef CPU_PROFILER_SIGNAL_SAMPLING
+void CpuProfiler::AttachThread() {}
+
+void CpuProfiler::DetachThread() {}
+#else
+// not every libc names the target thread field of sigevent.
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+void CpuProfiler::AttachThread()
+{
+    CpuProfiler& profiler = GetInstance();
+    pid_t tid = GetTid();
+    std::lock_guard<std::mutex> lock(profiler.profThreadsMutex);
+    ProfThread& profThread = profiler.profThreads[tid];
+    profThread.thread = pthread_self();
+    profThread.armed = false;
+    if (profiler.signalSampling.load(std::memory_order_relaxed)) {
+        (void)profiler.ArmThreadTimer(tid, profThread, CLOCK_THREAD_CPUTIME_ID);
+    }
+}
+
+void CpuProfiler::DetachThread()
+{
+    CpuProfiler& profiler = GetInstance();
+    std::lock_guard<std::mutex> lock(profiler.profThreadsMutex);
+    auto it = profiler.profThreads.find(GetTid());
+    if (it == profiler.profThreads.end()) {
+        return;
+    }
+    if (it->second.armed) {
+        (void)timer_delete(it->second.timer);
+    }
+    profiler.profThreads.erase(it);
+}
+
+// the timer ticks with cpu time consumed by the thread and signals the thread itself, so that overhead is
+// proportional to cpu usage rather than the number of threads, and every thread is sampled by its own usage.
+bool CpuProfiler::ArmThreadTimer(pid_t tid, ProfThread& profThread, clockid_t clock)
+{
+    struct sigevent sev;
+    (void)memset_s(&sev, sizeof(sev), 0, sizeof(sev));
+    sev.sigev_notify = SIGEV_THREAD_ID;
+    sev.sigev_signo = SIGPROF;
+    sev.sigev_value.sival_ptr = this;
+    sev.sigev_notify_thread_id = tid;
+    if (timer_create(clock, &sev, &profThread.timer) != 0) {
+        LOG(RTLOG_WARNING, "timer_create for cpu profiler failed, tid %d. msg: %s", tid, strerror(errno));
+        return false;
+    }
+    if (timer_settime(profThread.timer, 0, &profInterval, nullptr) != 0) {
+        LOG(RTLOG_WARNING, "timer_settime for cpu profiler failed, tid %d. msg: %s", tid, strerror(errno));
+        (void)timer_delete(profThread.timer);
+        return false;
+    }
+    profThread.armed = true;
+    return true;
+}
+
+bool CpuProfiler::StartSignalSampling(uint32_t intervalUs)
+{
+    if (rawSamples == nullptr) {
+        rawSamples = new (std::nothrow) RawSampleBuffer();
+        if (rawSamples == nullptr) {
+            return false;
+        }
+    }
+    if (!profHandlerInstalled) {
+        // the handler is kept after sampling stops, so that a pending SIGPROF doesn't terminate the process.
+        SignalAction sa;
+        CHECK_SIGNAL_CALL(sigemptyset, (&sa.scMask), "sigemptyset failed");
+        sa.saSignalAction = HandleProfSignal;
+        sa.scFlags = SA_SIGINFO | SA_ONSTACK;
+        SignalManager::AddHandlerToSignalStack(SIGPROF, &sa);
+        profHandlerInstalled = true;
+    }
+    constexpr uint64_t nsPerUs = 1000;
+    constexpr uint64_t nsPerS = 1000 * 1000 * 1000;
+    uint64_t intervalNs = static_cast<uint64_t>(intervalUs) * nsPerUs;
+    std::lock_guard<std::mutex> lock(profThreadsMutex);
+    profInterval.it_interval.tv_sec = static_cast<time_t>(intervalNs / nsPerS);
+    profInterval.it_interval.tv_nsec = static_cast<long>(intervalNs % nsPerS);
+    profInterval.it_value = profInterval.it_interval;
+    // threads attached from now on arm their own timers.
+    droppedSamples.store(0, std::memory_order_relaxed);
+    signalSampling.store(true, std::memory_order_release);
+    for (auto& entry : profThreads) {
+        // the timer is created by the sampling thread, so the cpu clock of the target thread is used explicitly.
+        clockid_t clock;
+        if (pthread_getcpuclockid(entry.second.thread, &clock) == 0 &&
+            ArmThreadTimer(entry.first, entry.second, clock)) {
+            continue;
+        }
+        // the timers are not available, disarm those already armed.
+        StopSignalSamplingLocked();
+        LOG(RTLOG_WARNING, "cpu profiler failed to arm thread timers, sample at safepoints.");
+        return false;
+    }
+    return true;
+}
+
+void CpuProfiler::StopSignalSampling()
+{
+    std::lock_guard<std::mutex> lock(profThreadsMutex);
+    StopSignalSamplingLocked();
+}
+
+void CpuProfiler::StopSignalSamplingLocked()
+{
+    signalSampling.store(false, std::memory_order_release);
+    for (auto& entry : profThreads) {
+        if (entry.second.armed) {
+            (void)timer_delete(entry.second.timer);
+            entry.second.armed = false;
+        }
+    }
+    uint64_t dropped = droppedSamples.load(std::memory_order_relaxed);
+    if (dropped != 0) {
+        LOG(RTLOG_WARNING, "cpu profiler dropped %lu samples since sample buffer is full.", dropped);
+    }
+}
+
+void CpuProfiler::DrainRawSamples()
+{
+    RawSample sample;
+    while (rawSamples->Pop(sample)) {
+        StackManager::PostRawSampleForCpuProfile(sample);
+    }
+}
+
+// Frame pointers are followed only within the stack of current cjthread, since the memory read in signal handler
+// must be valid. Threads not running a cjthread are sampled with the interrupted pc only.
+void CpuProfiler::RecordRawSample(RawSample& sample, uintptr_t pc, uintptr_t fa)
+{
+    Mutator* mutator = Mutator::GetMutator();
+    sample.timeStamp = SamplesRecord::GetMicrosecondsTimeStamp();
+    sample.cjThreadId = mutator == nullptr ? 0 : mutator->GetCJThreadId();
+    sample.pcs[0] = pc;
+    sample.startPCs[0] = 0;
+    sample.frameCount = 1;
+
+    uintptr_t stackLow = reinterpret_cast<uintptr_t>(CJThreadStackAddrGet());
+    uintptr_t stackHigh = reinterpret_cast<uintptr_t>(CJThreadStackBaseAddrGet());
+    auto isValidFA = [stackLow, stackHigh](uintptr_t addr) {
+        // the saved start pc is below fa, the caller fa and return address are above it.
+        return addr % sizeof(uintptr_t) == 0 && addr >= stackLow + sizeof(uintptr_t) &&
+            addr + 2 * sizeof(uintptr_t) <= stackHigh;
+    };
+    if (stackLow == 0 || !isValidFA(fa)) {
+        return;
+    }
+    sample.startPCs[0] = reinterpret_cast<uintptr_t>(
+        FrameInfo::GetFuncStartPCFromFrameAddress(reinterpret_cast<FrameAddress*>(fa)));
+    while (sample.frameCount < MAX_RAW_SAMPLE_FRAMES) {
+        uintptr_t callerFA = reinterpret_cast<uintptr_t*>(fa)[0];
+        uintptr_t returnAddress = reinterpret_cast<uintptr_t*>(fa)[1];
+        // stack grows downwards, a caller frame must be above its callee.
+        if (returnAddress == 0 || callerFA <= fa || !isValidFA(callerFA)) {
+            break;
+        }
+        fa = callerFA;
+        sample.pcs[sample.frameCount] = returnAddress;
+        sample.startPCs[sample.frameCount] = reinterpret_cast<uintptr_t>(
+            FrameInfo::GetFuncStartPCFromFrameAddress(reinterpret_cast<FrameAddress*>(fa)));
+        ++sample.frameCount;
+    }
+}
+
+bool CpuProfiler::HandleProfSignal(int sig, siginfo_t* info, void* context)
+{
+    (void)sig;
+    CpuProfiler& profiler = GetInstance();
+    // SIGPROF raised by others is left to their handlers.
+    if (info->si_code != SI_TIMER || info->si_value.sival_ptr != &profiler) {
+        return false;
+    }
+    if (!profiler.signalSampling.load(std::memory_order_acquire)) {
+        return true;
+    }
+    int savedErrno = errno;
+    const ucontext_t* ucontext = static_cast<const ucontext_t*>(context);
+    uintptr_t pc = GetPCFromUContext(*ucontext);
+    uintptr_t fa = GetFAFromUContext(*ucontext);
+    bool recorded = profiler.rawSamples->Push([pc, fa](RawSample& sample) { RecordRawSample(sample, pc, fa); });
+    if (!recorded) {
+        profiler.droppedSamples.fetch_add(1, std::memory_order_relaxed);
+    }
+    errno = savedErrno;
+    return true;
+}
+#endif
+}
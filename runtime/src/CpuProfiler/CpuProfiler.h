@@ -8,10 +8,23 @@
 #ifndef MRT_CPU_PROFILER_H
 #define MRT_CPU_PROFILER_H
 
+#include <csignal>
+#include <ctime>
+#include <map>
+#include <mutex>
 #include <thread>
+#include "RawSampleBuffer.h"
 #include "SamplesRecord.h"
 
+#if (defined(__linux__) || defined(__OHOS__) || defined(__ANDROID__)) && !defined(_WIN64)
+#define CPU_PROFILER_SIGNAL_SAMPLING 1
+#endif
+
 namespace MapleRuntime {
+// On linux, every attached thread gets its own cpu-time timer, whose SIGPROF is delivered to that thread, so that
+// running threads are sampled where they are, including native and runtime frames, and threads which don't run cost
+// nothing. Signal handler only records pcs found by walking frame pointers, and the sampling thread symbolizes them.
+// On other platforms, all mutators are sampled at safepoints on every tick.
 class CpuProfiler {
 public:
     static CpuProfiler& GetInstance()
@@ -20,15 +33,45 @@ public:
         return instance;
     }
     bool StartCpuProfilerForFile();
-    bool StopCpuProfilerForFile(const int fd);
+    bool StopCpuProfilerForFile(const int fd, ProfileFormat format);
     SamplesRecord& GetGenerator() { return generator; }
     void TryStopSampling();
+    // called by processor and foreign threads running cangjie code, on the thread itself.
+    static void AttachThread();
+    static void DetachThread();
 
 private:
     CpuProfiler() {}
     ~CpuProfiler();
     static void SamplingThread(SamplesRecord& generator);
     static void DoSampleStack();
+#ifdef CPU_PROFILER_SIGNAL_SAMPLING
+    bool StartSignalSampling(uint32_t intervalUs);
+    void StopSignalSampling();
+    // caller holds profThreadsMutex.
+    void StopSignalSamplingLocked();
+    void DrainRawSamples();
+    static bool HandleProfSignal(int sig, siginfo_t* info, void* context);
+    static void RecordRawSample(RawSample& sample, uintptr_t pc, uintptr_t fa);
+
+    struct ProfThread {
+        pthread_t thread;
+        timer_t timer;
+        bool armed;
+    };
+    // caller holds profThreadsMutex.
+    bool ArmThreadTimer(pid_t tid, ProfThread& profThread, clockid_t clock);
+
+    // allocated on first start and never freed, since a signal may still be handled after sampling stops.
+    RawSampleBuffer* rawSamples = nullptr;
+    std::atomic<bool> signalSampling = { false };
+    std::atomic<uint64_t> droppedSamples = { 0 };
+    bool profHandlerInstalled = false;
+    // attached threads by tid, and the interval their timers are armed with while signalSampling is set.
+    std::mutex profThreadsMutex;
+    std::map<pid_t, ProfThread> profThreads;
+    struct itimerspec profInterval;
+#endif
     SamplesRecord generator;
     std::thread tid;
 };
@@ -0,0 +1,379 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "CpuProfiler/ProfileWriter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#include "Base/Log.h"
+
+namespace MapleRuntime {
+namespace {
+constexpr uint64_t NS_PER_SEC = 1000 * 1000 * 1000;
+
+// wire types and field numbers of profile.proto.
+constexpr uint32_t WIRE_VARINT = 0;
+constexpr uint32_t WIRE_LENGTH_DELIMITED = 2;
+
+constexpr uint32_t PROFILE_SAMPLE_TYPE = 1;
+constexpr uint32_t PROFILE_SAMPLE = 2;
+constexpr uint32_t PROFILE_LOCATION = 4;
+constexpr uint32_t PROFILE_FUNCTION = 5;
+constexpr uint32_t PROFILE_STRING_TABLE = 6;
+constexpr uint32_t PROFILE_TIME_NANOS = 9;
+constexpr uint32_t PROFILE_DURATION_NANOS = 10;
+constexpr uint32_t PROFILE_PERIOD_TYPE = 11;
+constexpr uint32_t PROFILE_PERIOD = 12;
+constexpr uint32_t PROFILE_DEFAULT_SAMPLE_TYPE = 14;
+constexpr uint32_t VALUE_TYPE_TYPE = 1;
+constexpr uint32_t VALUE_TYPE_UNIT = 2;
+constexpr uint32_t SAMPLE_LOCATION_ID = 1;
+constexpr uint32_t SAMPLE_VALUE = 2;
+constexpr uint32_t LOCATION_ID = 1;
+constexpr uint32_t LOCATION_LINE = 4;
+constexpr uint32_t LINE_FUNCTION_ID = 1;
+constexpr uint32_t LINE_LINE = 2;
+constexpr uint32_t FUNCTION_ID = 1;
+constexpr uint32_t FUNCTION_NAME = 2;
+constexpr uint32_t FUNCTION_SYSTEM_NAME = 3;
+constexpr uint32_t FUNCTION_FILENAME = 4;
+
+void PutVarint(std::string& out, uint64_t value)
+{
+    constexpr uint64_t lowBits = 0x7F;
+    constexpr uint64_t moreFlag = 0x80;
+    constexpr uint32_t bitsPerByte = 7;
+    while (value > lowBits) {
+        out.push_back(static_cast<char>((value & lowBits) | moreFlag));
+        value >>= bitsPerByte;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void PutTag(std::string& out, uint32_t field, uint32_t wireType)
+{
+    constexpr uint32_t wireTypeBits = 3;
+    PutVarint(out, (static_cast<uint64_t>(field) << wireTypeBits) | wireType);
+}
+
+// zero is the default value of proto3 and is omitted.
+void PutUint(std::string& out, uint32_t field, uint64_t value)
+{
+    if (value != 0) {
+        PutTag(out, field, WIRE_VARINT);
+        PutVarint(out, value);
+    }
+}
+
+void PutBytes(std::string& out, uint32_t field, const char* data, size_t len)
+{
+    PutTag(out, field, WIRE_LENGTH_DELIMITED);
+    PutVarint(out, len);
+    out.append(data, len);
+}
+
+void PutMessage(std::string& out, uint32_t field, const std::string& message)
+{
+    PutBytes(out, field, message.data(), message.size());
+}
+
+// pprof profile.proto without compression, which is accepted by pprof as well as the gzipped one.
+class PprofWriter : public ProfileWriter {
+public:
+    explicit PprofWriter(int fd) : ProfileWriter(fd) {}
+    ~PprofWriter() override = default;
+
+protected:
+    void WriteHeader() override
+    {
+        // string_table[0] must be the empty string.
+        (void)InternString("");
+        for (const ProfileValueType& valueType : sampleTypes) {
+            PutMessage(record, PROFILE_SAMPLE_TYPE, EncodeValueType(valueType));
+        }
+        EmitRecord();
+    }
+
+    void WriteFrame(uint64_t id, const CString& functionName, const CString& fileName, int64_t line) override
+    {
+        uint64_t functionId = InternFunction(functionName, fileName);
+        std::string lineMessage;
+        PutUint(lineMessage, LINE_FUNCTION_ID, functionId);
+        PutUint(lineMessage, LINE_LINE, static_cast<uint64_t>(line));
+        std::string location;
+        PutUint(location, LOCATION_ID, id);
+        PutMessage(location, LOCATION_LINE, lineMessage);
+        PutMessage(record, PROFILE_LOCATION, location);
+        EmitRecord();
+    }
+
+    void WriteSample(const std::vector<uint64_t>& frames, const std::vector<int64_t>& values) override
+    {
+        std::string packed;
+        std::string sample;
+        for (uint64_t frame : frames) {
+            PutVarint(packed, frame);
+        }
+        PutMessage(sample, SAMPLE_LOCATION_ID, packed);
+        packed.clear();
+        for (int64_t value : values) {
+            PutVarint(packed, static_cast<uint64_t>(value));
+        }
+        PutMessage(sample, SAMPLE_VALUE, packed);
+        PutMessage(record, PROFILE_SAMPLE, sample);
+        EmitRecord();
+    }
+
+    void WriteTrailer() override
+    {
+        std::string periodTypeMessage = EncodeValueType(periodType);
+        uint64_t defaultType = defaultSampleType < sampleTypes.size() ?
+            InternString(sampleTypes[defaultSampleType].type) : 0;
+        PutUint(record, PROFILE_TIME_NANOS, timeNanos);
+        PutUint(record, PROFILE_DURATION_NANOS, duration);
+        PutMessage(record, PROFILE_PERIOD_TYPE, periodTypeMessage);
+        PutUint(record, PROFILE_PERIOD, static_cast<uint64_t>(period));
+        PutUint(record, PROFILE_DEFAULT_SAMPLE_TYPE, defaultType);
+        EmitRecord();
+    }
+
+private:
+    // a new string is appended to the string table right away, so it must be interned before the record which
+    // refers to it is written.
+    uint64_t InternString(const CString& str)
+    {
+        auto it = strings.find(str);
+        if (it != strings.end()) {
+            return it->second;
+        }
+        uint64_t index = strings.size();
+        strings.emplace(str, index);
+        std::string entry;
+        PutBytes(entry, PROFILE_STRING_TABLE, str.Str(), str.Length());
+        Emit(entry);
+        return index;
+    }
+
+    uint64_t InternFunction(const CString& functionName, const CString& fileName)
+    {
+        auto key = std::make_pair(functionName, fileName);
+        auto it = functions.find(key);
+        if (it != functions.end()) {
+            return it->second;
+        }
+        uint64_t id = functions.size() + 1;
+        functions.emplace(key, id);
+        uint64_t name = InternString(functionName);
+        uint64_t file = InternString(fileName);
+        std::string function;
+        PutUint(function, FUNCTION_ID, id);
+        PutUint(function, FUNCTION_NAME, name);
+        PutUint(function, FUNCTION_SYSTEM_NAME, name);
+        PutUint(function, FUNCTION_FILENAME, file);
+        PutMessage(record, PROFILE_FUNCTION, function);
+        EmitRecord();
+        return id;
+    }
+
+    std::string EncodeValueType(const ProfileValueType& valueType)
+    {
+        uint64_t type = InternString(valueType.type);
+        uint64_t unit = InternString(valueType.unit);
+        std::string message;
+        PutUint(message, VALUE_TYPE_TYPE, type);
+        PutUint(message, VALUE_TYPE_UNIT, unit);
+        return message;
+    }
+
+    void EmitRecord()
+    {
+        Emit(record);
+        record.clear();
+    }
+
+    std::string record;
+    std::map<CString, uint64_t> strings;
+    std::map<std::pair<CString, CString>, uint64_t> functions;
+};
+
+// Brendan Gregg's collapsed stack format. Frames are named by function only, so stacks which differ in lines
+// only are merged again.
+class CollapsedStackWriter : public ProfileWriter {
+public:
+    explicit CollapsedStackWriter(int fd) : ProfileWriter(fd) {}
+    ~CollapsedStackWriter() override = default;
+
+protected:
+    void WriteHeader() override {}
+
+    void WriteFrame(uint64_t id, const CString& functionName, const CString&, int64_t) override
+    {
+        // ';' separates frames and the last ' ' separates the value.
+        std::string name(functionName.Str(), functionName.Length());
+        std::replace(name.begin(), name.end(), ';', ':');
+        std::replace(name.begin(), name.end(), '\n', ' ');
+        if (frameNames.size() < id) {
+            frameNames.resize(id);
+        }
+        frameNames[id - 1] = name.empty() ? "(unknown)" : name;
+    }
+
+    void WriteSample(const std::vector<uint64_t>& frames, const std::vector<int64_t>& values) override
+    {
+        if (defaultSampleType >= values.size()) {
+            return;
+        }
+        std::string stack;
+        for (auto it = frames.rbegin(); it != frames.rend(); ++it) {
+            if (!stack.empty()) {
+                stack.push_back(';');
+            }
+            stack.append(*it == 0 || *it > frameNames.size() ? "(unknown)" : frameNames[*it - 1]);
+        }
+        stacks[stack] += values[defaultSampleType];
+    }
+
+    void WriteTrailer() override
+    {
+        for (const auto& it : stacks) {
+            if (it.second == 0) {
+                continue;
+            }
+            Emit(it.first);
+            Emit(" " + std::to_string(it.second) + "\n");
+        }
+    }
+
+private:
+    std::vector<std::string> frameNames;
+    std::map<std::string, int64_t> stacks;
+};
+} // namespace
+
+ProfileFormat ProfileWriter::FormatFromEnv()
+{
+    auto env = std::getenv("cjProfileFormat");
+    if (env == nullptr) {
+        return ProfileFormat::NATIVE;
+    }
+    CString format(env);
+    if (format == "pprof") {
+        return ProfileFormat::PPROF;
+    }
+    if (format == "collapsed") {
+        return ProfileFormat::COLLAPSED;
+    }
+    if (format != "native" && format != "") {
+        LOG(RTLOG_ERROR, "Unsupported cjProfileFormat parameter. It should be pprof, collapsed or native.\n");
+    }
+    return ProfileFormat::NATIVE;
+}
+
+bool ProfileWriter::IsValidFormat(int format)
+{
+    return format >= static_cast<int>(ProfileFormat::NATIVE) && format <= static_cast<int>(ProfileFormat::COLLAPSED);
+}
+
+std::unique_ptr<ProfileWriter> ProfileWriter::Create(ProfileFormat format, int fd)
+{
+    switch (format) {
+        case ProfileFormat::PPROF:
+            return std::unique_ptr<ProfileWriter>(new PprofWriter(fd));
+        case ProfileFormat::COLLAPSED:
+            return std::unique_ptr<ProfileWriter>(new CollapsedStackWriter(fd));
+        default:
+            return nullptr;
+    }
+}
+
+void ProfileWriter::Begin(const std::vector<ProfileValueType>& types, size_t defaultType,
+                          const ProfileValueType& periodValueType, int64_t samplePeriod)
+{
+    sampleTypes = types;
+    defaultSampleType = defaultType;
+    periodType = periodValueType;
+    period = samplePeriod;
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    timeNanos = static_cast<uint64_t>(now.tv_sec) * NS_PER_SEC + static_cast<uint64_t>(now.tv_nsec);
+    buffer.reserve(BUFFER_SIZE);
+    WriteHeader();
+}
+
+uint64_t ProfileWriter::InternFrame(const CString& functionName, const CString& fileName, int64_t line)
+{
+    FrameKey key = { functionName, fileName, line };
+    auto it = frameIds.find(key);
+    if (it != frameIds.end()) {
+        return it->second;
+    }
+    // 0 is not a valid location id of pprof.
+    uint64_t id = frameIds.size() + 1;
+    frameIds.emplace(std::move(key), id);
+    WriteFrame(id, functionName, fileName, line);
+    return id;
+}
+
+void ProfileWriter::AddSample(const std::vector<uint64_t>& frames, const std::vector<int64_t>& values)
+{
+    std::vector<int64_t>& merged = samples[frames];
+    if (merged.size() < values.size()) {
+        merged.resize(values.size(), 0);
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        merged[i] += values[i];
+    }
+}
+
+bool ProfileWriter::Finish()
+{
+    for (auto& it : samples) {
+        it.second.resize(sampleTypes.size(), 0);
+        WriteSample(it.first, it.second);
+    }
+    samples.clear();
+    WriteTrailer();
+    Flush();
+    return !failed;
+}
+
+void ProfileWriter::Emit(const char* data, size_t len)
+{
+    if (buffer.size() + len > BUFFER_SIZE) {
+        Flush();
+    }
+    if (len > BUFFER_SIZE) {
+        buffer.assign(data, len);
+        Flush();
+        return;
+    }
+    buffer.append(data, len);
+}
+
+void ProfileWriter::Flush()
+{
+    size_t written = 0;
+    while (!failed && written < buffer.size()) {
+        ssize_t ret = write(fileDesc, buffer.data() + written, buffer.size() - written);
+        if (ret < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ret <= 0) {
+            LOG(RTLOG_ERROR, "Write profile failed. msg: %s", strerror(errno));
+            failed = true;
+            break;
+        }
+        written += static_cast<size_t>(ret);
+    }
+    buffer.clear();
+}
+} // namespace MapleRuntime
@@ -0,0 +1,100 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_PROFILE_WRITER_H
+#define MRT_PROFILE_WRITER_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Base/CString.h"
+
+namespace MapleRuntime {
+enum class ProfileFormat : int {
+    NATIVE = 0,    // the format a profiler writes by itself, e.g., .cpuprofile json of cpu profiler.
+    PPROF = 1,     // profile.proto of pprof.
+    COLLAPSED = 2, // one "root;...;leaf value" line per stack, which is the input of flamegraph tools.
+};
+
+struct ProfileValueType {
+    const char* type;
+    const char* unit;
+};
+
+// ProfileWriter streams stack samples of any profiler to a file descriptor. Frames are interned into ids before they
+// are referenced by samples, and samples of the same stack are merged. String, function and location tables are
+// written incrementally as new entries are interned, so that the whole profile is never built in memory.
+//
+// Usage: Begin, then InternFrame and AddSample in any order, then Finish.
+class ProfileWriter {
+public:
+    // the format used when a profiler is dumped without a format, which is set by cjProfileFormat, i.e., "pprof" or
+    // "collapsed". It is NATIVE if not set.
+    static ProfileFormat FormatFromEnv();
+    static bool IsValidFormat(int format);
+    // return nullptr for NATIVE format.
+    static std::unique_ptr<ProfileWriter> Create(ProfileFormat format, int fd);
+
+    virtual ~ProfileWriter() = default;
+
+    // values of a sample are in order of sampleTypes. Collapsed stacks carry the value of defaultType only.
+    void Begin(const std::vector<ProfileValueType>& sampleTypes, size_t defaultType, const ProfileValueType& periodType,
+               int64_t period);
+    // return the id of the frame, which is the same for the same function, file and line.
+    uint64_t InternFrame(const CString& functionName, const CString& fileName, int64_t line);
+    // frames are leaf first.
+    void AddSample(const std::vector<uint64_t>& frames, const std::vector<int64_t>& values);
+    void SetDuration(uint64_t durationNanos) { duration = durationNanos; }
+    // write merged samples and flush, return false if anything failed to be written.
+    bool Finish();
+
+protected:
+    explicit ProfileWriter(int fd) : fileDesc(fd) {}
+
+    virtual void WriteHeader() = 0;
+    virtual void WriteFrame(uint64_t id, const CString& functionName, const CString& fileName, int64_t line) = 0;
+    virtual void WriteSample(const std::vector<uint64_t>& frames, const std::vector<int64_t>& values) = 0;
+    virtual void WriteTrailer() = 0;
+
+    void Emit(const char* data, size_t len);
+    void Emit(const std::string& data) { Emit(data.data(), data.size()); }
+    void Flush();
+
+    std::vector<ProfileValueType> sampleTypes;
+    size_t defaultSampleType = 0;
+    ProfileValueType periodType = { "", "" };
+    int64_t period = 0;
+    // wall clock time when the profile begins.
+    uint64_t timeNanos = 0;
+    uint64_t duration = 0;
+
+private:
+    struct FrameKey {
+        CString functionName;
+        CString fileName;
+        int64_t line;
+        bool operator<(const FrameKey& other) const
+        {
+            return functionName < other.functionName ||
+                (functionName == other.functionName &&
+                 (fileName < other.fileName || (fileName == other.fileName && line < other.line)));
+        }
+    };
+
+    static constexpr size_t BUFFER_SIZE = 64 * 1024;
+
+    int fileDesc;
+    bool failed = false;
+    std::string buffer;
+    std::map<FrameKey, uint64_t> frameIds;
+    std::map<std::vector<uint64_t>, std::vector<int64_t>> samples;
+};
+} // namespace MapleRuntime
+#endif // MRT_PROFILE_WRITER_H
@@ -0,0 +1,91 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_RAW_SAMPLE_BUFFER_H
+#define MRT_RAW_SAMPLE_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace MapleRuntime {
+constexpr uint32_t MAX_RAW_SAMPLE_FRAMES = 64;
+
+// A stack sampled in signal handler, which is symbolized later by the sampling thread.
+struct RawSample {
+    uint64_t timeStamp;
+    uint64_t cjThreadId;
+    uint32_t frameCount;
+    // pcs[0] is the interrupted pc, the others are return addresses found by walking frame pointers.
+    uintptr_t pcs[MAX_RAW_SAMPLE_FRAMES];
+    // start pc saved below the frame address by managed functions, only valid for managed frames.
+    uintptr_t startPCs[MAX_RAW_SAMPLE_FRAMES];
+};
+
+// Bounded multi-producer single-consumer queue of raw samples. Push is lock-free and async-signal-safe: a producer
+// claims a slot by CAS, fills it in place and publishes it by the sequence number of the slot.
+class RawSampleBuffer {
+public:
+    static constexpr size_t CAPACITY = 1024; // must be a power of two.
+
+    RawSampleBuffer()
+    {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // return false if the buffer is full.
+    template<typename Filler>
+    bool Push(Filler&& fill)
+    {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        while (true) {
+            slot = &slots[pos & (CAPACITY - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        fill(slot->sample);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // called by the sampling thread only. return false if no published sample.
+    bool Pop(RawSample& sample)
+    {
+        Slot& slot = slots[dequeuePos & (CAPACITY - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+        sample = slot.sample;
+        slot.sequence.store(dequeuePos + CAPACITY, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence;
+        RawSample sample;
+    };
+
+    Slot slots[CAPACITY];
+    std::atomic<size_t> enqueuePos = { 0 };
+    size_t dequeuePos = 0;
+};
+} // namespace MapleRuntime
+#endif // MRT_RAW_SAMPLE_BUFFER_H
@@ -8,6 +8,7 @@
 #include "SamplesRecord.h"
 #include <algorithm>
 #include "ObjectModel/MFuncdesc.inline.h"
+#include "os/Loader.h"
 #include "UnwindStack/MangleNameHelper.h"
 #include "Base/TimeUtils.h"
 
@@ -320,11 +321,65 @@ void SamplesRecord::StringifySamples(ProfileInfo* info)
 
 void SamplesRecord::DumpProfileInfo()
 {
+    std::unique_ptr<ProfileWriter> writer = ProfileWriter::Create(profileFormat, fileDesc);
+    if (writer != nullptr) {
+        if (!WriteProfile(profileInfo, *writer)) {
+            LOG(RTLOG_ERROR, "Write cpu profile failed.");
+        }
+        return;
+    }
     StringifySampleData(profileInfo);
     WriteFile();
 }
 
-bool SamplesRecord::OpenFile(int fd)
+bool SamplesRecord::WriteProfile(ProfileInfo* info, ProfileWriter& writer)
+{
+    writer.Begin({ { "samples", "count" }, { "cpu", "nanoseconds" } }, 1, { "cpu", "nanoseconds" },
+                 static_cast<int64_t>(interval) * TIME_NSEC_PER_USEC);
+    if (info->stopTime > info->startTime) {
+        writer.SetDuration((info->stopTime - info->startTime) * TIME_NSEC_PER_USEC);
+    }
+    size_t nodeCount = static_cast<size_t>(info->nodeCount);
+    // node ids start from 1, so that index 0 is unused.
+    std::vector<int64_t> hits(nodeCount + 1, 0);
+    std::vector<int64_t> times(nodeCount + 1, 0);
+    for (size_t i = 0; i < info->samples.size() && i < info->timeDeltas.size(); i++) {
+        size_t nodeId = static_cast<size_t>(info->samples[i]);
+        if (nodeId == UNKNOWN_NODE_ID || nodeId > nodeCount) {
+            continue;
+        }
+        hits[nodeId]++;
+        times[nodeId] += static_cast<int64_t>(info->timeDeltas[i]) * TIME_NSEC_PER_USEC;
+    }
+
+    std::vector<uint64_t> nodeFrames(nodeCount + 1, 0);
+    auto internNode = [&info, &writer, &nodeFrames](size_t nodeId) {
+        if (nodeFrames[nodeId] == 0) {
+            const CodeInfo& codeEntry = info->nodes[nodeId - 1].codeEntry;
+            nodeFrames[nodeId] = writer.InternFrame(codeEntry.functionName, codeEntry.url, codeEntry.lineNumber);
+        }
+        return nodeFrames[nodeId];
+    };
+    std::vector<uint64_t> frames;
+    for (size_t nodeId = ROOT_NODE_ID; nodeId <= nodeCount; nodeId++) {
+        if (hits[nodeId] == 0) {
+            continue;
+        }
+        frames.clear();
+        // (root) is omitted unless the sample hits the root itself.
+        for (size_t id = nodeId; id > ROOT_NODE_ID && id <= nodeCount && frames.size() <= nodeCount;
+             id = static_cast<size_t>(info->nodes[id - 1].parentId)) {
+            frames.push_back(internNode(id));
+        }
+        if (frames.empty()) {
+            frames.push_back(internNode(ROOT_NODE_ID));
+        }
+        writer.AddSample(frames, { hits[nodeId], times[nodeId] });
+    }
+    return writer.Finish();
+}
+
+bool SamplesRecord::OpenFile(int fd, ProfileFormat format)
 {
     if (fd == -1) {
         return false;
@@ -334,6 +389,7 @@ bool SamplesRecord::OpenFile(int fd)
         return false;
     }
     fileDesc = fd;
+    profileFormat = format;
     return true;
 }
 
@@ -358,17 +414,17 @@ void SamplesRecord::RunTaskLoop()
     }
 }
 
-void SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
+bool SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
 {
     if (IsTimeout(previousTimeStemp)) {
-        return;
+        return false;
     }
     if (taskQueue.empty()) {
-        return;
+        return false;
     }
     auto task = taskQueue.front();
     if (!task.finishParsed) {
-        return;
+        return false;
     }
     taskQueue.pop_front();
     if (task.frameCnt == 0) {
@@ -376,6 +432,7 @@ void SamplesRecord::DoSingleTask(uint64_t previousTimeStemp)
     } else {
         AddSample(task);
     }
+    return true;
 }
 
 void SamplesRecord::ParseSampleData(uint64_t previousTimeStemp)
@@ -389,8 +446,8 @@ void SamplesRecord::ParseSampleData(uint64_t previousTimeStemp)
         }
         const int frameCnt = static_cast<int>(task.frameCnt);
         for (int i = task.checkPoint; i < frameCnt; ++i) {
-            GetDemangleName(task.funcDescRefs[i]);
-            GetUrl(task.funcDescRefs[i]);
+            GetDemangleName(task.funcDescRefs[i], task.frameTypes[i]);
+            GetUrl(task.funcDescRefs[i], task.frameTypes[i]);
             // Avoid taking too long time to parse symbol.
             if (IsTimeout(previousTimeStemp)) {
                 task.checkPoint = i + 1;
@@ -415,7 +472,12 @@ bool SamplesRecord::IsTimeout(uint64_t previousTimeStemp)
 void SamplesRecord::Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
                          std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers)
 {
-    uint64_t timeStamp = SamplesRecord::GetMicrosecondsTimeStamp();
+    Post(mutatorId, FuncDescRefs, FrameTypes, LineNumbers, SamplesRecord::GetMicrosecondsTimeStamp());
+}
+
+void SamplesRecord::Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
+                         std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers, uint64_t timeStamp)
+{
     SampleTask task(timeStamp, mutatorId, FuncDescRefs, FrameTypes, LineNumbers);
     taskQueue.push_back(task);
 }
@@ -428,24 +490,32 @@ std::vector<CodeInfo> SamplesRecord::GetCodeInfos(SampleTask& task)
         codeInfo.lineNumber = task.lineNumbers[i];
         codeInfo.frameType = task.frameTypes[i];
         codeInfo.funcIdentifier = task.funcDescRefs[i];
-        codeInfo.functionName = GetDemangleName(codeInfo.funcIdentifier);
-        codeInfo.url = GetUrl(codeInfo.funcIdentifier);
+        codeInfo.functionName = GetDemangleName(codeInfo.funcIdentifier, codeInfo.frameType);
+        codeInfo.url = GetUrl(codeInfo.funcIdentifier, codeInfo.frameType);
         codeInfo.scriptId = UpdateScriptIdMap(codeInfo.url);
         codeInfos.emplace_back(codeInfo);
     }
     return codeInfos;
 }
 
-CString SamplesRecord::GetUrl(uint64_t funcIdentifier)
+CString SamplesRecord::GetUrl(uint64_t funcIdentifier, FrameType frameType)
 {
     if (identifierUrlMap.find(funcIdentifier) != identifierUrlMap.end()) {
         return identifierUrlMap[funcIdentifier];
     }
-    return ParseUrl(funcIdentifier);
+    return ParseUrl(funcIdentifier, frameType);
 }
 
-CString SamplesRecord::ParseUrl(uint64_t funcIdentifier)
+CString SamplesRecord::ParseUrl(uint64_t funcIdentifier, FrameType frameType)
 {
+    // only frames classified by the signal sampler are named by address, the others have a funcdesc.
+    if (frameType == FrameType::RUNTIME || frameType == FrameType::NATIVE) {
+        Os::Loader::BinaryInfo binInfo;
+        (void)Os::Loader::GetBinaryInfoFromAddress(reinterpret_cast<void*>(funcIdentifier), &binInfo);
+        CString url = CString(binInfo.filePathName);
+        identifierUrlMap.emplace(funcIdentifier, url);
+        return url;
+    }
     FuncDescRef funcDescRef = reinterpret_cast<FuncDescRef>(funcIdentifier);
     CString path = funcDescRef->GetFuncDir();
     CString fileName = funcDescRef->GetFuncFilename();
@@ -459,16 +529,27 @@ CString SamplesRecord::ParseUrl(uint64_t funcIdentifier)
     return fileName;
 }
 
-CString SamplesRecord::GetDemangleName(uint64_t funcIdentifier)
+CString SamplesRecord::GetDemangleName(uint64_t funcIdentifier, FrameType frameType)
 {
     if (identifierFuncnameMap.find(funcIdentifier) != identifierFuncnameMap.end()) {
         return identifierFuncnameMap[funcIdentifier];
     }
-    return ParseDemangleName(funcIdentifier);
+    return ParseDemangleName(funcIdentifier, frameType);
 }
 
-CString SamplesRecord::ParseDemangleName(uint64_t funcIdentifier)
+CString SamplesRecord::ParseDemangleName(uint64_t funcIdentifier, FrameType frameType)
 {
+    // only frames classified by the signal sampler are named by address, the others have a funcdesc.
+    if (frameType == FrameType::RUNTIME || frameType == FrameType::NATIVE) {
+        Os::Loader::BinaryInfo binInfo;
+        (void)Os::Loader::GetBinaryInfoFromAddress(reinterpret_cast<void*>(funcIdentifier), &binInfo);
+        CString funcName = CString(binInfo.symbolName);
+        if (funcName.IsEmpty()) {
+            funcName = CString::FormatString("(%s)", frameType == FrameType::RUNTIME ? "runtime" : "native");
+        }
+        identifierFuncnameMap.emplace(funcIdentifier, funcName);
+        return funcName;
+    }
     FuncDescRef funcDescRef = reinterpret_cast<FuncDescRef>(funcIdentifier);
     MangleNameHelper mangleNameHelper(funcDescRef->GetFuncName(),
         StackTraceFormatFlag(funcDescRef->GetStackTraceFormat()));
@@ -14,6 +14,7 @@
 #include <atomic>
 #include <list>
 #include "Common/StackType.h"
+#include "CpuProfiler/ProfileWriter.h"
 
 namespace MapleRuntime {
 constexpr int MAX_NODE_COUNT = 20000;   // 20000:the maximum size of the array
@@ -105,13 +106,16 @@ public:
     void StringifySampleData(ProfileInfo* info);
     void DumpProfileInfo();
     void RunTaskLoop();
-    void DoSingleTask(uint64_t previousTimeStemp);
+    // return true if a task is saved and there is time left for the next one.
+    bool DoSingleTask(uint64_t previousTimeStemp);
     void ParseSampleData(uint64_t previousTimeStemp);
     void Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
             std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers);
+    void Post(uint64_t mutatorId, std::vector<uint64_t>& FuncDescRefs,
+            std::vector<FrameType>& FrameTypes, std::vector<uint32_t>& LineNumbers, uint64_t timeStamp);
     std::vector<CodeInfo> BuildCodeInfos(SampleTask* task);
     int GetSamplingInterval() { return interval; }
-    bool OpenFile(int fd);
+    bool OpenFile(int fd, ProfileFormat format);
     static uint64_t GetMicrosecondsTimeStamp();
 
 private:
@@ -132,15 +136,19 @@ private:
     void AddTimeDelta(ProfileInfo* info, int timeDelta);
     void SetPreviousTimeStamp(ProfileInfo* info, uint64_t timeStamp);
     std::vector<CodeInfo> GetCodeInfos(SampleTask& task);
-    CString GetUrl(uint64_t funcIdentifier);
-    CString ParseUrl(uint64_t funcIdentifier);
-    CString GetDemangleName(uint64_t funcIdentifier);
-    CString ParseDemangleName(uint64_t funcIdentifier);
+    // funcIdentifier is a FuncDescRef for managed frames, or the symbol address for native and runtime frames.
+    CString GetUrl(uint64_t funcIdentifier, FrameType frameType);
+    CString ParseUrl(uint64_t funcIdentifier, FrameType frameType);
+    CString GetDemangleName(uint64_t funcIdentifier, FrameType frameType);
+    CString ParseDemangleName(uint64_t funcIdentifier, FrameType frameType);
     void WriteFile();
+    // write the caller tree as samples of leaf nodes, valued by hits and time.
+    bool WriteProfile(ProfileInfo* info, ProfileWriter& writer);
     bool IsTimeout(uint64_t previousTimeStemp);
     ProfileInfo* GetProfileInfo(uint64_t mutatorId);
 
     int fileDesc{-1};
+    ProfileFormat profileFormat {ProfileFormat::NATIVE};
     uint32_t timeDeltaThreshold {2000}; // 2000 : default timeDeltaThreshold 2000us
     std::atomic_bool isStart {false};
     CString sampleData {""};
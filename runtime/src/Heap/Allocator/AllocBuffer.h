@@ -12,6 +12,7 @@
 
 #include "Common/MarkWorkStack.h"
 #include "RegionList.h"
+#include "SlotList.h"
 
 namespace MapleRuntime {
 // thread-local data structure
@@ -28,12 +29,17 @@ public:
     MAddress Allocate(size_t size, AllocType allocType);
     RegionInfo* GetRegion() { return tlRegion; }
     RegionInfo* GetPreparedRegion() { return preparedRegion.load(std::memory_order_relaxed); }
-    void SetRegion(RegionInfo* newRegion) { tlRegion = newRegion; }
+    void SetRegion(RegionInfo* newRegion)
+    {
+        AccountRegionBytes(tlRegion);
+        tlRegion = newRegion;
+    }
     inline void ClearRegion()
     {
         if (tlRegion == RegionInfo::NullRegion()) {
             return;
         }
+        AccountRegionBytes(tlRegion);
         DLOG(REGION, "alloc buffer clear tlRegion %p@[0x%zx, 0x%zx)", tlRegion, tlRegion->GetRegionStart(),
              tlRegion->GetRegionEnd());
         tlRegion = RegionInfo::NullRegion();
@@ -64,7 +70,33 @@ public:
 
     void FlushRegion();
 
+    FreePinnedSlotLists& GetFreePinnedSlots() { return tlFreePinnedSlots; }
+
+    void ClearFreePinnedSlots() { tlFreePinnedSlots.Clear(); }
+
+    // sample an allocation of (size) bytes at (addr) which has taken the slow path, see AllocSampler.
+    void OnSlowPathAllocated(MAddress addr, size_t size);
+    // count down the bytes to next sample by the bytes allocated since the previous slow path, including (size) bytes
+    // just allocated. Return the bytes allocated since the previous sample if a sample is due, otherwise 0.
+    size_t TakeSampleWeight(size_t size, uint32_t session);
+
+    // objects not allocated in tlRegion, e.g., large and pinned objects, are accounted on allocation.
+    void AccountAllocatedBytes(size_t size) { retiredBytes += size; }
+    // bytes allocated by this thread so far. Only the owner thread reads it, because tlRegion is not synchronized.
+    size_t GetAllocatedBytes() const
+    {
+        return tlRegion == RegionInfo::NullRegion() ? retiredBytes : retiredBytes + tlRegion->GetRegionAllocatedSize();
+    }
+
 private:
+    // called before tlRegion is retired or replaced, so that allocated bytes are monotonic.
+    void AccountRegionBytes(RegionInfo* region)
+    {
+        if (region != RegionInfo::NullRegion() && region != nullptr) {
+            retiredBytes += region->GetRegionAllocatedSize();
+        }
+    }
+
     // slow path
     MAddress TryAllocateOnce(size_t totalSize, AllocType allocType);
     MAddress AllocateImpl(size_t totalSize, AllocType allocType);
@@ -81,6 +113,18 @@ private:
     RegionList tlLargeRawPointerRegions;
     // Record stack roots in concurrent enum phase, waiting for GC to merge these roots
     std::list<BaseObject*> stackRoots;
+    // free pinned slots taken from RegionManager in bulk, so that pinned allocation does not lock for each object.
+    // gc drops these slots in post-trace phase before reclaiming pinned regions.
+    FreePinnedSlotLists tlFreePinnedSlots;
+    // bytes to be allocated before next sample, 0 if the countdown is not armed yet.
+    size_t bytesUntilSample = 0;
+    // allocated bytes when the countdown was updated, and bytes allocated since previous sample.
+    size_t sampleMarkBytes = 0;
+    size_t bytesSinceSample = 0;
+    // sampling session which armed the countdown.
+    uint32_t sampleSession = 0;
+    // bytes allocated in retired thread-local regions and out of them.
+    size_t retiredBytes = 0;
 };
 } // namespace MapleRuntime
 #endif // MRT_ALLOC_BUFFER_H
@@ -0,0 +1,245 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#include "Allocator/AllocSampler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unistd.h>
+
+#include "Allocator/AllocBuffer.h"
+#include "Base/CString.h"
+#include "Base/TimeUtils.h"
+#include "StackManager.h"
+
+namespace MapleRuntime {
+namespace {
+constexpr uint64_t NS_PER_MS = 1000 * 1000;
+constexpr double NS_PER_S = 1000.0 * 1000 * 1000;
+} // namespace
+
+std::atomic<bool> AllocSampler::sampling = { false };
+
+AllocSampler& AllocSampler::Instance() noexcept
+{
+    static AllocSampler instance;
+    return instance;
+}
+
+void AllocSampler::InitFromEnv()
+{
+    auto env = std::getenv("cjAllocSampleInterval");
+    if (env == nullptr) {
+        return;
+    }
+    size_t size = CString::ParseSizeFromEnv(env);
+    if (size == 0) {
+        LOG(RTLOG_ERROR, "Unsupported cjAllocSampleInterval parameter. It should be a positive size.\n");
+        return;
+    }
+    (void)Start(size * KB);
+}
+
+bool AllocSampler::Start(size_t interval)
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    if (IsSampling()) {
+        LOG(RTLOG_ERROR, "Start allocation sampling repeatedly.");
+        return false;
+    }
+    sampleInterval = interval == 0 ? DEFAULT_SAMPLE_INTERVAL : interval;
+    startTime = TimeUtil::NanoSeconds();
+    sites.clear();
+    liveSamples.clear();
+    pendingSamples.clear();
+    nextSeq = 0;
+    sweepableSeq = 0;
+    gcEpoch = 0;
+    session.fetch_add(1, std::memory_order_relaxed);
+    sampling.store(true, std::memory_order_relaxed);
+    VLOG(REPORT, "allocation sampling started, interval %zu B", sampleInterval);
+    return true;
+}
+
+bool AllocSampler::Stop()
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    if (!IsSampling()) {
+        LOG(RTLOG_ERROR, "Allocation sampling is not started.");
+        return false;
+    }
+    // sampled objects are still tracked by gc, so that survivorship can be dumped after sampling stops.
+    sampling.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+size_t AllocSampler::NextSampleDistance()
+{
+    static thread_local std::minstd_rand generator(static_cast<uint32_t>(TimeUtil::NanoSeconds() ^ GetTid()));
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    // -ln(u) is exponentially distributed with mean 1, 1 - u avoids log(0).
+    double distance = -std::log(1.0 - uniform(generator)) * static_cast<double>(sampleInterval);
+    return std::max<size_t>(static_cast<size_t>(distance), 1);
+}
+
+void AllocSampler::OnSlowPathAllocation(AllocBuffer& buffer, BaseObject* obj, size_t size)
+{
+    size_t weight = buffer.TakeSampleWeight(size, session.load(std::memory_order_relaxed));
+    if (weight != 0) {
+        RecordSample(obj, size, weight);
+    }
+}
+
+void AllocSampler::RecordSample(BaseObject* obj, size_t size, size_t weight)
+{
+    std::vector<uint64_t> frames;
+    StackManager::RecordLiteFrameInfos(frames, MAX_SAMPLE_FRAMES);
+
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    // the type of obj is set after the slow path returns, so the sample is added to its site once obj is initialized.
+    pendingSamples.push_back({ { obj }, std::move(frames), size, weight, gcEpoch, nextSeq++ });
+}
+
+// caller holds sampleMutex. Heap memory is zeroed before reuse, so the type of an object is null until it is set.
+void AllocSampler::ResolvePendingSamples()
+{
+    size_t kept = 0;
+    for (size_t i = 0; i < pendingSamples.size(); ++i) {
+        PendingSample& pending = pendingSamples[i];
+        if (!pending.obj.object->IsValidObject()) {
+            if (kept != i) {
+                pendingSamples[kept] = std::move(pending);
+            }
+            ++kept;
+            continue;
+        }
+        SiteStats& site = sites[{ pending.obj.object->GetTypeInfo(), std::move(pending.frames) }];
+        // the sample stands for (weight) bytes, which are counted as objects of its own size.
+        size_t count = std::max<size_t>(pending.weight / std::max<size_t>(pending.size, 1), 1);
+        site.allocCount += count;
+        site.allocBytes += pending.weight;
+        site.liveCount += count;
+        site.liveBytes += pending.weight;
+        liveSamples.push_back({ pending.obj, &site, count, pending.weight, pending.birthEpoch, pending.seq });
+    }
+    pendingSamples.erase(pendingSamples.begin() + static_cast<std::ptrdiff_t>(kept), pendingSamples.end());
+}
+
+void AllocSampler::OnTraceStart()
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    sweepableSeq = nextSeq;
+}
+
+void AllocSampler::SweepSamples(const std::function<bool(const BaseObject*)>& isLive)
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    // objects sampled before tracing started are initialized by now, as every mutator has passed a safepoint since.
+    ResolvePendingSamples();
+    size_t kept = 0;
+    for (size_t i = 0; i < liveSamples.size(); ++i) {
+        LiveSample& sample = liveSamples[i];
+        if (sample.seq >= sweepableSeq || isLive(sample.obj.object)) {
+            liveSamples[kept++] = sample;
+            continue;
+        }
+        SiteStats* site = sample.site;
+        site->liveCount -= std::min(site->liveCount, sample.count);
+        site->liveBytes -= std::min(site->liveBytes, sample.bytes);
+        site->freedCount += sample.count;
+        site->freedAgeSum += sample.count * (gcEpoch - sample.birthEpoch);
+    }
+    liveSamples.resize(kept);
+    sweepableSeq = 0;
+    ++gcEpoch;
+}
+
+void AllocSampler::VisitRawPointers(const RootVisitor& visitor)
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    for (LiveSample& sample : liveSamples) {
+        visitor(sample.obj);
+    }
+    for (PendingSample& sample : pendingSamples) {
+        visitor(sample.obj);
+    }
+}
+
+bool AllocSampler::WriteProfile(ProfileWriter& writer)
+{
+    writer.Begin({ { "alloc_objects", "count" }, { "alloc_space", "bytes" }, { "inuse_objects", "count" },
+                   { "inuse_space", "bytes" } }, 3, { "space", "bytes" }, static_cast<int64_t>(sampleInterval));
+    writer.SetDuration(TimeUtil::NanoSeconds() - startTime);
+    std::vector<uint64_t> frames;
+    for (const auto& it : sites) {
+        const SiteKey& key = it.first;
+        const SiteStats& site = it.second;
+        std::vector<StackTraceElement> stackTrace;
+        StackManager::GetStackTraceByLiteFrameInfos(key.frames, stackTrace);
+        frames.clear();
+        // the allocated type is the leaf frame, so that sites of different types are told apart.
+        frames.push_back(writer.InternFrame(key.type == nullptr ? "<unknown>" : key.type->GetName(), "", 0));
+        for (const auto& ste : stackTrace) {
+            CString name = ste.className.Length() > 0 ? ste.className + "." + ste.methodName : ste.methodName;
+            frames.push_back(writer.InternFrame(name, ste.fileName, ste.lineNumber));
+        }
+        writer.AddSample(frames, { static_cast<int64_t>(site.allocCount), static_cast<int64_t>(site.allocBytes),
+                                   static_cast<int64_t>(site.liveCount), static_cast<int64_t>(site.liveBytes) });
+    }
+    return writer.Finish();
+}
+
+bool AllocSampler::Dump(int fd, ProfileFormat format)
+{
+    std::lock_guard<std::mutex> lg(sampleMutex);
+    ResolvePendingSamples();
+    if (fd < 0 || sites.empty()) {
+        return false;
+    }
+    std::unique_ptr<ProfileWriter> writer = ProfileWriter::Create(format, fd);
+    if (writer != nullptr) {
+        return WriteProfile(*writer);
+    }
+    std::vector<std::pair<const SiteKey*, const SiteStats*>> sortedSites;
+    size_t totalBytes = 0;
+    for (const auto& it : sites) {
+        sortedSites.emplace_back(&it.first, &it.second);
+        totalBytes += it.second.allocBytes;
+    }
+    std::sort(sortedSites.begin(), sortedSites.end(), [](const auto& a, const auto& b) {
+        return a.second->liveBytes > b.second->liveBytes ||
+            (a.second->liveBytes == b.second->liveBytes && a.second->allocBytes > b.second->allocBytes);
+    });
+
+    uint64_t elapsed = TimeUtil::NanoSeconds() - startTime;
+    double rate = elapsed == 0 ? 0.0 : static_cast<double>(totalBytes) / MB * NS_PER_S / elapsed;
+    CString report = CString::FormatString(
+        "allocation samples: interval %zu B, %zu sites, estimated allocated %zu B in %lu ms (%.2f MB/s), %zu gcs\n",
+        sampleInterval, sortedSites.size(), totalBytes, elapsed / NS_PER_MS, rate, gcEpoch);
+    for (const auto& it : sortedSites) {
+        const SiteKey& key = *it.first;
+        const SiteStats& site = *it.second;
+        double avgAge = site.freedCount == 0 ? 0.0 : static_cast<double>(site.freedAgeSum) / site.freedCount;
+        report.Append(CString::FormatString(
+            "%s: allocated %zu objects %zu B, live %zu objects %zu B, freed %zu objects after %.2f gcs on average\n",
+            key.type == nullptr ? "<unknown>" : key.type->GetName(), site.allocCount, site.allocBytes,
+            site.liveCount, site.liveBytes, site.freedCount, avgAge));
+        std::vector<StackTraceElement> stackTrace;
+        StackManager::GetStackTraceByLiteFrameInfos(key.frames, stackTrace);
+        for (const auto& ste : stackTrace) {
+            report.Append(CString::FormatString("\tat %s%s%s(%s:%ld)\n", ste.className.Str(),
+                ste.className.Length() > 0 ? "." : "", ste.methodName.Str(), ste.fileName.Str(), ste.lineNumber));
+        }
+    }
+    if (write(fd, report.Str(), report.Length()) == -1) {
+        LOG(RTLOG_ERROR, "Write allocation samples failed. msg: %s", strerror(errno));
+        return false;
+    }
+    return true;
+}
+} // namespace MapleRuntime
@@ -0,0 +1,131 @@
+// Copyright (c) Huawei Technologies Co., Ltd. 2025. All rights reserved.
+// This source file is part of the Cangjie project, licensed under Apache-2.0
+// with Runtime Library Exception.
+//
+// See https://cangjie-lang.cn/pages/LICENSE for license information.
+
+
+#ifndef MRT_ALLOC_SAMPLER_H
+#define MRT_ALLOC_SAMPLER_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "Base/Globals.h"
+#include "Common/BaseObject.h"
+#include "CpuProfiler/ProfileWriter.h"
+
+namespace MapleRuntime {
+class AllocBuffer;
+
+// AllocSampler records about one allocation every (sampleInterval) bytes per thread. The distance between two samples
+// is exponentially distributed, so that allocation sites are sampled in proportion to the bytes they allocate.
+// Bytes are counted down only on the allocation slow path, i.e. when a thread-local region is refilled or an object is
+// allocated out of thread-local regions, thus the allocation fast path is untouched. A sample stands for the bytes its
+// thread allocated since the previous sample.
+//
+// A sampled object is tracked until it dies, so that survivorship of each allocation site is reported as well.
+class AllocSampler {
+public:
+    static constexpr size_t DEFAULT_SAMPLE_INTERVAL = 512 * KB;
+    // frames are recorded as {ip, startPC, funcDesc} triples.
+    static constexpr size_t MAX_SAMPLE_FRAMES = 32;
+
+    static AllocSampler& Instance() noexcept;
+
+    static bool IsSampling() { return sampling.load(std::memory_order_relaxed); }
+
+    // sampling can be enabled at startup with cjAllocSampleInterval.
+    void InitFromEnv();
+
+    bool Start(size_t interval);
+    bool Stop();
+
+    size_t GetSampleInterval() const { return sampleInterval; }
+
+    // distance in bytes to the next sample.
+    size_t NextSampleDistance();
+
+    // called on allocation slow path when sampling, before (obj) is initialized.
+    void OnSlowPathAllocation(AllocBuffer& buffer, BaseObject* obj, size_t size);
+
+    // called by gc before enumerating roots, samples recorded afterwards are not swept in this gc.
+    void OnTraceStart();
+    // called by gc after tracing, samples of dead objects are retired into their allocation sites.
+    void SweepSamples(const std::function<bool(const BaseObject*)>& isLive);
+    // called by gc to fix sampled objects which are forwarded.
+    void VisitRawPointers(const RootVisitor& visitor);
+
+    // write allocation sites ordered by live bytes, or as a pprof/collapsed profile, return false if nothing is
+    // recorded.
+    bool Dump(int fd, ProfileFormat format);
+
+private:
+    struct SiteKey {
+        const TypeInfo* type;
+        std::vector<uint64_t> frames;
+        bool operator<(const SiteKey& other) const
+        {
+            return type < other.type || (type == other.type && frames < other.frames);
+        }
+    };
+
+    struct SiteStats {
+        // estimated by sample weights.
+        size_t allocCount = 0;
+        size_t allocBytes = 0;
+        size_t liveCount = 0;
+        size_t liveBytes = 0;
+        size_t freedCount = 0;
+        // gc cycles survived by freed samples, to tell short-lived sites from leaking ones.
+        size_t freedAgeSum = 0;
+    };
+
+    struct LiveSample {
+        ObjectRef obj;
+        SiteStats* site;
+        // estimated objects and bytes which this sample stands for.
+        size_t count;
+        size_t bytes;
+        size_t birthEpoch;
+        uint64_t seq;
+    };
+
+    // a sample whose object is not initialized yet, thus its type and site are unknown.
+    struct PendingSample {
+        ObjectRef obj;
+        std::vector<uint64_t> frames;
+        size_t size;
+        size_t weight;
+        size_t birthEpoch;
+        uint64_t seq;
+    };
+
+    AllocSampler() = default;
+    ~AllocSampler() = default;
+    void RecordSample(BaseObject* obj, size_t size, size_t weight);
+    void ResolvePendingSamples();
+    bool WriteProfile(ProfileWriter& writer);
+
+    static std::atomic<bool> sampling;
+    size_t sampleInterval = DEFAULT_SAMPLE_INTERVAL;
+    uint64_t startTime = 0;
+    // changed by each Start, so that bytes allocated before are not counted by threads.
+    std::atomic<uint32_t> session = { 0 };
+
+    std::mutex sampleMutex;
+    std::map<SiteKey, SiteStats> sites;
+    std::vector<LiveSample> liveSamples;
+    std::vector<PendingSample> pendingSamples;
+    // sequence number of next sample, samples numbered below sweepableSeq are recorded before current gc starts to
+    // trace.
+    uint64_t nextSeq = 0;
+    uint64_t sweepableSeq = 0;
+    // number of gc cycles which swept samples.
+    size_t gcEpoch = 0;
+};
+} // namespace MapleRuntime
+#endif // MRT_ALLOC_SAMPLER_H
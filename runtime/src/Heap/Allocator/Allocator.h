@@ -30,6 +30,9 @@ public:
     virtual void TryReclaimGarbageMemory() = 0;
 #endif
     virtual void FeedHungryBuffers() = 0;
+    // return memory of free heap to system in background, according to heap idleness and rss target.
+    virtual size_t ScavengeGarbageMemory() = 0;
+    virtual bool HasScavengeableMemory() const = 0;
 
     // returns the total size of live large objects, excluding alignment/roundup/header, ...
     // LargeObjects() is missing.
@@ -269,6 +269,9 @@ public:
         RemoveNode(root);
     }
 
+    // remove root node but leave its physical memory untouched, caller is responsible for the memory.
+    void RemoveRootNode() { RemoveNode(root); }
+
     using RTAllocator = RTAllocatorT<sizeof(Node), alignof(Node)>;
 
 #ifdef DEBUG_CARTESIAN_TREE
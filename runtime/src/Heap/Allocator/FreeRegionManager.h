@@ -8,6 +8,8 @@
 #ifndef MRT_FREE_REGION_MANAGER_H
 #define MRT_FREE_REGION_MANAGER_H
 
+#include <atomic>
+
 #include "CartesianTree.h"
 #include "RegionInfo.h"
 #include "Common/ScopedObjectAccess.h"
@@ -26,12 +28,14 @@ public:
     virtual ~FreeRegionManager()
     {
         dirtyUnitTree.Fini();
+        lazyReleasedUnitTree.Fini();
         releasedUnitTree.Fini();
     }
 
     void Initialize(UnitCount regionCnt)
     {
         releasedUnitTree.Init(regionCnt);
+        lazyReleasedUnitTree.Init(regionCnt);
         dirtyUnitTree.Init(regionCnt);
     }
 
@@ -39,10 +43,12 @@ public:
     {
         UnitIndex idx = 0;
         bool tryDirtyTree = true;
+        bool tryLazyReleasedTree = true;
         bool tryReleasedTree = true;
+        lastTakeTime.store(TimeUtil::NanoSeconds(), std::memory_order_relaxed);
 
         // try as hard as we can to take free regions for allocation.
-        while (tryDirtyTree || tryReleasedTree) {
+        while (tryDirtyTree || tryLazyReleasedTree || tryReleasedTree) {
             // first try to get a dirty region.
             if (tryDirtyTree && dirtyUnitTreeMutex.try_lock()) {
 #if defined(__OHOS__)
@@ -65,6 +71,28 @@ public:
                 dirtyUnitTreeMutex.unlock();
             }
 
+            // then try lazily released units, which are possibly not reclaimed by kernel yet.
+            if (tryLazyReleasedTree && lazyReleasedUnitTreeMutex.try_lock()) {
+#if defined(__OHOS__)
+                bool lazyOk = lazyReleasedUnitTree.TakeUnitsLowAddr(num, idx);
+#else
+                bool lazyOk = lazyReleasedUnitTree.TakeUnits(num, idx);
+#endif
+                if (lazyOk) {
+                    DLOG(REGION, "c-tree %p alloc lazily released units[%u+%u, %u) @[0x%zx, 0x%zx), %u units left",
+                        &lazyReleasedUnitTree, idx, num, idx + num, RegionInfo::GetUnitAddress(idx),
+                        RegionInfo::GetUnitAddress(idx + num), lazyReleasedUnitTree.GetTotalCount());
+
+                    // pages not reclaimed yet keep stale content, so they are cleared like dirty units.
+                    RegionInfo::ClearUnits(idx, num);
+                    RegionInfo* region = RegionInfo::InitRegion(idx, num, uclass);
+                    lazyReleasedUnitTreeMutex.unlock();
+                    return region;
+                }
+                tryLazyReleasedTree = false;
+                lazyReleasedUnitTreeMutex.unlock();
+            }
+
             // then try to get a released region.
             if (tryReleasedTree && releasedUnitTreeMutex.try_lock()) {
 #if defined(__OHOS__)
@@ -119,6 +147,12 @@ public:
         return dirtyUnitTree.GetTotalCount();
     }
 
+    UnitCount GetLazyReleasedUnitCount() const
+    {
+        std::lock_guard<std::mutex> lg(lazyReleasedUnitTreeMutex);
+        return lazyReleasedUnitTree.GetTotalCount();
+    }
+
     UnitCount GetReleasedUnitCount() const
     {
         std::lock_guard<std::mutex> lg(releasedUnitTreeMutex);
@@ -157,6 +191,17 @@ public:
     size_t CalculateBytesToRelease() const;
     size_t ReleaseGarbageRegions(size_t targetCachedSize);
 
+    // return physical memory of dirty units until at most targetCachedSize bytes are kept dirty. MADV_FREE is preferred
+    // so that memory is reclaimed only if the system really needs it.
+    size_t ScavengeGarbageRegions(size_t targetCachedSize);
+    // release lazily released units eagerly, used when the process is under memory pressure.
+    size_t ReleaseLazyReleasedRegions();
+
+    // time in nanoseconds when free units are last demanded for allocation.
+    uint64_t GetLastTakeTime() const { return lastTakeTime.load(std::memory_order_relaxed); }
+    // accumulated bytes of memory returned to system since startup.
+    size_t GetScavengedSize() const { return scavengedBytes.load(std::memory_order_relaxed); }
+
 private:
     inline void PrehandleReleasedUnit(bool expectPhysicalMem, size_t idx, size_t num) const
     {
@@ -170,9 +215,17 @@ private:
     mutable std::mutex releasedUnitTreeMutex;
     CartesianTree releasedUnitTree;
 
+    // lazily released units are returned to system by MADV_FREE, but pages may survive and keep stale content until
+    // kernel really reclaims them, thus must be zeroed explicitly for allocation.
+    mutable std::mutex lazyReleasedUnitTreeMutex;
+    CartesianTree lazyReleasedUnitTree;
+
     // dirty units are neither cleared nor released, thus must be zeroed explicitly for allocation.
     mutable std::mutex dirtyUnitTreeMutex;
     CartesianTree dirtyUnitTree;
+
+    std::atomic<uint64_t> lastTakeTime = { 0 };
+    std::atomic<size_t> scavengedBytes = { 0 };
 };
 } // namespace MapleRuntime
 #endif // MRT_FREE_REGION_MANAGER_H
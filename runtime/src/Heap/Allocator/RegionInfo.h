@@ -587,6 +587,23 @@ public:
 #endif
     }
 
+    // return physical memory lazily with MADV_FREE: kernel reclaims pages only under memory pressure, and pages keep
+    // stale content until then. return false if lazy release is unsupported, and memory is left as it is.
+    static bool LazyReleaseUnits(size_t idx, size_t cnt)
+    {
+#if defined(MADV_FREE) && !defined(CANGJIE_ASAN_SUPPORT)
+        void* unitAddress = reinterpret_cast<void*>(RegionInfo::GetUnitAddress(idx));
+        size_t size = cnt * RegionInfo::UNIT_SIZE;
+        DLOG(REGION, "lazily release physical memory for units [%zu+%zu, %zu) @[%p+%zu, 0x%zx)", idx, cnt, idx + cnt,
+             unitAddress, size, RegionInfo::GetUnitAddress(idx + cnt));
+        return madvise(unitAddress, size, MADV_FREE) == 0;
+#else
+        (void)idx;
+        (void)cnt;
+        return false;
+#endif
+    }
+
     BaseObject* GetFirstObject() const { return reinterpret_cast<BaseObject*>(GetRegionStart()); }
 
     bool IsEmpty() const
@@ -854,15 +871,16 @@ public:
     // for regions shared by multithreads
     uintptr_t AtomicAlloc(size_t size)
     {
-        uintptr_t addr = __atomic_fetch_add(&metadata.allocPtr, size, __ATOMIC_ACQ_REL);
-        // should not check allocPtr, because it might be shared
-        if ((addr < GetRegionEnd()) && (size <= GetRegionEnd() - addr)) {
-            return addr;
-        }
-        if (addr <= GetRegionEnd()) {
-            __atomic_store_n(&metadata.allocPtr, addr, __ATOMIC_SEQ_CST);
-        }
-        return 0;
+        uintptr_t limit = GetRegionEnd();
+        uintptr_t addr = __atomic_load_n(&metadata.allocPtr, __ATOMIC_ACQUIRE);
+        // allocPtr never runs past region end, so a linear walk of a shared region never meets a hole.
+        do {
+            if (addr > limit || size > limit - addr) {
+                return 0;
+            }
+        } while (!__atomic_compare_exchange_n(&metadata.allocPtr, &addr, addr + size, true, __ATOMIC_ACQ_REL,
+                                              __ATOMIC_ACQUIRE));
+        return addr;
     }
 
     bool IsTraceRegion() const { return metadata.isTraceRegion == 1; }
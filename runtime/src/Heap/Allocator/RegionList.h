@@ -156,6 +156,13 @@ public:
         this->ClearList();
     }
 
+    // caller must hold listMutex of this list.
+    void MoveToLocked(RegionList& targetList)
+    {
+        targetList.AssignWith(*this);
+        this->ClearList();
+    }
+
     void CopyListTo(RegionList& dstList)
     {
         std::lock_guard<std::mutex> lock(listMutex);
@@ -8,6 +8,7 @@
 #include "Allocator/RegionManager.h"
 
 #include <cmath>
+#include <limits>
 #include <unistd.h>
 
 #include "Allocator/RegionSpace.h"
@@ -83,6 +84,41 @@ private:
     RegionList& fromRegionList;
 };
 
+// sweep tasks drain an old region list concurrently, the unswept part of the list is the sweep progress.
+class PinnedSweepTask : public HeapWork {
+public:
+    PinnedSweepTask(RegionManager& manager, std::atomic<size_t>& garbage)
+        : regionManager(manager), garbageSize(garbage) {}
+
+    ~PinnedSweepTask() = default;
+
+    void Execute(size_t) override
+    {
+        garbageSize.fetch_add(regionManager.SweepPinnedRegions(), std::memory_order_relaxed);
+    }
+
+private:
+    RegionManager& regionManager;
+    std::atomic<size_t>& garbageSize;
+};
+
+class LargeSweepTask : public HeapWork {
+public:
+    LargeSweepTask(RegionManager& manager, std::atomic<size_t>& garbage)
+        : regionManager(manager), garbageSize(garbage) {}
+
+    ~LargeSweepTask() = default;
+
+    void Execute(size_t) override
+    {
+        garbageSize.fetch_add(regionManager.SweepLargeRegions(), std::memory_order_relaxed);
+    }
+
+private:
+    RegionManager& regionManager;
+    std::atomic<size_t>& garbageSize;
+};
+
 #if defined(GCINFO_DEBUG) && GCINFO_DEBUG
 void RegionInfo::DumpRegionInfo(LogType type) const
 {
@@ -303,6 +339,130 @@ size_t FreeRegionManager::ReleaseGarbageRegions(size_t targetCachedSize)
     return releasedBytes;
 }
 
+size_t FreeRegionManager::ScavengeGarbageRegions(size_t targetCachedSize)
+{
+    size_t dirtyBytes = GetDirtyUnitCount() * RegionInfo::UNIT_SIZE;
+    size_t scavengedBytes = 0;
+    size_t lazyReleasedBytes = 0;
+    while (dirtyBytes > targetCachedSize) {
+        std::lock_guard<std::mutex> lock1(dirtyUnitTreeMutex);
+        auto node = dirtyUnitTree.RootNode();
+        if (node == nullptr) { break; }
+        Index idx = node->GetIndex();
+        UnitCount num = node->GetCount();
+        if (RegionInfo::LazyReleaseUnits(idx, num)) {
+            dirtyUnitTree.RemoveRootNode();
+            std::lock_guard<std::mutex> lock2(lazyReleasedUnitTreeMutex);
+            CHECK_DETAIL(lazyReleasedUnitTree.MergeInsert(idx, num, true),
+                         "tid %d: failed to lazily release garbage units[%u+%u, %u)", GetTid(), idx, num, idx + num);
+            lazyReleasedBytes += (num * RegionInfo::UNIT_SIZE);
+        } else {
+            dirtyUnitTree.ReleaseRootNode();
+            std::lock_guard<std::mutex> lock2(releasedUnitTreeMutex);
+            CHECK_DETAIL(releasedUnitTree.MergeInsert(idx, num, true),
+                         "tid %d: failed to release garbage units[%u+%u, %u)", GetTid(), idx, num, idx + num);
+        }
+        scavengedBytes += (num * RegionInfo::UNIT_SIZE);
+        dirtyBytes = dirtyUnitTree.GetTotalCount() * RegionInfo::UNIT_SIZE;
+    }
+    this->scavengedBytes.fetch_add(scavengedBytes, std::memory_order_relaxed);
+    VLOG(REPORT, "scavenge heap garbage memory %zu bytes (lazily %zu bytes), cache %zu(%zu) bytes",
+         scavengedBytes, lazyReleasedBytes, dirtyBytes, targetCachedSize);
+    return scavengedBytes;
+}
+
+size_t FreeRegionManager::ReleaseLazyReleasedRegions()
+{
+    size_t releasedBytes = 0;
+    while (true) {
+        std::lock_guard<std::mutex> lock1(lazyReleasedUnitTreeMutex);
+        auto node = lazyReleasedUnitTree.RootNode();
+        if (node == nullptr) { break; }
+        Index idx = node->GetIndex();
+        UnitCount num = node->GetCount();
+        lazyReleasedUnitTree.ReleaseRootNode();
+
+        std::lock_guard<std::mutex> lock2(releasedUnitTreeMutex);
+        CHECK_DETAIL(releasedUnitTree.MergeInsert(idx, num, true), "tid %d: failed to release garbage units[%u+%u, %u)",
+                     GetTid(), idx, num, idx + num);
+        releasedBytes += (num * RegionInfo::UNIT_SIZE);
+    }
+    VLOG(REPORT, "release lazily released heap memory %zu bytes", releasedBytes);
+    return releasedBytes;
+}
+
+size_t RegionManager::ScavengeGarbageRegions()
+{
+    size_t dirtySize = GetDirtyUnitCount() * RegionInfo::UNIT_SIZE;
+    size_t targetCachedSize = dirtySize;
+    uint64_t now = TimeUtil::NanoSeconds();
+    uint64_t lastTakeTime = freeRegionManager.GetLastTakeTime();
+    uint64_t idleTime = now > lastTakeTime ? now - lastTakeTime : 0;
+    if (scavengeDelay != 0 && idleTime >= scavengeDelay) {
+        // heap has been idle since dirty size reached its base, retained dirty size halves every half-life.
+        if (scavengeBaseSize == 0 || dirtySize > scavengeBaseSize) {
+            scavengeBaseSize = dirtySize;
+        }
+        double halfLives = scavengeHalfLife == 0 ? std::numeric_limits<double>::infinity() :
+            static_cast<double>(idleTime - scavengeDelay) / static_cast<double>(scavengeHalfLife);
+        targetCachedSize = static_cast<size_t>(static_cast<double>(scavengeBaseSize) * std::exp2(-halfLives));
+    } else {
+        scavengeBaseSize = 0;
+    }
+
+    size_t scavengedSize = 0;
+    if (heapRssTarget != 0) {
+        size_t usedSize = GetUsedRegionSize();
+        size_t budget = heapRssTarget > usedSize ? heapRssTarget - usedSize : 0;
+        targetCachedSize = std::min(targetCachedSize, budget);
+        if (usedSize + dirtySize > heapRssTarget) {
+            // pages returned lazily might still count in rss, they are released eagerly when over target.
+            scavengedSize += freeRegionManager.ReleaseLazyReleasedRegions();
+        }
+    }
+    if (targetCachedSize < dirtySize) {
+        scavengedSize += freeRegionManager.ScavengeGarbageRegions(targetCachedSize);
+    }
+    return scavengedSize;
+}
+
+size_t RegionManager::ReleaseAllGarbageRegions()
+{
+    ReclaimGarbageRegions();
+    size_t releasedSize = freeRegionManager.ReleaseGarbageRegions(0);
+    releasedSize += freeRegionManager.ReleaseLazyReleasedRegions();
+    scavengeBaseSize = 0;
+    return releasedSize;
+}
+
+void RegionManager::SetScavengeParameters()
+{
+    auto env = std::getenv("cjScavengeDelay");
+    if (env != nullptr) {
+        // idle scavenging is opt-in. "0s" is not a valid time, thus it stays disabled by any value which is not a
+        // positive time.
+        scavengeDelay = CString::ParseTimeFromEnv(env);
+    }
+    env = std::getenv("cjScavengeHalfLife");
+    if (env != nullptr) {
+        uint64_t halfLife = CString::ParseTimeFromEnv(env);
+        if (halfLife != 0) {
+            scavengeHalfLife = halfLife;
+        } else {
+            LOG(RTLOG_ERROR, "Unsupported cjScavengeHalfLife parameter. It should be a positive time.\n");
+        }
+    }
+    env = std::getenv("cjHeapRssTarget");
+    if (env != nullptr) {
+        size_t size = CString::ParseSizeFromEnv(env);
+        if (size != 0) {
+            heapRssTarget = size * KB;
+        } else {
+            LOG(RTLOG_ERROR, "Unsupported cjHeapRssTarget parameter. It should be a positive size.\n");
+        }
+    }
+}
+
 void RegionManager::SetMaxUnitCountForRegion()
 {
     maxUnitCountPerRegion = CangjieRuntime::GetHeapParam().regionSize * KB / RegionInfo::UNIT_SIZE;
@@ -387,6 +547,7 @@ void RegionManager::Initialize(size_t nUnit, uintptr_t regionInfoAddr)
     SetMaxUnitCountForPinnedRegion();
     SetLargeObjectThreshold();
     SetGarbageThreshold();
+    SetScavengeParameters();
 #if defined(__EULER__)
     SetCacheRatio(0.0, 1.0, 1.0);
 #endif
@@ -459,7 +620,16 @@ void RegionManager::AssembleLargeGarbageCandidates()
 
 void RegionManager::AssemblePinnedGarbageCandidates(bool collectAll)
 {
-    oldPinnedRegionList.MergeRegionList(recentPinnedRegionList, RegionInfo::RegionType::FULL_PINNED_REGION);
+    RegionList recentPinnedRegions("recent pinned region cache");
+    {
+        // retire the shared pinned region together with recent pinned list, so that no new region is published
+        // in between. Allocation with a retired region may still happen before enumeration, which is safe because
+        // the new object is a root of that mutator.
+        std::lock_guard<std::mutex> lock(recentPinnedRegionList.GetListMutex());
+        pinnedAllocRegion.store(nullptr, std::memory_order_release);
+        recentPinnedRegionList.MoveToLocked(recentPinnedRegions);
+    }
+    oldPinnedRegionList.MergeRegionList(recentPinnedRegions, RegionInfo::RegionType::FULL_PINNED_REGION);
     RegionInfo* region = oldPinnedRegionList.GetHeadRegion();
     while (region != nullptr) {
         RegionInfo* nextRegion = region->GetNextRegion();
@@ -552,6 +722,11 @@ RegionInfo* RegionManager::TakeRegion(size_t num, RegionInfo::UnitRole type, boo
     // check for allocation since we do not want gc threads and mutators do any harm to each other.
     size_t size = num * RegionInfo::UNIT_SIZE;
     RequestForRegion(size);
+    if (UNLIKELY(ScheduleTraceEventEnabled(TRACE_EV_HEAP_ALLOC_REGION))) {
+        // used region size sums the counts of all region lists, compute it only when the event is recorded.
+        ScheduleTraceEvent(TRACE_EV_HEAP_ALLOC_REGION, -1, nullptr, TRACE_ARGS_2,
+                           static_cast<unsigned long long>(size), static_cast<unsigned long long>(GetUsedRegionSize()));
+    }
 
 #if !defined(__OHOS__)
     RegionInfo* head = garbageRegionList.TakeHeadRegion();
@@ -654,78 +829,110 @@ size_t RegionManager::CollectFreePinnedSlots(RegionInfo* region)
     // traverse pinned region to reclaim free pinned objects.
     size_t start = region->GetRegionStart();
     size_t garbageSize = 0;
-    region->VisitAllObjects([this, region, start, &garbageSize](BaseObject* object) {
+    FreePinnedSlotLists regionSlots;
+    region->VisitAllObjects([region, start, &garbageSize, &regionSlots](BaseObject* object) {
         size_t offset = reinterpret_cast<MAddress>(object) - start;
         if (!region->IsSurvivedObject(offset)) {
             size_t objSize = object->GetSize();
             DLOG(ALLOC, "reclaim pinned obj %p<%p>(%zu)", object, object->GetTypeInfo(), objSize);
             garbageSize += objSize;
-            std::lock_guard<std::mutex> lock(freePinnedSlotListMutex);
             ReleaseNativeResource(object);
-            freePinnedSlotLists.PushFront(object);
+            regionSlots.PushFront(object);
         }
     });
+    // publish free slots of this region at once.
+    std::lock_guard<std::mutex> lock(freePinnedSlotListMutex);
+    freePinnedSlotLists.Splice(regionSlots);
     return garbageSize;
 }
 
-size_t RegionManager::CollectPinnedGarbage()
+size_t RegionManager::SweepPinnedRegions()
 {
-    {
-        std::lock_guard<std::mutex> lock(freePinnedSlotListMutex);
-        freePinnedSlotLists.Clear();
-    }
     size_t garbageSize = 0;
-    RegionInfo* region = oldPinnedRegionList.GetHeadRegion();
+    RegionInfo* region = oldPinnedRegionList.TakeHeadRegion();
     while (region != nullptr) {
         if (region->GetLiveByteCount() == 0) {
-            RegionInfo* del = region;
-            region = region->GetNextRegion();
-            oldPinnedRegionList.DeleteRegion(del);
-
             auto fixToObj = [](BaseObject* obj) { ReleaseNativeResource(obj); };
-            del->VisitAllObjects(fixToObj);
-
-            garbageSize += CollectRegion(del);
-            continue;
+            region->VisitAllObjects(fixToObj);
+            garbageSize += CollectRegion(region);
         } else {
             garbageSize += CollectFreePinnedSlots(region);
-            region = region->GetNextRegion();
+            sweptPinnedRegionList.PrependRegion(region, RegionInfo::RegionType::FULL_PINNED_REGION);
         }
+        region = oldPinnedRegionList.TakeHeadRegion();
     }
     return garbageSize;
 }
 
-size_t RegionManager::CollectLargeGarbage()
+size_t RegionManager::CollectPinnedGarbage(GCThreadPool* threadPool)
+{
+    {
+        std::lock_guard<std::mutex> lock(freePinnedSlotListMutex);
+        freePinnedSlotLists.Clear();
+        // slots cached by mutators may lie in regions reclaimed below. All mutators are in post-trace phase now,
+        // in which they never touch their slot caches.
+        AllocBufferVisitor visitor = [](AllocBuffer& buffer) { buffer.ClearFreePinnedSlots(); };
+        Heap::GetHeap().GetAllocator().VisitAllocBuffers(visitor);
+    }
+    std::atomic<size_t> garbageSize = { 0 };
+    if (threadPool != nullptr && oldPinnedRegionList.GetRegionCount() > 1) {
+        int32_t threadNum = threadPool->GetMaxThreadNum() + 1;
+        threadPool->Start();
+        for (int32_t i = 0; i < threadNum; ++i) {
+            threadPool->AddWork(new (std::nothrow) PinnedSweepTask(*this, garbageSize));
+        }
+        threadPool->WaitFinish();
+    }
+    // sweep serially if there is no thread pool, or the rest regions left by workers.
+    garbageSize.fetch_add(SweepPinnedRegions(), std::memory_order_relaxed);
+    oldPinnedRegionList.MergeRegionList(sweptPinnedRegionList, RegionInfo::RegionType::FULL_PINNED_REGION);
+    return garbageSize.load(std::memory_order_relaxed);
+}
+
+size_t RegionManager::SweepLargeRegions()
 {
     size_t garbageSize = 0;
-    RegionInfo* region = oldLargeRegionList.GetHeadRegion();
+    RegionInfo* region = oldLargeRegionList.TakeHeadRegion();
     while (region != nullptr) {
         // for large region, the offset of obj is 0
         if (!region->IsSurvivedObject(0)) {
             DLOG(REGION, "reclaim large region %p@[0x%zx+%zu, 0x%zx) type %u", region, region->GetRegionStart(),
                  region->GetRegionAllocatedSize(), region->GetRegionEnd(), region->GetRegionType());
-
-            RegionInfo* del = region;
-            region = region->GetNextRegion();
-            oldLargeRegionList.DeleteRegion(del);
-            if (del->GetRegionSize() > RegionInfo::LARGE_OBJECT_RELEASE_THRESHOLD) {
-                garbageSize += ReleaseRegion(del);
+            if (region->GetRegionSize() > RegionInfo::LARGE_OBJECT_RELEASE_THRESHOLD) {
+                garbageSize += ReleaseRegion(region);
             } else {
-                garbageSize += CollectRegion(del);
+                garbageSize += CollectRegion(region);
             }
         } else {
             region->ResetMarkBit();
-            region = region->GetNextRegion();
+            sweptLargeRegionList.PrependRegion(region, RegionInfo::RegionType::LARGE_REGION);
         }
+        region = oldLargeRegionList.TakeHeadRegion();
     }
+    return garbageSize;
+}
 
-    region = recentLargeRegionList.GetHeadRegion();
+size_t RegionManager::CollectLargeGarbage(GCThreadPool* threadPool)
+{
+    std::atomic<size_t> garbageSize = { 0 };
+    if (threadPool != nullptr && oldLargeRegionList.GetRegionCount() > 1) {
+        int32_t threadNum = threadPool->GetMaxThreadNum() + 1;
+        threadPool->Start();
+        for (int32_t i = 0; i < threadNum; ++i) {
+            threadPool->AddWork(new (std::nothrow) LargeSweepTask(*this, garbageSize));
+        }
+        threadPool->WaitFinish();
+    }
+    garbageSize.fetch_add(SweepLargeRegions(), std::memory_order_relaxed);
+    oldLargeRegionList.MergeRegionList(sweptLargeRegionList, RegionInfo::RegionType::LARGE_REGION);
+
+    RegionInfo* region = recentLargeRegionList.GetHeadRegion();
     while (region != nullptr) {
         region->ResetMarkBit();
         region = region->GetNextRegion();
     }
 
-    return garbageSize;
+    return garbageSize.load(std::memory_order_relaxed);
 }
 
 #if defined(GCINFO_DEBUG) && GCINFO_DEBUG
@@ -857,6 +1064,7 @@ void RegionManager::DumpRegionStats(const char* msg, bool dumpToError) const
     size_t dirtyMaxBlock = freeRegionManager.GetDirtyMaxBlock();
     size_t releasedNodeCount = freeRegionManager.GetReleasedNodeCount();
     size_t dirtyNodeCount = freeRegionManager.GetDirtyNodeCount();
+    size_t lazyReleasedUnits = freeRegionManager.GetLazyReleasedUnitCount();
     DUMP_REGION_STATS_LOG("\treleased units: %zu (%zu B), nodes: %zu, maxBlock: %zu units (%zu B)",
                           releasedUnits, releasedUnits * RegionInfo::UNIT_SIZE,
                           releasedNodeCount,
@@ -865,6 +1073,9 @@ void RegionManager::DumpRegionStats(const char* msg, bool dumpToError) const
                           dirtyUnits, dirtyUnits * RegionInfo::UNIT_SIZE, dirtyNodeCount,
                           dirtyMaxBlock,
                           dirtyMaxBlock * RegionInfo::UNIT_SIZE);
+    DUMP_REGION_STATS_LOG("\tlazily released units: %zu (%zu B), scavenged total: %zu B",
+                          lazyReleasedUnits, lazyReleasedUnits * RegionInfo::UNIT_SIZE,
+                          freeRegionManager.GetScavengedSize());
 
     DUMP_REGION_STATS_LOG("\tgarbage+dirty summary: garbageUnits %zu (%zu B, allocObj %zu), dirtyUnits %zu (%zu B)",
                           garbageUnits, garbageSize, allocGarbageSize, dirtyUnits, dirtySize);
@@ -1184,15 +1395,28 @@ void RegionManager::ForwardRegion(RegionInfo* region)
     }
 }
 
-uintptr_t RegionManager::AllocPinnedFromFreeList(size_t size)
+size_t RegionManager::RefillFreePinnedSlots(FreePinnedSlotLists& localSlots, size_t size)
 {
     std::lock_guard<std::mutex> lock(freePinnedSlotListMutex);
+    return freePinnedSlotLists.TransferTo(localSlots, size, PINNED_SLOT_REFILL_COUNT);
+}
+
+uintptr_t RegionManager::AllocPinnedFromFreeList(size_t size)
+{
+    if (!FreePinnedSlotLists::IsSlotSize(size)) {
+        return 0;
+    }
     GCPhase mutatorPhase = Mutator::GetMutator()->GetMutatorPhase();
     // For preventing missing mark, do not allocate object from slot list when gc phase is post trace.
+    // gc also drops thread-local slot caches in this phase.
     if (mutatorPhase == GCPhase::GC_PHASE_POST_TRACE) {
         return 0;
     }
-    uintptr_t allocPtr = freePinnedSlotLists.PopFront(size);
+    FreePinnedSlotLists& localSlots = AllocBuffer::GetOrCreateAllocBuffer()->GetFreePinnedSlots();
+    uintptr_t allocPtr = localSlots.PopFront(size);
+    if (allocPtr == 0 && RefillFreePinnedSlots(localSlots, size) != 0) {
+        allocPtr = localSlots.PopFront(size);
+    }
     // For making bitmap comform with live object count, do not mark object repeated.
     if (allocPtr == 0 ||
         (mutatorPhase != GCPhase::GC_PHASE_ENUM &&
@@ -27,46 +27,6 @@ namespace MapleRuntime {
 class CopyCollector;
 class CompactCollector;
 
-struct FreePinnedSlotLists {
-    static constexpr size_t ATOMIC_OBJECT_SIZE = 16;
-    static constexpr size_t SYNC_OBJECT_SIZE = CJFuture::SYNC_OBJECT_SIZE;
-    SlotList freeAtomicSlotList;
-    SlotList freeSyncSlotList;
-
-    uintptr_t PopFront(size_t size)
-    {
-        switch (size) {
-            case ATOMIC_OBJECT_SIZE:
-                return freeAtomicSlotList.PopFront(size);
-            case SYNC_OBJECT_SIZE:
-                return freeSyncSlotList.PopFront(size);
-            default:
-                return 0;
-        }
-    }
-
-    void PushFront(BaseObject* slot)
-    {
-        size_t size = slot->GetSize();
-        switch (size) {
-            case ATOMIC_OBJECT_SIZE:
-                freeAtomicSlotList.PushFront(slot);
-                break;
-            case SYNC_OBJECT_SIZE:
-                freeSyncSlotList.PushFront(slot);
-                break;
-            default:
-                return;
-        }
-    }
-
-    void Clear()
-    {
-        freeAtomicSlotList.Clear();
-        freeSyncSlotList.Clear();
-    }
-};
-
 // RegionManager needs to know header size and alignment in order to iterate objects linearly
 // and thus its Alloc should be rewrite with AllocObj(objSize)
 class RegionManager {
@@ -107,8 +67,9 @@ public:
           fullTraceRegions("full trace regions"), fromRegionList("from regions"),
           ghostFromRegionList("ghost from regions"), unmovableFromRegionList("escaped from regions"),
           garbageRegionList("garbage regions"), recentPinnedRegionList("recent pinned regions"),
-          oldPinnedRegionList("old pinned regions"), rawPointerPinnedRegionList("raw pointer pinned regions"),
-          oldLargeRegionList("old large regions"), recentLargeRegionList("recent large regions"),
+          oldPinnedRegionList("old pinned regions"), sweptPinnedRegionList("swept pinned regions"),
+          rawPointerPinnedRegionList("raw pointer pinned regions"), oldLargeRegionList("old large regions"),
+          sweptLargeRegionList("swept large regions"), recentLargeRegionList("recent large regions"),
           largeTraceRegions("large trace regions")
     {}
 
@@ -146,8 +107,28 @@ public:
     RegionInfo* TakeRegion(size_t num, RegionInfo::UnitRole, bool expectPhysicalMem = false);
 
     uintptr_t AllocPinnedFromFreeList(size_t size);
+    size_t RefillFreePinnedSlots(FreePinnedSlotLists& localSlots, size_t size);
 
     uintptr_t AllocPinned(size_t size)
+    {
+        // pinned region is shared by all mutators, bump the pointer lock-free in common case.
+        RegionInfo* allocRegion = pinnedAllocRegion.load(std::memory_order_acquire);
+        if (allocRegion != nullptr) {
+            uintptr_t addr = allocRegion->AtomicAlloc(size);
+            if (addr != 0) {
+                DLOG(ALLOC, "alloc pinned obj 0x%zx(%zu)", addr, size);
+                return addr;
+            }
+        }
+        uintptr_t addr = AllocPinnedFromFreeList(size);
+        if (addr != 0) {
+            DLOG(ALLOC, "alloc pinned obj 0x%zx(%zu) from free slot", addr, size);
+            return addr;
+        }
+        return AllocPinnedInNewRegion(size);
+    }
+
+    uintptr_t AllocPinnedInNewRegion(size_t size)
     {
         uintptr_t addr = 0;
         std::mutex& regionListMutex = recentPinnedRegionList.GetListMutex();
@@ -159,12 +140,10 @@ public:
             regionListMutex.lock();
         }
 
-        RegionInfo* headRegion = recentPinnedRegionList.GetHeadRegion();
-        if (headRegion != nullptr) {
-            addr = headRegion->Alloc(size);
-        }
-        if (addr == 0) {
-            addr = AllocPinnedFromFreeList(size);
+        // other mutator may have installed a new pinned region while we were waiting for the lock.
+        RegionInfo* allocRegion = pinnedAllocRegion.load(std::memory_order_acquire);
+        if (allocRegion != nullptr) {
+            addr = allocRegion->AtomicAlloc(size);
         }
         if (addr == 0) {
             size_t needUnitCount = maxUnitCountPerRegion;
@@ -187,6 +166,8 @@ public:
             // To make sure the allocedSize are consistent, it must prepend region first then alloc object.
             recentPinnedRegionList.PrependRegionLocked(region, RegionInfo::RegionType::RECENT_PINNED_REGION);
             addr = region->Alloc(size);
+            // publish the region only after it is linked in recent pinned list.
+            pinnedAllocRegion.store(region, std::memory_order_release);
         }
 
         DLOG(ALLOC, "alloc pinned obj 0x%zx(%zu)", addr, size);
@@ -330,14 +311,23 @@ public:
         }
     }
 
-    size_t CollectLargeGarbage();
+    // sweep old large and pinned regions with gc thread pool if it is not null.
+    size_t CollectLargeGarbage(GCThreadPool* threadPool);
+    size_t SweepLargeRegions();
 
-    size_t CollectPinnedGarbage();
+    size_t CollectPinnedGarbage(GCThreadPool* threadPool);
+    size_t SweepPinnedRegions();
     size_t CollectFreePinnedSlots(RegionInfo* region);
 
     // targetSize: size of memory which we do not release and keep it as cache for future allocation.
     size_t ReleaseGarbageRegions(size_t targetSize) { return freeRegionManager.ReleaseGarbageRegions(targetSize); }
 
+    // return dirty units to system gradually once heap stays idle, and keep heap rss under target if it is set.
+    size_t ScavengeGarbageRegions();
+    // release all reclaimable memory immediately, used when system reports memory pressure.
+    size_t ReleaseAllGarbageRegions();
+    bool IsScavengeEnabled() const { return scavengeDelay != 0 || heapRssTarget != 0; }
+
     // Ignore dynamic pinned regions and from regions whose garbage objects are quite few, return the garbage size that
     // can be reclaimed.
     size_t ExemptFromRegions();
@@ -368,10 +358,14 @@ public:
             recentLargeRegionList.GetUnitCount() + oldPinnedRegionList.GetUnitCount() +
             recentPinnedRegionList.GetUnitCount() + rawPointerPinnedRegionList.GetUnitCount() +
             largeTraceRegions.GetUnitCount() + fullTraceRegions.GetUnitCount() +
+            sweptPinnedRegionList.GetUnitCount() + sweptLargeRegionList.GetUnitCount() +
             tlRegionList.GetUnitCount();
     }
 
     size_t GetDirtyUnitCount() const { return freeRegionManager.GetDirtyUnitCount(); }
+    size_t GetLazyReleasedUnitCount() const { return freeRegionManager.GetLazyReleasedUnitCount(); }
+    size_t GetReleasedUnitCount() const { return freeRegionManager.GetReleasedUnitCount(); }
+    size_t GetScavengedSize() const { return freeRegionManager.GetScavengedSize(); }
 
     size_t GetInactiveUnitCount() const { return (regionHeapEnd - inactiveZone) / RegionInfo::UNIT_SIZE; }
 
@@ -399,6 +393,7 @@ public:
             recentLargeRegionList.GetAllocatedSize() + oldPinnedRegionList.GetAllocatedSize() +
             recentPinnedRegionList.GetAllocatedSize() + rawPointerPinnedRegionList.GetAllocatedSize() +
             largeTraceRegions.GetAllocatedSize() + fullTraceRegions.GetAllocatedSize() +
+            sweptPinnedRegionList.GetAllocatedSize() + sweptLargeRegionList.GetAllocatedSize() +
             threadLocalSize;
     }
 
@@ -426,6 +421,7 @@ public:
     void SetMaxUnitCountForPinnedRegion();
     void SetLargeObjectThreshold();
     void SetGarbageThreshold();
+    void SetScavengeParameters();
 
     void HandleTraceRegions()
     {
@@ -534,6 +530,10 @@ public:
 
 private:
     static const size_t MAX_UNIT_COUNT_PER_REGION;
+    // number of free pinned slots moved to thread-local cache once.
+    static constexpr size_t PINNED_SLOT_REFILL_COUNT = 32;
+    // default scavenge half-life: 30s. idle scavenging is off unless cjScavengeDelay is set.
+    static constexpr uint64_t DEFAULT_SCAVENGE_HALF_LIFE = 30ULL * 1000 * 1000 * 1000;
     static const size_t HUGE_PAGE;
     inline void CheckRegionWhetherCreatedInFixPhase(RegionInfo* region);
     inline void TagHugePage(RegionInfo* region, size_t num) const;
@@ -578,6 +578,8 @@ private:
     // may be moved during compaction.
     RegionList recentPinnedRegionList;
     RegionList oldPinnedRegionList;
+    // old pinned regions already swept in current gc, merged back to oldPinnedRegionList when sweeping is done.
+    RegionList sweptPinnedRegionList;
 
     // region lists for small-sized raw-pointer objects (i.e. future, monitor)
     // which can not be moved ever (even during compaction).
@@ -586,6 +588,8 @@ private:
     // regions for large-sized objects.
     // large region is recorded here after large object is allocated.
     RegionList oldLargeRegionList;
+    // old large regions already swept in current gc, merged back to oldLargeRegionList when sweeping is done.
+    RegionList sweptLargeRegionList;
 
     // if large region is allocated when gc is not running, it is recorded here.
     RegionList recentLargeRegionList;
@@ -612,6 +616,18 @@ private:
 #if defined(__EULER__)
     double cacheRatio;
 #endif
+    // dirty units are kept for (scavengeDelay) ns after last demand, then retained dirty size decays by half every
+    // (scavengeHalfLife) ns. scavengeDelay being 0, which is the default, disables idle scavenging.
+    uint64_t scavengeDelay = 0;
+    uint64_t scavengeHalfLife = DEFAULT_SCAVENGE_HALF_LIFE;
+    // dirty size when heap turns idle, it is the base of retained dirty size decaying.
+    size_t scavengeBaseSize = 0;
+    // used units plus dirty units are kept under this size if it is not 0.
+    size_t heapRssTarget = 0;
+    // the recent pinned region shared by mutators for lock-free bump-pointer allocation.
+    // it is updated with the lock of recentPinnedRegionList held, and retired before pinned regions are collected.
+    std::atomic<RegionInfo*> pinnedAllocRegion = { nullptr };
+    // free slots reclaimed by gc, mutators take them in bulk into thread-local caches of AllocBuffer.
     std::mutex freePinnedSlotListMutex;
     FreePinnedSlotLists freePinnedSlotLists;
 };
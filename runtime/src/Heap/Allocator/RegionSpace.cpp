@@ -7,6 +7,8 @@
 
 #include "Allocator/RegionSpace.h"
 
+#include "Allocator/AllocSampler.h"
+
 #include "Collector/Collector.h"
 #include "Collector/CollectorResources.h"
 #if defined(CANGJIE_SANITIZER_SUPPORT) || defined(CANGJIE_GWPASAN_SUPPORT)
@@ -18,11 +20,15 @@
 namespace MapleRuntime {
 MAddress RegionSpace::TryAllocateOnce(size_t allocSize, AllocType allocType)
 {
-    if (UNLIKELY(allocType == AllocType::PINNED_OBJECT)) {
-        return regionManager.AllocPinned(allocSize);
-    }
-    if (UNLIKELY(allocSize >= regionManager.GetLargeObjectThreshold())) {
-        return regionManager.AllocLarge(allocSize);
+    if (UNLIKELY(allocType == AllocType::PINNED_OBJECT || allocSize >= regionManager.GetLargeObjectThreshold())) {
+        MAddress addr = allocType == AllocType::PINNED_OBJECT ? regionManager.AllocPinned(allocSize) :
+            regionManager.AllocLarge(allocSize);
+        AllocBuffer* allocBuffer = AllocBuffer::GetAllocBuffer();
+        if (addr != 0 && allocBuffer != nullptr) {
+            allocBuffer->AccountAllocatedBytes(allocSize);
+            allocBuffer->OnSlowPathAllocated(addr, allocSize);
+        }
+        return addr;
     }
     AllocBuffer* allocBuffer = AllocBuffer::GetOrCreateAllocBuffer();
     return allocBuffer->Allocate(allocSize, allocType);
@@ -118,6 +124,7 @@ void RegionSpace::Init(const HeapParam& vmHeapParam)
 #endif
     Heap::OnHeapCreated(reservedStart);
     Heap::OnHeapExtended(reservedEnd);
+    AllocSampler::Instance().InitFromEnv();
 }
 
 AllocBuffer* AllocBuffer::GetOrCreateAllocBuffer()
@@ -153,12 +160,47 @@ void AllocBuffer::Fini()
     Heap::GetHeap().RemoveAllocBuffer(*this);
 }
 
+void AllocBuffer::OnSlowPathAllocated(MAddress addr, size_t size)
+{
+    if (LIKELY(!AllocSampler::IsSampling()) || addr == 0 || IsGcThread()) {
+        return;
+    }
+    BaseObject* obj = reinterpret_cast<BaseObject*>(addr + Allocator::HEADER_SIZE);
+    AllocSampler::Instance().OnSlowPathAllocation(*this, obj, size);
+}
+
+size_t AllocBuffer::TakeSampleWeight(size_t size, uint32_t session)
+{
+    size_t allocated = GetAllocatedBytes();
+    if (UNLIKELY(bytesUntilSample == 0 || sampleSession != session)) {
+        // bytes allocated before sampling started are not counted.
+        sampleSession = session;
+        sampleMarkBytes = allocated - std::min(allocated, size);
+        bytesSinceSample = 0;
+        bytesUntilSample = AllocSampler::Instance().NextSampleDistance();
+    }
+    size_t bytes = allocated - sampleMarkBytes;
+    sampleMarkBytes = allocated;
+    bytesSinceSample += bytes;
+    if (LIKELY(bytes < bytesUntilSample)) {
+        bytesUntilSample -= bytes;
+        return 0;
+    }
+    // the distance is exponentially distributed thus memoryless, so the remainder is dropped.
+    size_t weight = bytesSinceSample;
+    bytesSinceSample = 0;
+    bytesUntilSample = AllocSampler::Instance().NextSampleDistance();
+    return weight;
+}
+
 MAddress AllocBuffer::Allocate(size_t totalSize, AllocType allocType)
 {
     // a hoisted specific fast path which can be inlined
     MAddress addr = 0;
     if (UNLIKELY(allocType == AllocType::RAW_POINTER_OBJECT)) {
-        return AllocateRawPointerObject(totalSize);
+        addr = AllocateRawPointerObject(totalSize);
+        OnSlowPathAllocated(addr, totalSize);
+        return addr;
     }
 
     if (LIKELY(tlRegion != RegionInfo::NullRegion())) {
@@ -167,6 +209,7 @@ MAddress AllocBuffer::Allocate(size_t totalSize, AllocType allocType)
 
     if (UNLIKELY(addr == 0)) {
         addr = AllocateImpl(totalSize, allocType);
+        OnSlowPathAllocated(addr, totalSize);
     }
 
     DLOG(ALLOC, "alloc 0x%zx(%zu)", addr, totalSize);
@@ -189,6 +232,7 @@ MAddress AllocBuffer::AllocateImpl(size_t totalSize, AllocType allocType)
         // allocation failed because region is full.
         CHECK(tlRegion->IsThreadLocalRegion());
         {
+            AccountRegionBytes(tlRegion);
             manager.RemoveThreadLocalRegion(tlRegion);
             manager.EnlistFullThreadLocalRegion(tlRegion);
             tlRegion = RegionInfo::NullRegion();
@@ -232,6 +276,7 @@ MAddress AllocBuffer::AllocateImpl(size_t totalSize, AllocType allocType)
         return addr;
     }
     // tlRegion is not enough for allocation, so we use r.
+    AccountRegionBytes(tlRegion);
     manager.RemoveThreadLocalRegion(tlRegion);
     manager.EnlistFullThreadLocalRegion(tlRegion);
     tlRegion = r;
@@ -244,6 +289,7 @@ MAddress AllocBuffer::AllocateRawPointerObject(size_t totalSize)
     if (region != nullptr) {
         MAddress allocAddr = region->Alloc(totalSize);
         if (allocAddr != 0) {
+            AccountAllocatedBytes(totalSize);
             return allocAddr;
         }
     }
@@ -266,6 +312,7 @@ MAddress AllocBuffer::AllocateRawPointerObject(size_t totalSize)
     // region is enough for totalSize.
     MAddress allocAddr = region->Alloc(totalSize);
     MRT_ASSERT(allocAddr != 0, "allocation failure");
+    AccountAllocatedBytes(totalSize);
     return allocAddr;
 }
 
@@ -309,6 +356,7 @@ void AllocBuffer::FlushRegion()
     if (LIKELY(tlRegion != RegionInfo::NullRegion()) && tlRegion != nullptr) {
         RegionSpace& theAllocator = reinterpret_cast<RegionSpace&>(Heap::GetHeap().GetAllocator());
         RegionManager& manager = theAllocator.GetRegionManager();
+        AccountRegionBytes(tlRegion);
         manager.RemoveThreadLocalRegion(tlRegion);
         manager.EnlistFullThreadLocalRegion(tlRegion);
         tlRegion = RegionInfo::NullRegion();
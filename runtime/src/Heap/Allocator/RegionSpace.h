@@ -107,7 +107,7 @@ public:
 
         MRT_PHASE_TIMER("ReleaseGarbageMemory");
         if (releaseAll) {
-            return regionManager.ReleaseGarbageRegions(0);
+            return regionManager.ReleaseAllGarbageRegions();
         } else {
             size_t dirtyHeapAfter = regionManager.GetDirtyUnitCount() * RegionInfo::UNIT_SIZE;
             // estimation of additional heap memory that was used since last GC
@@ -124,6 +124,19 @@ public:
             return regionManager.ReleaseGarbageRegions(targetCachedSize);
         }
     }
+
+    size_t ScavengeGarbageMemory() override
+    {
+        MRT_PHASE_TIMER("ScavengeGarbageMemory");
+        return regionManager.ScavengeGarbageRegions();
+    }
+
+    bool HasScavengeableMemory() const override
+    {
+        return regionManager.IsScavengeEnabled() &&
+            (regionManager.GetDirtyUnitCount() != 0 || regionManager.GetLazyReleasedUnitCount() != 0);
+    }
+
 #if defined(__EULER__)
     void TryReclaimGarbageMemory() override
     {
@@ -171,9 +184,9 @@ public:
         regionManager.ForwardFromRegions(threadPool);
     }
 
-    size_t CollectLargeGarbage() { return regionManager.CollectLargeGarbage(); }
+    size_t CollectLargeGarbage(GCThreadPool* threadPool) { return regionManager.CollectLargeGarbage(threadPool); }
 
-    size_t CollectPinnedGarbage() { return regionManager.CollectPinnedGarbage(); }
+    size_t CollectPinnedGarbage(GCThreadPool* threadPool) { return regionManager.CollectPinnedGarbage(threadPool); }
 
     void CollectFromSpaceGarbage()
     {
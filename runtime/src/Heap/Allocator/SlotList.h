@@ -9,6 +9,7 @@
 #define MRT_SLOT_LIST_H
 
 #include "Common/BaseObject.h"
+#include "Sync/Sync.h"
 
 namespace MapleRuntime {
 struct ObjectSlot {
@@ -23,7 +24,11 @@ public:
         ObjectSlot* headSlot = reinterpret_cast<ObjectSlot*>(slot);
         ClearExtraContent(slot);
         headSlot->next = head;
+        if (head == nullptr) {
+            tail = headSlot;
+        }
         head = headSlot;
+        ++count;
     }
 
     uintptr_t PopFront(size_t size)
@@ -33,11 +38,67 @@ public:
         }
         ObjectSlot* allocSlot = head;
         head = head->next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        --count;
         allocSlot->next = nullptr;
         return reinterpret_cast<uintptr_t>(allocSlot);
     }
 
-    void Clear() { head = nullptr; }
+    // move at most n slots from the front of this list to the front of dst, slots are not cleared again.
+    size_t TransferTo(SlotList& dst, size_t n)
+    {
+        if (head == nullptr || n == 0) {
+            return 0;
+        }
+        ObjectSlot* first = head;
+        ObjectSlot* last = head;
+        size_t moved = 1;
+        while (moved < n && last->next != nullptr) {
+            last = last->next;
+            ++moved;
+        }
+        head = last->next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        count -= moved;
+
+        last->next = dst.head;
+        if (dst.head == nullptr) {
+            dst.tail = last;
+        }
+        dst.head = first;
+        dst.count += moved;
+        return moved;
+    }
+
+    // prepend all slots of other to this list in O(1), other is empty afterwards.
+    void Splice(SlotList& other)
+    {
+        if (other.head == nullptr) {
+            return;
+        }
+        other.tail->next = head;
+        if (head == nullptr) {
+            tail = other.tail;
+        }
+        head = other.head;
+        count += other.count;
+        other.Clear();
+    }
+
+    bool IsEmpty() const { return head == nullptr; }
+
+    size_t GetCount() const { return count; }
+
+    void Clear()
+    {
+        head = nullptr;
+        tail = nullptr;
+        count = 0;
+    }
 
     // Clear the rest memory of slot object if the slot object size is greater than ObjectSlot(16 Bytes).
     void ClearExtraContent(BaseObject* slot)
@@ -51,6 +112,63 @@ public:
 
 private:
     ObjectSlot* head = nullptr;
+    ObjectSlot* tail = nullptr;
+    size_t count = 0;
+};
+
+// free slots of reclaimed pinned objects, segregated by size class.
+struct FreePinnedSlotLists {
+    static constexpr size_t ATOMIC_OBJECT_SIZE = 16;
+    static constexpr size_t SYNC_OBJECT_SIZE = CJFuture::SYNC_OBJECT_SIZE;
+    SlotList freeAtomicSlotList;
+    SlotList freeSyncSlotList;
+
+    static bool IsSlotSize(size_t size) { return size == ATOMIC_OBJECT_SIZE || size == SYNC_OBJECT_SIZE; }
+
+    SlotList* GetSlotList(size_t size)
+    {
+        switch (size) {
+            case ATOMIC_OBJECT_SIZE:
+                return &freeAtomicSlotList;
+            case SYNC_OBJECT_SIZE:
+                return &freeSyncSlotList;
+            default:
+                return nullptr;
+        }
+    }
+
+    uintptr_t PopFront(size_t size)
+    {
+        SlotList* list = GetSlotList(size);
+        return list == nullptr ? 0 : list->PopFront(size);
+    }
+
+    void PushFront(BaseObject* slot)
+    {
+        SlotList* list = GetSlotList(slot->GetSize());
+        if (list != nullptr) {
+            list->PushFront(slot);
+        }
+    }
+
+    // move at most n slots of the given size class to dst.
+    size_t TransferTo(FreePinnedSlotLists& dst, size_t size, size_t n)
+    {
+        SlotList* src = GetSlotList(size);
+        return src == nullptr ? 0 : src->TransferTo(*dst.GetSlotList(size), n);
+    }
+
+    void Splice(FreePinnedSlotLists& other)
+    {
+        freeAtomicSlotList.Splice(other.freeAtomicSlotList);
+        freeSyncSlotList.Splice(other.freeSyncSlotList);
+    }
+
+    void Clear()
+    {
+        freeAtomicSlotList.Clear();
+        freeSyncSlotList.Clear();
+    }
 };
 } // namespace MapleRuntime
 #endif // MRT_SLOT_LIST_H
\ No newline at end of file
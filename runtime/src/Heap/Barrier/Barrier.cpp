@@ -6,6 +6,7 @@
 
 
 #include "Barrier.inline.h"
+#include "Common/BaseObject.inline.h"
 #include "Heap/Collector/Collector.h"
 #include "Heap/Heap.h"
 #include "ObjectModel/Field.inline.h"
@@ -178,7 +179,7 @@ void Barrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_t siz
     size_t dstSize = size;
     size_t srcSize = size;
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [this, obj](RefField<false>& field) {
                 // MAddress bias = reinterpret_cast<MAddress>(&field) - reinterpret_cast<MAddress>(src);
                 // RefField<false>* dstField = reinterpret_cast<RefField<false>*>(dst + bias);
@@ -200,7 +201,7 @@ void Barrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, const GC
     size_t srcSize = size;
     CHECK_DETAIL(memcpy_s(reinterpret_cast<void*>(dst), dstSize, reinterpret_cast<void*>(src), srcSize) == EOK,
                  "read struct memcpy_s failed");
-    gctib.ForEachBitmapWord(dst, [this](RefField<>& refField) {
+    gctib.ForEachRef(dst, [this](RefField<>& refField) {
         BaseObject* toVersion = nullptr;
         theCollector.TryUpdateRefField(nullptr, refField, toVersion);
     });
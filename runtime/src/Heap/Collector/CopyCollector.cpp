@@ -45,7 +45,8 @@ void CopyCollector::RunGarbageCollection(uint64_t gcIndex, GCReason reason)
 
     gcReason = reason;
     PreGarbageCollection(true);
-    ScheduleTraceEvent(TRACE_EV_GC_START, -1, nullptr, 0);
+    ScheduleTraceEvent(TRACE_EV_GC_START, -1, nullptr, TRACE_ARGS_2, static_cast<unsigned long long>(gcIndex),
+                       static_cast<unsigned long long>(reason));
     VLOG(REPORT, "[GC] Start %s %s gcIndex= %lu", GetCollectorName(), g_gcRequests[gcReason].name, gcIndex);
     GCStats& gcStats = GetGCStats();
     gcStats.collectedBytes = 0;
@@ -61,7 +62,8 @@ void CopyCollector::RunGarbageCollection(uint64_t gcIndex, GCReason reason)
     gcStats.gcEndTime = TimeUtil::NanoSeconds();
     UpdateGCStats();
     uint64_t gcTimeNs = gcStats.gcEndTime - gcStats.gcStartTime;
-    ScheduleTraceEvent(TRACE_EV_GC_DONE, -1, nullptr, 0);
+    ScheduleTraceEvent(TRACE_EV_GC_DONE, -1, nullptr, TRACE_ARGS_1,
+                       static_cast<unsigned long long>(gcStats.collectedBytes));
     double rate = (static_cast<double>(gcStats.collectedBytes) / gcTimeNs) * (static_cast<double>(NS_PER_S) / MB);
     VLOG(REPORT, "total gc time: %s us, collection rate %.3lf MB/s\n", Pretty(gcTimeNs / NS_PER_US).Str(), rate);
     g_gcCount++;
@@ -76,6 +76,7 @@ FinalizerProcessor::FinalizerProcessor()
     hasFinalizableJob.store(false, std::memory_order_relaxed);
     shouldReclaimHeapGarbage.store(false, std::memory_order_relaxed);
     shouldFeedHungryBuffers.store(false, std::memory_order_relaxed);
+    shouldReleaseHeapGarbage.store(false, std::memory_order_relaxed);
 }
 
 void FinalizerProcessor::Run()
@@ -86,13 +87,18 @@ void FinalizerProcessor::Run()
         bool hasPendingFinalizableJob = false;
         bool hasPendingReclaimHeapGarbage = false;
         bool hasPendingFeedHungryBuffers = false;
+        bool hasPendingReleaseHeapGarbage = false;
+        bool hasPendingScavengeHeapGarbage = false;
         {
             MRT_PHASE_TIMER("finalizerProcessor waitting time", FINALIZE);
             while (running) {
                 hasPendingFinalizableJob = hasFinalizableJob.load(std::memory_order_relaxed);
                 hasPendingReclaimHeapGarbage = shouldReclaimHeapGarbage.load(std::memory_order_relaxed);
                 hasPendingFeedHungryBuffers = shouldFeedHungryBuffers.load(std::memory_order_relaxed);
-                if (hasPendingFinalizableJob || hasPendingReclaimHeapGarbage || hasPendingFeedHungryBuffers) {
+                hasPendingReleaseHeapGarbage = shouldReleaseHeapGarbage.load(std::memory_order_relaxed);
+                hasPendingScavengeHeapGarbage = ShouldScavengeHeapGarbage();
+                if (hasPendingFinalizableJob || hasPendingReclaimHeapGarbage || hasPendingFeedHungryBuffers ||
+                    hasPendingReleaseHeapGarbage || hasPendingScavengeHeapGarbage) {
                     break;
                 }
                 Wait(iterationWaitTime);
@@ -123,6 +129,10 @@ void FinalizerProcessor::Run()
         if (hasPendingReclaimHeapGarbage) {
             ReclaimHeapGarbage();
         }
+
+        if (hasPendingReleaseHeapGarbage || hasPendingScavengeHeapGarbage) {
+            ScavengeHeapGarbage(hasPendingReleaseHeapGarbage);
+        }
     }
     Fini();
 }
@@ -268,7 +278,10 @@ void FinalizerProcessor::ProcessFinalizables()
         workingFinalizables.swap(finalizables);
     }
     DLOG(FINALIZE, "finalizer: working size %zu", workingFinalizables.size());
+    ScheduleTraceEvent(TRACE_EV_FINALIZER_START, -1, nullptr, TRACE_ARGS_1,
+                       static_cast<unsigned long long>(workingFinalizables.size()));
     ProcessFinalizableList();
+    ScheduleTraceEvent(TRACE_EV_FINALIZER_DONE, -1, nullptr, TRACE_ARGS_0);
     if (finalizables.empty()) {
         hasFinalizableJob.store(false, std::memory_order_relaxed);
     }
@@ -334,6 +347,28 @@ void FinalizerProcessor::ReclaimHeapGarbage()
     shouldReclaimHeapGarbage.store(false, std::memory_order_relaxed);
 }
 
+// scavenging is checked once per wait iteration, and only runs when there is dirty heap memory to return.
+bool FinalizerProcessor::ShouldScavengeHeapGarbage()
+{
+    uint64_t now = TimeUtil::NanoSeconds();
+    if (now - lastScavengeTime < static_cast<uint64_t>(iterationWaitTime) * 1000 * 1000) { // 1000 * 1000: ms to ns
+        return false;
+    }
+    lastScavengeTime = now;
+    return Heap::GetHeap().GetAllocator().HasScavengeableMemory();
+}
+
+void FinalizerProcessor::ScavengeHeapGarbage(bool releaseAll)
+{
+    ScopedEntryTrace trace("CJRT_GC_SCAVENGE");
+    if (releaseAll) {
+        shouldReleaseHeapGarbage.store(false, std::memory_order_relaxed);
+        Heap::GetHeap().GetAllocator().ReclaimGarbageMemory(true);
+    } else {
+        Heap::GetHeap().GetAllocator().ScavengeGarbageMemory();
+    }
+}
+
 void FinalizerProcessor::FeedHungryBuffers()
 {
     Heap::GetHeap().GetAllocator().FeedHungryBuffers();
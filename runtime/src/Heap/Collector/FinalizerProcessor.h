@@ -85,6 +85,12 @@ public:
     Mutator* GetMutator() const { return fpMutator; }
 
     void NotifyToReclaimGarbage() { shouldReclaimHeapGarbage.store(true); }
+    // memory pressure is reported, release all free heap memory without waiting for scavenging.
+    void NotifyToReleaseGarbage()
+    {
+        shouldReleaseHeapGarbage.store(true, std::memory_order_release);
+        Notify();
+    }
     void NotifyToFeedAllocBuffers()
     {
         shouldFeedHungryBuffers.store(true, std::memory_order_release);
@@ -99,6 +105,8 @@ private:
     void ProcessFinalizableList();
     void ReclaimHeapGarbage();
     void FeedHungryBuffers();
+    bool ShouldScavengeHeapGarbage();
+    void ScavengeHeapGarbage(bool releaseAll);
 
     std::mutex wakeLock;
     std::condition_variable wakeCondition; // notify finalizer processing continue
@@ -123,6 +131,8 @@ private:
     std::atomic<bool> hasFinalizableJob;
     std::atomic<bool> shouldReclaimHeapGarbage;
     std::atomic<bool> shouldFeedHungryBuffers;
+    std::atomic<bool> shouldReleaseHeapGarbage;
+    uint64_t lastScavengeTime = 0;
 #if defined(MRT_DEBUG) && (MRT_DEBUG == 1)
     // stats
     void LogAfterProcess();
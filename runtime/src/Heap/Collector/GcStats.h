@@ -72,5 +72,7 @@ public:
 extern size_t g_gcCount;
 extern uint64_t g_gcTotalTimeUs;
 extern size_t g_gcCollectedTotalBytes;
+// total time when the world is stopped, which is updated while holding the STW lock.
+extern uint64_t g_stwTotalTimeNs;
 } // namespace MapleRuntime
 #endif // MRT_STATS_H
@@ -332,6 +332,8 @@ protected:
     bool fixReferences = false;
 
     std::atomic<size_t> markedObjectCount = { 0 };
+    // bytes of the objects marked by concurrent marking tasks.
+    std::atomic<size_t> markedByteCount = { 0 };
     std::mutex externMtx;
     std::unordered_map<BaseObject*, std::list<BaseObject*>> discoveredExternObjects;
     std::mutex cycleWorkStackMtx;
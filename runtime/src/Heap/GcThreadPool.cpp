@@ -74,7 +74,7 @@ void* GCPoolThread::WorkerFunc(void* param)
     while (!pool->IsExited()) {
         HeapWork* task = nullptr;
         {
-            std::unique_lock<std::mutex> poolLock(pool->poolMutex);
+            std::unique_lock<std::mutex> poolLock = pool->LockPool();
             // hang up in threadSleepingCondVar when pool stopped or to many active thread
             while (((pool->currActiveThreadNum > pool->maxActiveThreadNum) || !pool->IsRunning()) &&
                    !pool->IsExited()) {
@@ -109,7 +109,7 @@ void* GCPoolThread::WorkerFunc(void* param)
         }
     }
     {
-        std::unique_lock<std::mutex> poolLock(pool->poolMutex);
+        std::unique_lock<std::mutex> poolLock = pool->LockPool();
         --(pool->currActiveThreadNum);
         if (pool->currActiveThreadNum == 0) {
             // all thread sleeping, pool in stop state, notify wait stop thread
@@ -144,7 +144,7 @@ GCThreadPool::GCThreadPool(const char* poolName, int32_t threadNum, int32_t prio
 
 void GCThreadPool::Exit()
 {
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     // set pool exit flag
     exit.store(true, std::memory_order_relaxed);
 
@@ -181,7 +181,7 @@ void GCThreadPool::SetPriority(int32_t prior) const
 
 void GCThreadPool::SetMaxActiveThreadNum(int32_t num)
 {
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     int32_t oldNum = maxActiveThreadNum;
     if (num >= maxThreadNum) {
         maxActiveThreadNum = maxThreadNum;
@@ -200,7 +200,7 @@ void GCThreadPool::SetMaxActiveThreadNum(int32_t num)
 void GCThreadPool::AddWork(HeapWork* task)
 {
     CHECK_DETAIL(task != nullptr, "failed to add a null task");
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     workQueue.push(task);
     // do not notify when pool isn't running, notify_all in start
     // notify if there is active thread waiting for task
@@ -212,7 +212,7 @@ void GCThreadPool::AddWork(HeapWork* task)
 void GCThreadPool::Start()
 {
     // notify all sleeping threads get to work
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     running.store(true, std::memory_order_relaxed);
     threadSleepingCondVar.notify_all();
 }
@@ -223,12 +223,12 @@ void GCThreadPool::DrainWorkQueue()
     HeapWork* task = nullptr;
     do {
         task = nullptr;
-        poolMutex.lock();
+        ContentionProfiler::Lock(poolMutex, LockKind::GC_THREAD_POOL);
         if (!workQueue.empty()) {
             task = workQueue.front();
             workQueue.pop();
         }
-        poolMutex.unlock();
+        ContentionProfiler::Unlock(poolMutex);
         if (task != nullptr) {
             task->Execute(0);
             delete task;
@@ -241,12 +241,12 @@ void GCThreadPool::WaitFinish()
     HeapWork* task = nullptr;
     do {
         task = nullptr;
-        poolMutex.lock();
+        ContentionProfiler::Lock(poolMutex, LockKind::GC_THREAD_POOL);
         if (!workQueue.empty() && IsRunning() && !IsExited()) {
             task = workQueue.front();
             workQueue.pop();
         }
-        poolMutex.unlock();
+        ContentionProfiler::Unlock(poolMutex);
         if (task != nullptr) {
             task->Execute(0);
             delete task;
@@ -257,7 +257,7 @@ void GCThreadPool::WaitFinish()
     // waitingThreadNum == maxActiveThreadNum indicate all work done
     // no need to wait when pool stopped or exited
     {
-        std::unique_lock<std::mutex> poolLock(poolMutex);
+        std::unique_lock<std::mutex> poolLock = LockPool();
         while ((waitingThreadNum != maxActiveThreadNum) && IsRunning() && !IsExited()) {
             allWorkDoneCondVar.wait(poolLock);
         }
@@ -272,7 +272,7 @@ void GCThreadPool::WaitFinish()
 void GCThreadPool::Stop()
 {
     // notify & wait all thread enter stopped state
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     running.store(false, std::memory_order_relaxed);
     taskEmptyCondVar.notify_all();
     while (currActiveThreadNum != 0) {
@@ -282,7 +282,7 @@ void GCThreadPool::Stop()
 
 void GCThreadPool::ClearAllWork()
 {
-    std::unique_lock<std::mutex> poolLock(poolMutex);
+    std::unique_lock<std::mutex> poolLock = LockPool();
     while (!workQueue.empty()) {
         HeapWork* task = workQueue.front();
         workQueue.pop();
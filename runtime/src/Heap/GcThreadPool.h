@@ -18,6 +18,7 @@
 
 #include "Base/LogFile.h"
 #include "Base/Macros.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #include "Heap/HeapWork.h"
 
 // thread pool implementation
@@ -112,7 +113,7 @@ public:
     // Get work count in queue
     size_t GetWorkCount()
     {
-        std::unique_lock<std::mutex> taskLock(poolMutex);
+        std::unique_lock<std::mutex> taskLock = LockPool();
         return workQueue.size();
     }
 
@@ -169,6 +170,14 @@ private:
 
     bool IsExited() const { return exit.load(std::memory_order_relaxed); }
 
+    // acquire poolMutex, whose contention is recorded by lock profiling.
+    std::unique_lock<std::mutex> LockPool()
+    {
+        std::unique_lock<std::mutex> poolLock(poolMutex, std::defer_lock);
+        ContentionProfiler::Lock(poolLock, LockKind::GC_THREAD_POOL);
+        return poolLock;
+    }
+
     friend class GCPoolThread;
 };
 
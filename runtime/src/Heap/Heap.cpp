@@ -207,7 +207,11 @@ void HeapImpl::InstallBarrier(const GCPhase phase)
 
 GCPhase HeapImpl::GetGCPhase() const { return collectorProxy.GetGCPhase(); }
 
-void HeapImpl::SetGCPhase(const GCPhase phase) { collectorProxy.SetGCPhase(phase); }
+void HeapImpl::SetGCPhase(const GCPhase phase)
+{
+    collectorProxy.SetGCPhase(phase);
+    ScheduleTraceEvent(TRACE_EV_GC_PHASE, -1, nullptr, TRACE_ARGS_1, static_cast<unsigned long long>(phase));
+}
 
 size_t HeapImpl::GetMaxCapacity() const { return theSpace->GetMaxCapacity(); }
 
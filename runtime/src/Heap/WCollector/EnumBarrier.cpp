@@ -7,6 +7,7 @@
 
 #include "EnumBarrier.h"
 #include "Heap/Allocator/RegionSpace.h"
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/MArray.h"
 #include "ObjectModel/RefField.inline.h"
@@ -59,7 +60,7 @@ void EnumBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_t
 {
     LocalRefFieldContainer refFields;
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [&refFields, dst, src, size](RefField<false>& field) {
                 if (reinterpret_cast<MAddress>(&field) < src || reinterpret_cast<MAddress>(&field) >= (src + size)) {
                     return;
@@ -85,7 +86,7 @@ void EnumBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_t
 void EnumBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, const GCTib gctib) const
 {
     LocalRefFieldContainer refFields;
-    gctib.ForEachBitmapWordInRange(
+    gctib.ForEachRefInRange(
         src,
         [&refFields, dst, src](RefField<>& srcField) {
             MAddress offset = reinterpret_cast<MAddress>(&srcField) - src;
@@ -142,7 +143,7 @@ void EnumBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen, MAdd
     if (obj != nullptr) {
         MRT_ASSERT(dst > reinterpret_cast<MAddress>(obj), "WriteStruct struct addr is less than obj!");
         Mutator* mutator = Mutator::GetMutator();
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [=](RefField<>& dstField) {
                 mutator->RememberObjectInSatbBuffer(ReadReference(obj, dstField));
                 MAddress offset = reinterpret_cast<MAddress>(&dstField) - dst;
@@ -156,7 +157,7 @@ void EnumBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen, MAdd
                  "memcpy_s failed");
 
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [=](RefField<>& refField) {
                 RefField<> oldField(refField);
                 RefField<> toBeUpdated(oldField);
@@ -178,7 +179,7 @@ void EnumBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen, MAdd
 void EnumBarrier::WriteStaticStruct(MAddress dst, size_t dstLen, MAddress src, size_t srcLen, const GCTib gctib) const
 {
     Mutator* mutator = Mutator::GetMutator();
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& dstField) {
+    gctib.ForEachRef(dst, [=](RefField<>& dstField) {
         mutator->RememberObjectInSatbBuffer(ReadReference(nullptr, dstField));
         uint32_t offset = reinterpret_cast<MAddress>(&dstField) - dst;
         RefField<>* srcField = reinterpret_cast<RefField<>*>(src + offset);
@@ -188,7 +189,7 @@ void EnumBarrier::WriteStaticStruct(MAddress dst, size_t dstLen, MAddress src, s
     CHECK_DETAIL(memcpy_s(reinterpret_cast<void*>(dst), dstLen, reinterpret_cast<void*>(src), srcLen) == EOK,
                  "memcpy_s failed");
 
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& refField) {
+    gctib.ForEachRef(dst, [=](RefField<>& refField) {
         RefField<> oldField(refField);
         RefField<> toBeUpdated(oldField);
         BaseObject* untagged = ReadReference(nullptr, toBeUpdated);
@@ -299,7 +300,7 @@ void EnumBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MIndex
     }
 
     Mutator* mutator = Mutator::GetMutator();
-    RefFieldVisitor srcVisitor = [this, mutator](RefField<false>& field) {
+    auto srcVisitor = [this, mutator](RefField<false>& field) {
         RefField<> oldField(field);
         RefField<> toBeUpdated(oldField);
         BaseObject* target = ReadReference(nullptr, toBeUpdated);
@@ -310,15 +311,15 @@ void EnumBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MIndex
         }
     };
     MArray* srcArray = static_cast<MArray*>(srcObj);
-    srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+    srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
 
-    RefFieldVisitor dstVisitor = [this, mutator](RefField<false>& field) {
+    auto dstVisitor = [this, mutator](RefField<false>& field) {
         RefField<> oldField(field);
         BaseObject* target = ReadReference(nullptr, oldField);
         mutator->RememberObjectInSatbBuffer(target);
     };
     MArray* dstArray = static_cast<MArray*>(dstObj);
-    dstArray->ForEachRefFieldInRange(dstVisitor, dstField, dstField + srcSize);
+    dstArray->ScanRefFieldsInRange(dstVisitor, dstField, dstField + srcSize);
 
     CHECK_DETAIL(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) ==
                      EOK,
@@ -9,6 +9,7 @@
 
 #include "Base/SysCall.h"
 #include "Common/ScopedObjectLock.h"
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/Field.inline.h"
 #include "ObjectModel/MArray.h"
@@ -52,7 +53,7 @@ void ForwardBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, siz
 {
     CHECK(!Heap::IsHeapAddress(dst));
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [this, obj](RefField<false>& field) {
                 BaseObject* target = ReadReference(obj, field);
                 (void)target;
@@ -66,7 +67,7 @@ void ForwardBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, c
 {
     CHECK(!Heap::IsHeapAddress(src));
     CHECK(!Heap::IsHeapAddress(dst));
-    gctib.ForEachBitmapWord(src, [=](RefField<>& srcField) {
+    gctib.ForEachRef(src, [=](RefField<>& srcField) {
         BaseObject* target = ReadReference(nullptr, srcField);
         (void)target;
     });
@@ -162,8 +163,8 @@ void ForwardBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MInd
     }
 
     MArray* srcArray = static_cast<MArray*>(srcObj);
-    RefFieldVisitor srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
-    srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+    auto srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
+    srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
 
     CHECK(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) == EOK);
 
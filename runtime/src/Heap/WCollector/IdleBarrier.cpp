@@ -7,6 +7,7 @@
 
 #include "IdleBarrier.h"
 
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/MArray.h"
 #include "ObjectModel/RefField.inline.h"
@@ -71,7 +72,7 @@ void IdleBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_t
 {
     if (obj != nullptr) {
         // note fix/untag dst would be better.
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [this, obj](RefField<false>& field) {
                 RefField<> oldField(field);
                 BaseObject* target = ReadReference(obj, field);
@@ -88,7 +89,7 @@ void IdleBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, cons
 {
     CHECK_DETAIL(memcpy_s(reinterpret_cast<void*>(dst), size, reinterpret_cast<void*>(src), size) == EOK,
                  "read struct memcpy_s failed");
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& field) {
+    gctib.ForEachRef(dst, [=](RefField<>& field) {
         BaseObject* target = ReadReference(nullptr, field);
         (void)target;
     });
@@ -233,8 +234,8 @@ void IdleBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MIndex
     }
 #endif
     MArray* srcArray = static_cast<MArray*>(srcObj);
-    RefFieldVisitor srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
-    srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+    auto srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
+    srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
 
     CHECK_DETAIL(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) ==
                      EOK,
@@ -7,6 +7,7 @@
 
 #include "PostTraceBarrier.h"
 
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/MArray.h"
 #include "ObjectModel/RefField.inline.h"
@@ -51,7 +52,7 @@ void PostTraceBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, s
 {
     LocalRefFieldContainer refFields;
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [this, obj, &refFields, dst, src, size](RefField<false>& field) {
                 if (reinterpret_cast<MAddress>(&field) < src || reinterpret_cast<MAddress>(&field) >= (src + size)) {
                     return;
@@ -75,7 +76,7 @@ void PostTraceBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, s
 void PostTraceBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, const GCTib gctib) const
 {
     LocalRefFieldContainer refFields;
-    gctib.ForEachBitmapWordInRange(
+    gctib.ForEachRefInRange(
         src,
         [this, &refFields, dst, src](RefField<>& srcField) {
             (void)ReadReference(nullptr, srcField);
@@ -114,7 +115,7 @@ void PostTraceBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen,
     CHECK(memcpy_s(reinterpret_cast<void*>(dst), dstLen, reinterpret_cast<void*>(src), srcLen) == EOK);
 
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [=](RefField<>& refField) {
                 RefField<> oldField(refField);
                 MAddress oldValue = oldField.GetFieldValue();
@@ -138,7 +139,7 @@ void PostTraceBarrier::WriteStaticStruct(MAddress dst, size_t dstLen, MAddress s
 {
     CHECK(memcpy_s(reinterpret_cast<void*>(dst), dstLen, reinterpret_cast<void*>(src), srcLen) == EOK);
 
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& refField) {
+    gctib.ForEachRef(dst, [=](RefField<>& refField) {
         RefField<> oldField(refField);
         MAddress oldValue = oldField.GetFieldValue();
         BaseObject* untagged = ReadReference(nullptr, oldField);
@@ -242,7 +243,7 @@ void PostTraceBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MI
     }
 #endif
     bool inHeap = Heap::IsHeapAddress(srcObj);
-    RefFieldVisitor srcVisitor = [this](RefField<false>& field) {
+    auto srcVisitor = [this](RefField<false>& field) {
         RefField<> oldField(field);
         RefField<> toBeUpdated(oldField);
         BaseObject* target = ReadReference(nullptr, toBeUpdated);
@@ -253,7 +254,7 @@ void PostTraceBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MI
     };
     MArray* srcArray = static_cast<MArray*>(srcObj);
     if (!inHeap) {
-        srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+        srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
     }
     CHECK_DETAIL(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) ==
                      EOK,
@@ -9,6 +9,7 @@
 
 #include "Base/SysCall.h"
 #include "Common/ScopedObjectLock.h"
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/Field.inline.h"
 #include "ObjectModel/MArray.h"
@@ -54,7 +55,7 @@ void PreforwardBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src,
 {
     if (obj != nullptr) {
         // note fix/untag dst would be better.
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [this, obj](RefField<false>& field) {
                 RefField<> oldField(field);
                 BaseObject* target = ReadReference(obj, field);
@@ -71,7 +72,7 @@ void PreforwardBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size
 {
     CHECK_DETAIL(memcpy_s(reinterpret_cast<void*>(dst), size, reinterpret_cast<void*>(src), size) == EOK,
                  "read struct memcpy_s failed");
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& field) {
+    gctib.ForEachRef(dst, [=](RefField<>& field) {
         RefField<> oldField(field);
         BaseObject* target = ReadReference(nullptr, field);
         (void)target;
@@ -175,8 +176,8 @@ void PreforwardBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, M
     }
 
     MArray* srcArray = static_cast<MArray*>(srcObj);
-    RefFieldVisitor srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
-    srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+    auto srcVisitor = [this, srcArray](RefField<false>& field) { (void)ReadReference(srcArray, field); };
+    srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
 
     CHECK(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) == EOK);
 
@@ -7,6 +7,7 @@
 
 #include "TraceBarrier.h"
 #include "Heap/Allocator/RegionSpace.h"
+#include "Common/BaseObject.inline.h"
 #include "Mutator/Mutator.h"
 #include "ObjectModel/MArray.h"
 #include "ObjectModel/RefField.inline.h"
@@ -58,7 +59,7 @@ void TraceBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_
 {
     LocalRefFieldContainer refFields;
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [&refFields, dst, src, size](RefField<false>& field) {
                 if (reinterpret_cast<MAddress>(&field) < src || reinterpret_cast<MAddress>(&field) >= (src + size)) {
                     return;
@@ -83,7 +84,7 @@ void TraceBarrier::ReadStruct(MAddress dst, BaseObject* obj, MAddress src, size_
 void TraceBarrier::ReadStaticStruct(MAddress dst, MAddress src, size_t size, const GCTib gctib) const
 {
     LocalRefFieldContainer refFields;
-    gctib.ForEachBitmapWordInRange(src, [&refFields, dst, src](RefField<>& srcField) {
+    gctib.ForEachRefInRange(src, [&refFields, dst, src](RefField<>& srcField) {
         MAddress offset = reinterpret_cast<MAddress>(&srcField) - src;
         refFields.Push(reinterpret_cast<RefField<>*>(dst + offset));
     }, src, src + size);
@@ -138,7 +139,7 @@ void TraceBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen, MAd
         MRT_ASSERT(dst > reinterpret_cast<MAddress>(obj), "WriteStruct struct addr is less than obj!");
         Mutator* mutator = Mutator::GetMutator();
         if (mutator != nullptr) {
-            obj->ForEachRefInStruct(
+            obj->ScanRefsInStruct(
                 [=](RefField<>& refField) {
                     mutator->RememberObjectInSatbBuffer(ReadReference(obj, refField));
                 },
@@ -149,7 +150,7 @@ void TraceBarrier::WriteStruct(BaseObject* obj, MAddress dst, size_t dstLen, MAd
     CHECK(memcpy_s(reinterpret_cast<void*>(dst), dstLen, reinterpret_cast<void*>(src), srcLen) == EOK);
 
     if (obj != nullptr) {
-        obj->ForEachRefInStruct(
+        obj->ScanRefsInStruct(
             [=](RefField<>& refField) {
                 RefField<> oldField(refField);
                 MAddress oldValue = oldField.GetFieldValue();
@@ -173,7 +174,7 @@ void TraceBarrier::WriteStaticStruct(MAddress dst, size_t dstLen, MAddress src,
     std::atomic_thread_fence(std::memory_order_seq_cst);
     CHECK(memcpy_s(reinterpret_cast<void*>(dst), dstLen, reinterpret_cast<void*>(src), srcLen) == EOK);
 
-    gctib.ForEachBitmapWord(dst, [=](RefField<>& refField) {
+    gctib.ForEachRef(dst, [=](RefField<>& refField) {
         RefField<> oldField(refField);
         MAddress oldValue = oldField.GetFieldValue();
         BaseObject* untagged = ReadReference(nullptr, oldField);
@@ -274,7 +275,7 @@ void TraceBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MIndex
     }
 #endif
     Mutator* mutator = Mutator::GetMutator();
-    RefFieldVisitor srcVisitor = [this](RefField<false>& field) {
+    auto srcVisitor = [this](RefField<false>& field) {
         RefField<> oldField(field);
         RefField<> toBeUpdated(oldField);
         BaseObject* target = ReadReference(nullptr, toBeUpdated);
@@ -284,15 +285,15 @@ void TraceBarrier::CopyStructArray(BaseObject* dstObj, MAddress dstField, MIndex
         }
     };
     MArray* srcArray = static_cast<MArray*>(srcObj);
-    srcArray->ForEachRefFieldInRange(srcVisitor, srcField, srcField + srcSize);
+    srcArray->ScanRefFieldsInRange(srcVisitor, srcField, srcField + srcSize);
 
-    RefFieldVisitor dstVisitor = [this, mutator](RefField<false>& field) {
+    auto dstVisitor = [this, mutator](RefField<false>& field) {
         RefField<> oldField(field);
         BaseObject* target = ReadReference(nullptr, oldField);
         mutator->RememberObjectInSatbBuffer(target);
     };
     MArray* dstArray = static_cast<MArray*>(dstObj);
-    dstArray->ForEachRefFieldInRange(dstVisitor, dstField, dstField + srcSize);
+    dstArray->ScanRefFieldsInRange(dstVisitor, dstField, dstField + srcSize);
 
     CHECK_DETAIL(memmove_s(reinterpret_cast<void*>(dstField), dstSize, reinterpret_cast<void*>(srcField), srcSize) ==
                      EOK,
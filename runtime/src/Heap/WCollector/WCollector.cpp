@@ -7,6 +7,8 @@
 
 #include "WCollector.h"
 
+#include "Allocator/AllocSampler.h"
+#include "Common/BaseObject.inline.h"
 #include "Concurrency/Concurrency.h"
 #include "Mutator/MutatorManager.h"
 
@@ -235,7 +237,7 @@ void WCollector::TraceObjectRefFields(BaseObject* obj, WorkStack& workStack)
 {
     auto refFunc = [this, obj, &workStack](RefField<>& field) { TraceRefField(obj, field, workStack); };
 
-    obj->ForEachRefField(refFunc);
+    obj->ScanRefFields(refFunc);
 }
 
 BaseObject* WCollector::GetAndTryTagObj(BaseObject* obj, RefField<>& field)
@@ -309,6 +311,12 @@ void WCollector::PreforwardFinalizerProcessorRoots()
     collectorResources.GetFinalizerProcessor().VisitRawPointers(visitor);
 }
 
+void WCollector::PreforwardAllocSamples()
+{
+    RootVisitor visitor = [this](ObjectRef& root) { ForwardUpdateRawRef(root); };
+    AllocSampler::Instance().VisitRawPointers(visitor);
+}
+
 void WCollector::PreforwardConcurrencyModelRoots()
 {
     RootVisitor visitor = [this](ObjectRef& root) { ForwardUpdateRawRef(root); };
@@ -373,21 +381,29 @@ void WCollector::TraceHeap()
     WorkStack foreignStack = NewWorkStack();
     // assemble garbage candidates for tracing.
     reinterpret_cast<RegionSpace&>(theAllocator).AssembleGarbageCandidates();
+    AllocSampler::Instance().OnTraceStart();
 
     {
         MRT_PHASE_TIMER("enum roots & update old pointers within");
+        Mutator::StackScanStats& stackStats = Mutator::GetStackScanStats();
+        stackStats.Reset();
         TransitionToGCPhase(GCPhase::GC_PHASE_ENUM, true);
         DoEnumeration(workStack, foreignStack);
+        VLOG(REPORT, "stack roots: unwound %zu stacks (%zu frames, %zu B), reused %zu parked stacks (%zu frames, %zu B)",
+             stackStats.unwoundStacks.load(), stackStats.unwoundFrames.load(), stackStats.unwoundBytes.load(),
+             stackStats.reusedStacks.load(), stackStats.reusedFrames.load(), stackStats.reusedBytes.load());
     }
 
     {
         MRT_PHASE_TIMER("trace live objects & update old pointers in ref-fields");
         markedObjectCount.store(0, std::memory_order_relaxed);
+        markedByteCount.store(0, std::memory_order_relaxed);
         TransitionToGCPhase(GCPhase::GC_PHASE_TRACE, true);
         reinterpret_cast<RegionSpace&>(theAllocator).PrepareTrace();
         DoTracing(workStack, foreignStack);
 
         ProcessFinalizers();
+        AllocSampler::Instance().SweepSamples([this](const BaseObject* obj) { return IsSurvivedObject(obj); });
     }
 }
 
@@ -424,6 +440,7 @@ void WCollector::Preforward()
 
     // forward and fix finalizer roots.
     threadPool->AddWork(new (std::nothrow) LambdaWork([this](size_t) { PreforwardFinalizerProcessorRoots(); }));
+    threadPool->AddWork(new (std::nothrow) LambdaWork([this](size_t) { PreforwardAllocSamples(); }));
     threadPool->AddWork(new (std::nothrow) LambdaWork([this](size_t) { PreforwardAllExportFromRoots(); }));
     threadPool->AddWork(new (std::nothrow) LambdaWork([this](size_t) { PreforwardDiscoveredExternObjects(); }));
     threadPool->AddWork(new (std::nothrow) LambdaWork([this](size_t) { PreforwardAllResurrectExportFromObjects(); }));
@@ -170,16 +170,17 @@ protected:
         RegionSpace& space = reinterpret_cast<RegionSpace&>(theAllocator);
         GCStats& stats = GetGCStats();
         stats.largeSpaceSize = space.LargeObjectBytes();
-        stats.largeGarbageSize = space.CollectLargeGarbage();
+        stats.largeGarbageSize = space.CollectLargeGarbage(GetThreadPool());
         stats.collectedBytes += stats.largeGarbageSize;
     }
 
     void CollectPinnedGarbage()
     {
+        MRT_PHASE_TIMER("Collect pinned garbage");
         RegionSpace& space = reinterpret_cast<RegionSpace&>(theAllocator);
         GCStats& stats = GetGCStats();
         stats.pinnedSpaceSize = space.PinnedSpaceSize();
-        stats.pinnedGarbageSize = space.CollectPinnedGarbage();
+        stats.pinnedGarbageSize = space.CollectPinnedGarbage(GetThreadPool());
         stats.collectedBytes += stats.pinnedGarbageSize;
     }
 
@@ -198,6 +199,7 @@ private:
     void Preforward();
     void PreforwardAllExportFromRoots();
     void PreforwardFinalizerProcessorRoots();
+    void PreforwardAllocSamples();
     void PreforwardDiscoveredExternObjects();
     void PreforwardAllResurrectExportFromObjects();
     CrossRefHandler GetCrossRefHandler(BaseObject* foreignProxy);
@@ -6,7 +6,9 @@
 
 
 #include "CjAllocData.h"
+#include <fcntl.h>
 #include <iostream>
+#include <unistd.h>
 #include <chrono>
 #include <Common/ScopedObjectAccess.h>
 #include <chrono>
@@ -60,6 +62,7 @@ void CjAllocData::DeleteCjAllocData()
     HeapProfilerStream* stream = &MapleRuntime::HeapProfilerStream::GetInstance();
     stream->SetContext(ALLOCATION);
     g_allocInfo->SerializeCjAllocData();
+    g_allocInfo->ExportProfileFromEnv();
     for (auto sample:g_allocInfo->samples) {
         delete sample;
         sample = nullptr;
@@ -75,6 +78,61 @@ void CjAllocData::DeleteCjAllocData()
     delete g_allocInfo->writer;
 }
 
+bool CjAllocData::WriteProfile(ProfileWriter& profileWriter)
+{
+    profileWriter.Begin({ { "alloc_objects", "count" }, { "alloc_space", "bytes" } }, 1, { "space", "bytes" },
+                        sampSize);
+    std::unordered_map<int32_t, int64_t> sampleCounts;
+    for (auto sample : samples) {
+        sampleCounts[sample->nodeId]++;
+    }
+    std::vector<uint64_t> path;
+    if (traceNodeHead != nullptr) {
+        // {root} is not a frame of the trace.
+        for (auto child : traceNodeHead->children) {
+            WriteTraceNode(profileWriter, child, path, sampleCounts);
+        }
+    }
+    return profileWriter.Finish();
+}
+
+void CjAllocData::WriteTraceNode(ProfileWriter& profileWriter, TraceNodeField* node, std::vector<uint64_t>& path,
+                                 const std::unordered_map<int32_t, int64_t>& sampleCounts)
+{
+    const TraceFunctionInfo* info = traceFunctionInfo[node->functionInfoIndex];
+    // path is root first.
+    path.push_back(profileWriter.InternFrame(info->functionName, info->scriptName, info->line));
+    auto count = sampleCounts.find(node->id);
+    if (node->selfSize > 0 || count != sampleCounts.end()) {
+        std::vector<uint64_t> frames(path.rbegin(), path.rend());
+        profileWriter.AddSample(frames, { count == sampleCounts.end() ? 0 : count->second, node->selfSize });
+    }
+    for (auto child : node->children) {
+        WriteTraceNode(profileWriter, child, path, sampleCounts);
+    }
+    path.pop_back();
+}
+
+void CjAllocData::ExportProfileFromEnv()
+{
+    auto path = std::getenv("cjAllocTraceProfilePath");
+    if (path == nullptr) {
+        return;
+    }
+    ProfileFormat format = ProfileWriter::FormatFromEnv();
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+    if (fd < 0) {
+        LOG(RTLOG_ERROR, "Open %s failed. msg: %s", path, strerror(errno));
+        return;
+    }
+    std::unique_ptr<ProfileWriter> profileWriter =
+        ProfileWriter::Create(format == ProfileFormat::NATIVE ? ProfileFormat::PPROF : format, fd);
+    if (!WriteProfile(*profileWriter)) {
+        LOG(RTLOG_ERROR, "Write allocation trace profile failed.");
+    }
+    close(fd);
+}
+
 void CjAllocData::DeleteAllNode(TraceNodeField* node)
 {
     for (size_t i = 0; i < node->children.size(); i++) {
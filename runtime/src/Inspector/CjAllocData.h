@@ -10,6 +10,7 @@
 #include "UnwindStack/GcStackInfo.h"
 #include "CjHeapData.h"
 #include "HeapSnapshotJsonSerializer.h"
+#include "CpuProfiler/ProfileWriter.h"
 namespace MapleRuntime {
 struct TraceFunctionInfo {
     CString functionName;
@@ -52,9 +53,17 @@ public:
     void InitAllocParam();
     void InitRoot();
     void RecordAllocNodes(const TypeInfo* ti, MSize size);
+    // write the allocation trace tree as stacks valued by sampled allocations and their bytes.
+    bool WriteProfile(ProfileWriter& profileWriter);
+    // when cjAllocTraceProfilePath is set, the trace is also written to that file in cjProfileFormat, which is
+    // pprof by default, before it is deleted.
+    void ExportProfileFromEnv();
     int32_t SetNodeID() { return ++traceNodeID;};
     friend class AllocStackInfo;
 private:
+    void WriteTraceNode(ProfileWriter& profileWriter, TraceNodeField* node, std::vector<uint64_t>& path,
+                        const std::unordered_map<int32_t, int64_t>& sampleCounts);
+
     std::unordered_map<int32_t, TraceNodeField*> traceNodeMap;
     TraceNodeField* traceNodeHead; // ROOT node
     std::vector<Sample*> samples;
@@ -79,9 +79,41 @@ void CjHeapData::ProcessHeap()
     (void)LookupStringId("RefFields");
     (void)LookupStringId("ValueField");
     //  dump object contents
-    auto dumpVisitor = [this](BaseObject* obj) { ProcessHeapObject(obj); };
+    auto dumpVisitor = [this](BaseObject* obj) {
+        ProcessHeapObject(obj);
+        CountObjectHeader(obj);
+    };
     bool ret = Heap::GetHeap().ForEachObj(dumpVisitor, false);
     CHECK_E(UNLIKELY(!ret), "theAllocator.ForEachObj() in DumpHeap() return false.");
+    ReportHeaderStats();
+}
+
+void CjHeapData::CountObjectHeader(BaseObject* obj)
+{
+    if (obj == nullptr) {
+        return;
+    }
+    size_t size = obj->GetSize();
+    // objects are 8-byte aligned, so both footprints are compared after alignment: a compact header saves memory only
+    // if the rest of the object fits in less words.
+    size_t footprint = AlignUp<size_t>(size, Allocator::ALLOC_ALIGN);
+    size_t compactSize = AlignUp<size_t>(size - TYPEINFO_PTR_SIZE + COMPACT_HEADER_SIZE, Allocator::ALLOC_ALIGN);
+    headerStats.objectCount++;
+    headerStats.objectBytes += footprint;
+    headerStats.headerBytes += TYPEINFO_PTR_SIZE;
+    headerStats.compactHeaderSavedBytes += footprint > compactSize ? footprint - compactSize : 0;
+}
+
+void CjHeapData::ReportHeaderStats() const
+{
+    if (headerStats.objectBytes == 0) {
+        return;
+    }
+    double headerRatio = static_cast<double>(headerStats.headerBytes) / headerStats.objectBytes;
+    double savedRatio = static_cast<double>(headerStats.compactHeaderSavedBytes) / headerStats.objectBytes;
+    LOG(RTLOG_INFO, "heap header census: %zu objects, %zu B, header %zu B (%.2f%%), compact header saves %zu B (%.2f%%)",
+        headerStats.objectCount, headerStats.objectBytes, headerStats.headerBytes, headerRatio * 100.0, // 100: percent
+        headerStats.compactHeaderSavedBytes, savedRatio * 100.0); // 100: percent
 }
 
 void CjHeapData::InitSerializedIdWrapper()
@@ -576,7 +608,7 @@ void CjHeapData::WriteStructArray(BaseObject*& obj, const u1 tag)
     u4 num = 0;
     std::vector<BaseObject*> elements;
 
-    RefFieldVisitor visitor = [&elements, &num](RefField<>& arrayContent) {
+    auto visitor = [&elements, &num](RefField<>& arrayContent) {
         elements.push_back(arrayContent.GetTargetObject());
         num++;
     };
@@ -590,7 +622,7 @@ void CjHeapData::WriteStructArray(BaseObject*& obj, const u1 tag)
     if (componentTypeInfo->HasRefField()) {
         elements.reserve(arrayLengthVal);
         for (MIndex i = 0; i < arrayLengthVal; ++i) {
-            gcTib.ForEachBitmapWord(contentAddr, visitor);
+            gcTib.ForEachRef(contentAddr, visitor);
             contentAddr += mArray->GetElementSize();
         }
     }
@@ -696,7 +728,7 @@ void CjHeapData::WriteInstance(BaseObject*& obj, const u1 tag)
     u4 num = 0;
     std::vector<BaseObject*> elements;
 
-    RefFieldVisitor visitor = [&elements, &num](RefField<>& fieldAddr) {
+    auto visitor = [&elements, &num](RefField<>& fieldAddr) {
         elements.push_back(fieldAddr.GetTargetObject());
         num++;
     };
@@ -706,7 +738,7 @@ void CjHeapData::WriteInstance(BaseObject*& obj, const u1 tag)
         elements.reserve(obj->GetTypeInfo()->GetFieldNum());
         GCTib gcTib = currentClass->GetGCTib();
         MAddress objAddr = reinterpret_cast<MAddress>(obj) + TYPEINFO_PTR_SIZE;
-        gcTib.ForEachBitmapWord(objAddr, visitor);
+        gcTib.ForEachRef(objAddr, visitor);
     }
     AddU4(num);
     AddObjectIdList(elements);
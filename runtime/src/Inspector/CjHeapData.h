@@ -121,7 +121,19 @@ public:
         CjHeapDataStringId klassId;
     };
 
+    // census of object header overhead, and the projected saving if the header held a 32-bit type index only.
+    struct HeaderStats {
+        size_t objectCount = 0;
+        size_t objectBytes = 0;
+        size_t headerBytes = 0;
+        size_t compactHeaderSavedBytes = 0;
+    };
+    static constexpr size_t COMPACT_HEADER_SIZE = 4;
+    void CountObjectHeader(BaseObject* obj);
+    void ReportHeaderStats() const;
+
     std::vector<DumpObject> dumpObjects;
+    HeaderStats headerStats;
     std::map<TypeInfo*, CjHeapDataStringId> dumpClassMap;
     std::map<TypeInfo*, CjHeapDataStringId> dumpStructClassMap;
     uint32_t kCjHeapDataTime = 0;
@@ -446,7 +446,7 @@ void CjHeapDataForIDE::SerializeObjectArray(BaseObject*& obj, const u1 tag)
     writer->WriteChar(',');
     u4 num = 0;
     std::stack<u4> VAL;
-    RefFieldVisitor visitor = [&VAL, &num, this](RefField<>& arrayContent) {
+    auto visitor = [&VAL, &num, this](RefField<>& arrayContent) {
         VAL.push(GetId(reinterpret_cast<CjHeapDataID>(arrayContent.GetTargetObject())));
         num++;
     };
@@ -502,7 +502,7 @@ void CjHeapDataForIDE::SerializeStructArray(BaseObject*& obj, const u1 tag)
     writer->WriteChar(',');
     u4 num = 0;
     std::stack<u4> VAL;
-    RefFieldVisitor visitor = [&VAL, &num, this](RefField<>& arrayContent) {
+    auto visitor = [&VAL, &num, this](RefField<>& arrayContent) {
         VAL.push(GetId(reinterpret_cast<CjHeapDataID>(arrayContent.GetTargetObject())));
         num++;
     };
@@ -514,7 +514,7 @@ void CjHeapDataForIDE::SerializeStructArray(BaseObject*& obj, const u1 tag)
     MAddress contentAddr = reinterpret_cast<Uptr>(mArray) + MArray::GetContentOffset();
     if (componentTypeInfo->HasRefField()) {
         for (MIndex i = 0; i < arrayLengthVal; ++i) {
-            gcTib.ForEachBitmapWord(contentAddr, visitor);
+            gcTib.ForEachRef(contentAddr, visitor);
             contentAddr += mArray->GetElementSize();
         }
     }
@@ -629,7 +629,7 @@ void CjHeapDataForIDE::SerializeInstance(BaseObject*& obj, const u1 tag)
     writer->WriteChar(',');
     u4 num = 0;
     std::stack<u4> VAL;
-    RefFieldVisitor visitor = [&VAL, &num, this](RefField<>& fieldAddr) {
+    auto visitor = [&VAL, &num, this](RefField<>& fieldAddr) {
         VAL.push(GetId(reinterpret_cast<CjHeapDataID>(fieldAddr.GetTargetObject())));
         num++;
     };
@@ -637,7 +637,7 @@ void CjHeapDataForIDE::SerializeInstance(BaseObject*& obj, const u1 tag)
     if (obj->HasRefField()) {
         GCTib gcTib = currentClass->GetGCTib();
         MAddress objAddr = reinterpret_cast<MAddress>(obj) + TYPEINFO_PTR_SIZE;
-        gcTib.ForEachBitmapWord(objAddr, visitor);
+        gcTib.ForEachRef(objAddr, visitor);
     }
     writer->WriteNumber(num);
     writer->WriteChar(',');
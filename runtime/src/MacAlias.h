@@ -64,10 +64,50 @@ extern "C" MRT_EXPORT bool CJ_MCC_IsGCRunning();
 __asm__(".global _CJ_MCC_IsGCRunning\n\t.set _CJ_MCC_IsGCRunning, _MCC_IsGCRunning");
 extern "C" MRT_EXPORT size_t CJ_MCC_GetGCFreedSize();
 __asm__(".global _CJ_MCC_GetGCFreedSize\n\t.set _CJ_MCC_GetGCFreedSize, _MCC_GetGCFreedSize");
+extern "C" MRT_EXPORT uint64_t CJ_MCC_GetGCPauseTimeNs();
+__asm__(".global _CJ_MCC_GetGCPauseTimeNs\n\t.set _CJ_MCC_GetGCPauseTimeNs, _MCC_GetGCPauseTimeNs");
+extern "C" MRT_EXPORT size_t CJ_MCC_GetThreadAllocatedBytes();
+__asm__(
+    ".global _CJ_MCC_GetThreadAllocatedBytes\n\t.set _CJ_MCC_GetThreadAllocatedBytes, "
+    "_MCC_GetThreadAllocatedBytes");
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapDirtySize();
+__asm__(".global _CJ_MCC_GetHeapDirtySize\n\t.set _CJ_MCC_GetHeapDirtySize, _MCC_GetHeapDirtySize");
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapReleasedSize();
+__asm__(".global _CJ_MCC_GetHeapReleasedSize\n\t.set _CJ_MCC_GetHeapReleasedSize, _MCC_GetHeapReleasedSize");
+extern "C" MRT_EXPORT size_t CJ_MCC_GetHeapScavengedSize();
+__asm__(".global _CJ_MCC_GetHeapScavengedSize\n\t.set _CJ_MCC_GetHeapScavengedSize, _MCC_GetHeapScavengedSize");
+extern "C" MRT_EXPORT void CJ_MCC_ReleaseHeapMemory();
+__asm__(".global _CJ_MCC_ReleaseHeapMemory\n\t.set _CJ_MCC_ReleaseHeapMemory, _MCC_ReleaseHeapMemory");
 extern "C" MRT_EXPORT size_t CJ_MCC_StartCpuProfiling();
 __asm__(".global _CJ_MCC_StartCpuProfiling\n\t.set _CJ_MCC_StartCpuProfiling, _MCC_StartCpuProfiling");
 extern "C" MRT_EXPORT size_t CJ_MCC_StopCpuProfiling(int fd);
 __asm__(".global _CJ_MCC_StopCpuProfiling\n\t.set _CJ_MCC_StopCpuProfiling, _MCC_StopCpuProfiling");
+extern "C" MRT_EXPORT bool CJ_MCC_StopCpuProfilingWithFormat(int fd, int format);
+__asm__(
+    ".global _CJ_MCC_StopCpuProfilingWithFormat\n\t.set _CJ_MCC_StopCpuProfilingWithFormat, "
+    "_MCC_StopCpuProfilingWithFormat");
+extern "C" MRT_EXPORT bool CJ_MCC_StartAllocSampling(size_t intervalBytes);
+__asm__(".global _CJ_MCC_StartAllocSampling\n\t.set _CJ_MCC_StartAllocSampling, _MCC_StartAllocSampling");
+extern "C" MRT_EXPORT bool CJ_MCC_StopAllocSampling();
+__asm__(".global _CJ_MCC_StopAllocSampling\n\t.set _CJ_MCC_StopAllocSampling, _MCC_StopAllocSampling");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpAllocSamples(int fd);
+__asm__(".global _CJ_MCC_DumpAllocSamples\n\t.set _CJ_MCC_DumpAllocSamples, _MCC_DumpAllocSamples");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpAllocSamplesWithFormat(int fd, int format);
+__asm__(
+    ".global _CJ_MCC_DumpAllocSamplesWithFormat\n\t.set _CJ_MCC_DumpAllocSamplesWithFormat, "
+    "_MCC_DumpAllocSamplesWithFormat");
+extern "C" MRT_EXPORT bool CJ_MCC_StartLockProfiling(uint32_t rate);
+__asm__(".global _CJ_MCC_StartLockProfiling\n\t.set _CJ_MCC_StartLockProfiling, _MCC_StartLockProfiling");
+extern "C" MRT_EXPORT bool CJ_MCC_StopLockProfiling();
+__asm__(".global _CJ_MCC_StopLockProfiling\n\t.set _CJ_MCC_StopLockProfiling, _MCC_StopLockProfiling");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpLockProfile(int fd);
+__asm__(".global _CJ_MCC_DumpLockProfile\n\t.set _CJ_MCC_DumpLockProfile, _MCC_DumpLockProfile");
+extern "C" MRT_EXPORT bool CJ_MCC_DumpLockProfileWithFormat(int fd, int format);
+__asm__(
+    ".global _CJ_MCC_DumpLockProfileWithFormat\n\t.set _CJ_MCC_DumpLockProfileWithFormat, "
+    "_MCC_DumpLockProfileWithFormat");
+extern "C" MRT_EXPORT bool CJ_MCC_GetLockContentionStats(int kind, uint64_t* contentions, uint64_t* delayNanos);
+__asm__(".global _CJ_MCC_GetLockContentionStats\n\t.set _CJ_MCC_GetLockContentionStats, _MCC_GetLockContentionStats");
 extern "C" MRT_EXPORT void CJ_MCC_SetGCThreshold(uint64_t GCThreshold);
 __asm__(".global _CJ_MCC_SetGCThreshold\n\t.set _CJ_MCC_SetGCThreshold, _MCC_SetGCThreshold");
 extern "C" MRT_EXPORT void* CJ_MCC_PostThrowException(ExceptionWrapper* mExceptionWrapper);
@@ -12,6 +12,7 @@
 #include <windows.h>
 #endif
 #include "Collector/CopyCollector.h"
+#include "Common/BaseObject.inline.h"
 #include "Common/ScopedObjectAccess.h"
 #include "Concurrency/ConcurrencyModel.h"
 #include "Heap/Collector/FinalizerProcessor.h"
@@ -176,6 +177,9 @@ void Mutator::ResetMutator()
     }
     uwContext.Reset();
     exceptionWrapper.ClearInfo();
+    hasRecordedRoots = false;
+    recordedRootSlots.clear();
+    recordedRootSlots.shrink_to_fit();
 }
 
 void Mutator::SetManagedContext(bool isManagedContext)
@@ -255,12 +259,58 @@ void Mutator::VisitStackRoots(const RootVisitor& func)
 #if defined(GCINFO_DEBUG) && GCINFO_DEBUG
     CreateCurrentGCInfo();
 #endif
-    StackManager::VisitStackRoots(uwContext, func, *this);
+    if (!VisitRecordedStackRoots(func)) {
+        StackScanStats& stats = GetStackScanStats();
+        size_t stackBytes = 0;
+        size_t frames = 0;
+        // only a parked cjthread keeps its stack until it is scheduled again, a thread in native code does not.
+        if (GetCJThreadState() == CJTHREAD_PENDING) {
+            uint64_t epoch = runEpoch.load(std::memory_order_relaxed);
+            recordedRootSlots.clear();
+            RootVisitor recorder = [this, &func](ObjectRef& root) {
+                recordedRootSlots.push_back(&root);
+                func(root);
+            };
+            frames = StackManager::VisitStackRoots(uwContext, recorder, *this, &stackBytes);
+            recordedRootsEpoch = epoch;
+            recordedFrames = frames;
+            recordedBytes = stackBytes;
+            hasRecordedRoots = true;
+        } else {
+            hasRecordedRoots = false;
+            frames = StackManager::VisitStackRoots(uwContext, func, *this, &stackBytes);
+        }
+        stats.unwoundStacks.fetch_add(1, std::memory_order_relaxed);
+        stats.unwoundFrames.fetch_add(frames, std::memory_order_relaxed);
+        stats.unwoundBytes.fetch_add(stackBytes, std::memory_order_relaxed);
+    }
     VisitRawObjects(func);
     DecObserver();
     MutatorUnlock();
 }
 
+Mutator::StackScanStats& Mutator::GetStackScanStats()
+{
+    static StackScanStats stats;
+    return stats;
+}
+
+bool Mutator::VisitRecordedStackRoots(const RootVisitor& func)
+{
+    if (!hasRecordedRoots || recordedRootsEpoch != runEpoch.load(std::memory_order_relaxed) ||
+        GetCJThreadState() != CJTHREAD_PENDING) {
+        return false;
+    }
+    for (ObjectRef* slot : recordedRootSlots) {
+        func(*slot);
+    }
+    StackScanStats& stats = GetStackScanStats();
+    stats.reusedStacks.fetch_add(1, std::memory_order_relaxed);
+    stats.reusedFrames.fetch_add(recordedFrames, std::memory_order_relaxed);
+    stats.reusedBytes.fetch_add(recordedBytes, std::memory_order_relaxed);
+    return true;
+}
+
 void Mutator::VisitExceptionRoots(const RootVisitor& func)
 {
     func(reinterpret_cast<ObjectRef&>(exceptionWrapper.GetExceptionRef()));
@@ -407,7 +457,7 @@ void Mutator::RecordStackPtrs(std::set<BaseObject**>& resSet)
     StackManager::VisitStackPtrMap(uwContext, traceAndFixPtrVisitor, fixPtrVisitor, derivedPtrVisitor, *this);
 
     // Ref trace on non-escaped heap pointers.
-    RefFieldVisitor refVisitor = [&rootList, this](RefField<>& oldRefFieldAddr) {
+    auto refVisitor = [&rootList, this](RefField<>& oldRefFieldAddr) {
         // Check whether the address is on the stack.
         if (IsStackAddr(reinterpret_cast<uintptr_t>(oldRefFieldAddr.GetTargetObject()))) {
             rootList.push(reinterpret_cast<BaseObject**>(&oldRefFieldAddr));
@@ -425,7 +475,7 @@ void Mutator::RecordStackPtrs(std::set<BaseObject**>& resSet)
         if (!obj->IsValidObject() || !obj->HasRefField()) {
             continue;
         } else {
-            obj->ForEachRefField(refVisitor);
+            obj->ScanRefFields(refVisitor);
         }
     }
 }
@@ -534,15 +584,29 @@ inline void CheckAndPush(BaseObject* obj, std::set<BaseObject*>& rootSet, std::s
     }
 }
 
+namespace {
+thread_local std::vector<BaseObject*>* g_enumRootSink = nullptr;
+
+inline void PushEnumRoot(BaseObject* obj)
+{
+    if (g_enumRootSink != nullptr) {
+        g_enumRootSink->push_back(obj);
+        return;
+    }
+    AllocBuffer::GetOrCreateAllocBuffer()->PushRoot(obj);
+}
+} // namespace
+
+void Mutator::SetEnumRootSink(std::vector<BaseObject*>* sink) { g_enumRootSink = sink; }
+
 inline void Mutator::GcPhaseEnum(GCPhase newPhase)
 {
     std::set<BaseObject*> rootSet;
     std::stack<BaseObject*> rootStack;
-    RefFieldVisitor refVisitor = [&rootSet, &rootStack, this](RefField<>& refFieldAddr) {
+    auto refVisitor = [&rootSet, &rootStack, this](RefField<>& refFieldAddr) {
         BaseObject* obj = refFieldAddr.GetTargetObject();
         if (Heap::IsHeapAddress(obj)) {
-            AllocBuffer* buffer = AllocBuffer::GetOrCreateAllocBuffer();
-            buffer->PushRoot(obj);
+            PushEnumRoot(obj);
             DLOG(ENUM, "enum stack root RefField @%p: %p", &refFieldAddr, obj);
         } else if (IsStackAddr(reinterpret_cast<uintptr_t>(obj))) {
             CheckAndPush(obj, rootSet, rootStack);
@@ -552,8 +616,7 @@ inline void Mutator::GcPhaseEnum(GCPhase newPhase)
     RootVisitor visitor = [&rootSet, &rootStack, this, &refVisitor](ObjectRef& root) {
         BaseObject* obj = root.object;
         if (Heap::IsHeapAddress(obj)) {
-            AllocBuffer* buffer = AllocBuffer::GetOrCreateAllocBuffer();
-            buffer->PushRoot(obj);
+            PushEnumRoot(obj);
             DLOG(ENUM, "enum stack root @%p: %p", &root, obj);
         } else if (IsStackAddr(reinterpret_cast<uintptr_t>(obj))) {
             CheckAndPush(obj, rootSet, rootStack);
@@ -561,7 +624,7 @@ inline void Mutator::GcPhaseEnum(GCPhase newPhase)
         while (!rootStack.empty()) {
             BaseObject* obj = rootStack.top();
             rootStack.pop();
-            obj->ForEachRefField(refVisitor);
+            obj->ScanRefFields(refVisitor);
         }
     };
     VisitMutatorRoots(visitor);
@@ -582,7 +645,7 @@ inline void Mutator::GCPhasePreForward(GCPhase newPhase)
     std::set<void*> rootFieldSet;
     std::stack<BaseObject*> rootStack;
     Collector& collector = reinterpret_cast<Collector&>(Heap::GetHeap().GetCollector());
-    RefFieldVisitor refVisitor = [&rootSet, &rootFieldSet, &rootStack, &collector, this](RefField<>& refFieldAddr) {
+    auto refVisitor = [&rootSet, &rootFieldSet, &rootStack, &collector, this](RefField<>& refFieldAddr) {
         BaseObject* oldObj = refFieldAddr.GetTargetObject();
         if (Heap::IsHeapAddress(oldObj) && collector.IsGhostFromObject(oldObj) &&
             !collector.IsUnmovableFromObject(oldObj)) {
@@ -607,7 +670,7 @@ inline void Mutator::GCPhasePreForward(GCPhase newPhase)
         while (!rootStack.empty()) {
             BaseObject* obj = rootStack.top();
             rootStack.pop();
-            obj->ForEachRefField(refVisitor);
+            obj->ScanRefFields(refVisitor);
         }
     };
 
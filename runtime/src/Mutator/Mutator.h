@@ -221,6 +221,32 @@ public:
         return CJThreadGetState(cjthread);
     }
 
+    // Stack roots are enumerated by unwinding the whole stack. A parked cjthread keeps its stack untouched until it
+    // is scheduled again, so root slots found by the last unwinding are replayed instead while it stays parked.
+    struct StackScanStats {
+        std::atomic<size_t> unwoundStacks = { 0 };
+        std::atomic<size_t> unwoundFrames = { 0 };
+        std::atomic<size_t> unwoundBytes = { 0 };
+        std::atomic<size_t> reusedStacks = { 0 };
+        std::atomic<size_t> reusedFrames = { 0 };
+        std::atomic<size_t> reusedBytes = { 0 };
+
+        void Reset()
+        {
+            unwoundStacks.store(0, std::memory_order_relaxed);
+            unwoundFrames.store(0, std::memory_order_relaxed);
+            unwoundBytes.store(0, std::memory_order_relaxed);
+            reusedStacks.store(0, std::memory_order_relaxed);
+            reusedFrames.store(0, std::memory_order_relaxed);
+            reusedBytes.store(0, std::memory_order_relaxed);
+        }
+    };
+    static StackScanStats& GetStackScanStats();
+
+    // heap roots enumerated by the calling thread for other mutators are pushed into (sink) instead of the
+    // AllocBuffer of the calling thread while it is set, so that gc workers need no AllocBuffer.
+    static void SetEnumRootSink(std::vector<BaseObject*>* sink);
+
     __attribute__((always_inline)) inline bool FinishedTransition() const
     {
         return transitionState == FINISH_TRANSITION;
@@ -438,6 +464,9 @@ public:
         if (UNLIKELY(tlData->buffer == nullptr)) {
             (void)AllocBuffer::GetOrCreateAllocBuffer();
         }
+        bufferBytesAtRun = tlData->buffer->GetAllocatedBytes();
+        // stack may be changed from now on, which invalidates recorded stack roots.
+        runEpoch.fetch_add(1, std::memory_order_relaxed);
         DoLeaveSaferegion();
         SetSafepointStatePtr(&tlData->safepointState);
         SetSafepointActive(false);
@@ -446,6 +475,11 @@ public:
     void PreparedToPark(void* pc, void* fa)
     {
         SetSafepointStatePtr(nullptr);
+        AllocBuffer* buffer = ThreadLocal::GetAllocBuffer();
+        if (LIKELY(buffer != nullptr)) {
+            allocatedBytes += buffer->GetAllocatedBytes() - bufferBytesAtRun;
+            bufferBytesAtRun = buffer->GetAllocatedBytes();
+        }
         if (UNLIKELY((uwContext.GetUnwindContextStatus() == UnwindContextStatus::RISKY) || InSaferegion())) {
             return;
         }
@@ -496,6 +530,14 @@ public:
 
     void ReleaseForeignThread();
 
+    // bytes allocated by this cjthread, which are accounted from the alloc buffer of the thread it runs on.
+    // called by the running mutator.
+    size_t GetAllocatedBytes() const
+    {
+        AllocBuffer* buffer = ThreadLocal::GetAllocBuffer();
+        return buffer == nullptr ? allocatedBytes : allocatedBytes + buffer->GetAllocatedBytes() - bufferBytesAtRun;
+    }
+
 protected:
     // for managed stack
     void VisitStackRoots(const RootVisitor& func);
@@ -572,6 +614,20 @@ private:
         ScheduleHandle schedule = { nullptr };
     } foreignThreadInfo;
 
+    // stack watermark: root slots recorded by the last unwinding of a parked stack, valid while runEpoch is unchanged.
+    bool VisitRecordedStackRoots(const RootVisitor& func);
+    std::atomic<uint64_t> runEpoch = { 0 };
+    uint64_t recordedRootsEpoch = 0;
+    bool hasRecordedRoots = false;
+    size_t recordedFrames = 0;
+    size_t recordedBytes = 0;
+    std::vector<ObjectRef*> recordedRootSlots;
+
+    // bytes allocated before this mutator started running on current thread,
+    // and allocated bytes of the thread's alloc buffer at that time.
+    size_t allocatedBytes = 0;
+    size_t bufferBytesAtRun = 0;
+
 public:
 #ifdef INTERPRETER_ENABLED
     void InitInterpreterPart();
@@ -13,6 +13,8 @@
 #include "Concurrency/ConcurrencyModel.h"
 #include "Heap/Collector/FinalizerProcessor.h"
 #include "Heap/Collector/TracingCollector.h"
+#include "Heap/GcThreadPool.h"
+#include "Heap/HeapWork.h"
 #include "Heap/Heap.h"
 #include "Mutator.inline.h"
 #include "schedule.h"
@@ -272,6 +274,8 @@ void MutatorManager::StopTheWorld(bool syncGCPhase, GCPhase phase)
     // Prevent multi-thread doing STW concurrently.
     syncMutex.lock();
     syncTriggered.store(true);
+    stwStartTime = TimeUtil::NanoSeconds();
+    ScheduleTraceEvent(TRACE_EV_GC_STW_START, -1, nullptr, TRACE_ARGS_0);
 
     AcquireMutatorManagementWLock();
 
@@ -316,6 +320,8 @@ void MutatorManager::StartTheWorld() noexcept
 #endif
 
     MutatorManagementWUnlock();
+    ScheduleTraceEvent(TRACE_EV_GC_STW_DONE, -1, nullptr, TRACE_ARGS_0);
+    g_stwTotalTimeNs += TimeUtil::NanoSeconds() - stwStartTime;
 
     // Release syncMutex to allow other thread call STW.
     syncMutex.unlock();
@@ -461,25 +467,96 @@ void MutatorManager::WaitUntilAllMutatorStopped()
     }
 }
 
-void MutatorManager::EnsurePhaseTransition(GCPhase phase, std::list<Mutator*> &undoneMutators)
+size_t MutatorManager::TransitionSaferegionMutatorsInParallel(std::vector<Mutator*>& undoneMutators,
+                                                              uint64_t startTime)
 {
+    // gc workers are only borrowed by gc thread, which never transitions mutators while they are busy.
+    GCThreadPool* threadPool = Heap::GetHeap().GetCollectorResources().GetThreadPool();
+    size_t mutatorCount = undoneMutators.size();
+    if (threadPool == nullptr || !IsGcThread() || mutatorCount < PARALLEL_HANDSHAKE_THRESHOLD) {
+        return 0;
+    }
+    std::atomic<size_t> nextIndex = { 0 };
+    std::atomic<size_t> transitionedCount = { 0 };
+    // stack roots enumerated by workers, which are handed to the AllocBuffer of gc thread afterwards.
+    std::mutex rootsMutex;
+    std::vector<BaseObject*> enumRoots;
+    auto transitionChunks = [this, &undoneMutators, &nextIndex, &transitionedCount, &rootsMutex, &enumRoots,
+                             mutatorCount, startTime](size_t) {
+        size_t transitioned = 0;
+        std::vector<BaseObject*> roots;
+        Mutator::SetEnumRootSink(&roots);
+        for (size_t begin = nextIndex.fetch_add(HANDSHAKE_CHUNK_SIZE, std::memory_order_relaxed);
+             begin < mutatorCount; begin = nextIndex.fetch_add(HANDSHAKE_CHUNK_SIZE, std::memory_order_relaxed)) {
+            size_t end = std::min(begin + HANDSHAKE_CHUNK_SIZE, mutatorCount);
+            for (size_t i = begin; i < end; ++i) {
+                // each slot is touched by exactly one worker, and mutators compete with workers by TransitionGCPhase.
+                Mutator* mutator = undoneMutators[i];
+                if (mutator->InSaferegion() && mutator->TransitionGCPhase(false)) {
+                    handshakeHistogram.Record(TimeUtil::MicroSeconds() - startTime);
+                    undoneMutators[i] = nullptr;
+                    ++transitioned;
+                }
+            }
+        }
+        Mutator::SetEnumRootSink(nullptr);
+        (void)transitionedCount.fetch_add(transitioned, std::memory_order_relaxed);
+        if (!roots.empty()) {
+            std::lock_guard<std::mutex> lg(rootsMutex);
+            enumRoots.insert(enumRoots.end(), roots.begin(), roots.end());
+        }
+    };
+
+    int32_t threadNum = threadPool->GetMaxThreadNum() + 1;
+    threadPool->Start();
+    for (int32_t i = 0; i < threadNum; ++i) {
+        threadPool->AddWork(new (std::nothrow) LambdaWork(transitionChunks));
+    }
+    threadPool->WaitFinish();
+    if (!enumRoots.empty()) {
+        AllocBuffer* buffer = AllocBuffer::GetOrCreateAllocBuffer();
+        for (BaseObject* root : enumRoots) {
+            buffer->PushRoot(root);
+        }
+    }
+    return transitionedCount.load(std::memory_order_relaxed);
+}
+
+void MutatorManager::EnsurePhaseTransition(GCPhase phase, std::vector<Mutator*> &undoneMutators)
+{
+    uint64_t startTime = TimeUtil::MicroSeconds();
+    size_t mutatorCount = undoneMutators.size();
+    handshakeHistogram.Reset();
+    // with tens of thousands of parked cjthreads, scanning their stacks one by one dominates the pause.
+    size_t transitionedByGC = TransitionSaferegionMutatorsInParallel(undoneMutators, startTime);
+
     // Traverse through undoneMutators to select mutators that have not yet completed transition
     // 1. ignore mutators which have completed transition
     // 2. gc compete phase transition with mutators which are in saferegion
-    // 3. fill mutators which are running state in undoneMutators
+    // 3. keep mutators which are running state in undoneMutators
     while (undoneMutators.size() > 0) {
-        for (auto it = undoneMutators.begin(); it != undoneMutators.end();) {
-            Mutator* mutator = *it;
+        size_t remain = 0;
+        for (Mutator* mutator : undoneMutators) {
+            if (mutator == nullptr) {
+                continue;
+            }
             if (mutator->GetMutatorPhase() == phase && mutator->FinishedTransition()) {
-                it = undoneMutators.erase(it);
+                handshakeHistogram.Record(TimeUtil::MicroSeconds() - startTime);
                 continue;
             }
             if (mutator->InSaferegion() && mutator->TransitionGCPhase(false)) {
-                it = undoneMutators.erase(it);
+                handshakeHistogram.Record(TimeUtil::MicroSeconds() - startTime);
+                ++transitionedByGC;
                 continue;
             }
-            ++it;
+            undoneMutators[remain++] = mutator;
         }
+        undoneMutators.resize(remain);
+    }
+    if (mutatorCount != 0) {
+        VLOG(REPORT, "handshake %s: %zu mutators (%zu by gc) in %lu us, latency %s", Collector::GetGCPhaseName(phase),
+             mutatorCount, transitionedByGC, TimeUtil::MicroSeconds() - startTime,
+             handshakeHistogram.ToString().Str());
     }
 }
 
@@ -499,7 +576,7 @@ void MutatorManager::TransitionAllMutatorsToGCPhase(GCPhase phase)
     Heap::GetHeap().InstallBarrier(phase);
     Heap::GetHeap().SetGCPhase(phase);
 
-    std::list<Mutator*> undoneMutators;
+    std::vector<Mutator*> undoneMutators;
     // Broadcast mutator phase transition signal to all mutators
     VisitAllMutators([&undoneMutators](Mutator& mutator) {
         mutator.SetSuspensionFlag(Mutator::SuspensionType::SUSPENSION_FOR_GC_PHASE);
@@ -8,12 +8,16 @@
 #ifndef MRT_MUTATOR_MANAGER_H
 #define MRT_MUTATOR_MANAGER_H
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <list>
 #include <mutex>
 #include <unordered_set>
+#include <vector>
 
 #include "Base/AtomicSpinLock.h"
+#include "Base/CString.h"
 #include "Base/Globals.h"
 #include "Base/Panic.h"
 #include "Base/RwLock.h"
@@ -45,6 +49,42 @@ extern "C" void HandleSafepointForArm(ThreadLocalData* tlData);
 
 using MutatorVisitor = std::function<void(Mutator&)>;
 
+// Latency from broadcasting a gc phase to each mutator finishing its transition, bucketed by powers of 2 in
+// microseconds: bucket 0 counts transitions within 1us, bucket i counts those in [2^(i-1), 2^i) us.
+class HandshakeHistogram {
+public:
+    static constexpr size_t BUCKET_COUNT = 24;
+
+    void Reset()
+    {
+        for (auto& bucket : buckets) {
+            bucket.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void Record(uint64_t latencyUs)
+    {
+        size_t idx = latencyUs == 0 ? 0 : static_cast<size_t>(64 - __builtin_clzll(latencyUs)); // 64: bits of u64
+        buckets[std::min(idx, BUCKET_COUNT - 1)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // non-empty buckets as "<upper bound>us:count", e.g. "<1us:12 <4us:3".
+    CString ToString() const
+    {
+        CString str;
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            size_t count = buckets[i].load(std::memory_order_relaxed);
+            if (count != 0) {
+                str.Append(CString::FormatString("%s<%zuus:%zu", str.Length() == 0 ? "" : " ", size_t(1) << i, count));
+            }
+        }
+        return str;
+    }
+
+private:
+    std::atomic<size_t> buckets[BUCKET_COUNT] = {};
+};
+
 class MutatorManager {
 public:
     MutatorManager() {}
@@ -164,7 +204,7 @@ public:
 
     void SyncMutexUnlock() noexcept { syncMutex.unlock(); }
 
-    void EnsurePhaseTransition(GCPhase phase, std::list<Mutator*> &undoneMutators);
+    void EnsurePhaseTransition(GCPhase phase, std::vector<Mutator*> &undoneMutators);
     void TransitionAllMutatorsToGCPhase(GCPhase phase);
 
     void EnsureCpuProfileFinish(std::list<Mutator*> &undoneMutators);
@@ -232,6 +272,14 @@ public:
     CJThreadHandle GetMainThreadHandle() { return mainThreadHandle; }
 
 private:
+    // gc thread pool takes over the handshakes once this many mutators are to be transitioned.
+    static constexpr size_t PARALLEL_HANDSHAKE_THRESHOLD = 256;
+    // mutators claimed by a gc worker at a time.
+    static constexpr size_t HANDSHAKE_CHUNK_SIZE = 64;
+
+    // transition mutators in saferegion with gc thread pool, finished ones are set to null in undoneMutators.
+    size_t TransitionSaferegionMutatorsInParallel(std::vector<Mutator*>& undoneMutators, uint64_t startTime);
+
     using ExpiredMutatorList = std::list<Mutator*, StdContainerAllocator<Mutator*, MUTATOR_LIST>>;
     ExpiredMutatorList expiringMutators;
     std::mutex expiringMutatorListLock;
@@ -252,8 +300,12 @@ private:
     std::recursive_mutex syncMutex;
     std::atomic<bool> syncTriggered = { false };
     std::atomic<bool> worldStopped = { false };
-    std::list<Mutator*> undoneLightSyncMutators;
+    std::vector<Mutator*> undoneLightSyncMutators;
     GCPhase lightSyncGCPhase;
+    // recorded by the gc thread and by gc workers transitioning mutators in parallel, thus its buckets are atomic.
+    HandshakeHistogram handshakeHistogram;
+    // when the world is stopped by the thread holding syncMutex.
+    uint64_t stwStartTime = 0;
 
 #if defined(_WIN64) || defined (__APPLE__)
     std::condition_variable mutatorSuspensionCV;
@@ -11,6 +11,7 @@
 #include "schedule.h"
 #include "Base/Globals.h"
 #include "Mutator/Mutator.h"
+#include "CpuProfiler/CpuProfiler.h"
 
 namespace MapleRuntime {
 RwLock ThreadLocal::tlEnableLock;
@@ -58,6 +59,7 @@ CleanThreadLocalData::~CleanThreadLocalData()
         return;
     }
 
+    CpuProfiler::DetachThread();
     MRT_StopSubScheduler(local->schedule);
     CJForeignThreadExit(reinterpret_cast<CJThreadHandle>(local->foreignCJThread));
     ThreadLocal::UnlockRdLock();
@@ -48,6 +48,9 @@ public:
     inline U8* ConvertToCArray() const;
     // this interface can only be called by array with reference fields.
     void ForEachRefFieldInRange(const RefFieldVisitor& visitor, MAddress fieldStart, MIndex fieldEnd) const;
+    // same as ForEachRefFieldInRange, but specialized for each visitor type. defined in MArray.inline.h.
+    template<typename Visitor>
+    void ScanRefFieldsInRange(Visitor&& visitor, MAddress fieldStart, MAddress fieldEnd) const;
 
 private:
     // use MIndex because length is the upper boundary of all indices
@@ -81,6 +81,31 @@ inline void MArray::SetPrimitiveElement(MIndex index, T value)
     Heap::GetBarrier().WriteField(this, field, value);
 }
 
+template<typename Visitor>
+inline void MArray::ScanRefFieldsInRange(Visitor&& visitor, MAddress fieldStart, MAddress fieldEnd) const
+{
+    TypeInfo* componentTi = GetComponentTypeInfo();
+    MIndex size = fieldEnd - fieldStart;
+    if (componentTi->IsStructType()) {
+        GCTib gcTib = componentTi->GetGCTib();
+        size_t elementSize = GetElementSize();
+        CHECK(elementSize != 0);
+        MIndex limit = size / elementSize;
+        for (MIndex i = 0; i < limit; ++i) {
+            gcTib.ForEachRef(fieldStart, visitor);
+            fieldStart += elementSize;
+        }
+    } else if (componentTi->IsObjectType() || componentTi->IsArrayType() || componentTi->IsInterface()) {
+        RefField<false>* arrayContent = reinterpret_cast<RefField<false>*>(fieldStart);
+        MIndex upLimit = size / sizeof(RefField<>);
+        for (MIndex i = 0; i < upLimit; ++i) {
+            visitor(arrayContent[i]);
+        }
+    } else {
+        LOG(RTLOG_FATAL, "array object %p has wrong component type", this);
+    }
+}
+
 static inline MIndex CalculateArraySize(MIndex nElems, const U32 elemBytes)
 {
     if (elemBytes == 0) {
@@ -229,36 +229,43 @@ typedef TypeInfo* (*GenericFunc)(TypeInfo**);
 struct ShortGCTib {
     ArchUInt bitmap; // lower 63 bits are valid, each bit indicates 8-byte width, 1:ref, 0:no-ref
 
-    void ForEachBitmapWord(MAddress fieldAddr, const RefFieldVisitor& visitor) const
+    // visitor is inlined into the scan loop, which jumps from one ref bit to the next rather than shifting bit by bit.
+    template<typename Visitor>
+    void ForEachRef(MAddress fieldAddr, Visitor&& visitor) const
     {
-        ArchUInt gcInfo = bitmap & (~SIGN_BIT);
-        while (LIKELY(gcInfo != 0)) {
-            if (gcInfo & REF_BIT_MASK) {
-                visitor(*reinterpret_cast<RefField<>*>(fieldAddr));
-            }
-            gcInfo >>= BITS_FOR_REF;
-            fieldAddr += sizeof(RefField<>);
+        unsigned long long gcInfo = bitmap & (~SIGN_BIT);
+        while (gcInfo != 0) {
+            unsigned int idx = static_cast<unsigned int>(__builtin_ctzll(gcInfo));
+            visitor(*reinterpret_cast<RefField<>*>(fieldAddr + idx * sizeof(RefField<>)));
+            gcInfo &= gcInfo - 1; // clear the lowest ref bit.
         }
     }
-    void ForEachBitmapWordInRange(MAddress baseAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
-                                  MAddress rangeEnd) const
+    // same as ForEachRef, but only visits the fields in [rangeStart, rangeEnd), rangeStart must be aligned.
+    template<typename Visitor>
+    void ForEachRefInRange(MAddress baseAddr, Visitor&& visitor, MAddress rangeStart, MAddress rangeEnd) const
     {
-        ArchUInt gcInfo = bitmap & (~SIGN_BIT);
+        unsigned long long gcInfo = bitmap & (~SIGN_BIT);
         U32 startPos = (rangeStart - baseAddr) / sizeof(RefField<>);
+        if (startPos >= sizeof(gcInfo) * 8) { // 8: bits per byte
+            return;
+        }
         gcInfo >>= startPos;
-
-        MAddress fieldAddr = rangeStart;
-        while (LIKELY(gcInfo != 0)) {
+        while (gcInfo != 0) {
+            unsigned int idx = static_cast<unsigned int>(__builtin_ctzll(gcInfo));
+            MAddress fieldAddr = rangeStart + idx * sizeof(RefField<>);
             if (fieldAddr >= rangeEnd) {
                 return;
             }
-            if (gcInfo & REF_BIT_MASK) {
-                visitor(*reinterpret_cast<RefField<>*>(fieldAddr));
-            }
-            gcInfo >>= BITS_FOR_REF;
-            fieldAddr += sizeof(RefField<>);
+            visitor(*reinterpret_cast<RefField<>*>(fieldAddr));
+            gcInfo &= gcInfo - 1; // clear the lowest ref bit.
         }
     }
+    void ForEachBitmapWord(MAddress fieldAddr, const RefFieldVisitor& visitor) const { ForEachRef(fieldAddr, visitor); }
+    void ForEachBitmapWordInRange(MAddress baseAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
+                                  MAddress rangeEnd) const
+    {
+        ForEachRefInRange(baseAddr, visitor, rangeStart, rangeEnd);
+    }
 };
 
 struct StdGCTib {
@@ -270,16 +277,6 @@ struct StdGCTib {
     // An array of bitmap words. Length is `nBitmapWords`.
     U8 bitmapWords[];
 
-    void VisitRefField(U8& bitmapWord, MAddress& fieldAddr, const RefFieldVisitor& visitor) const
-    {
-        U8 wordBits = bitmapWord & REF_BIT_MASK;
-        if (wordBits != 0) {
-            visitor(*reinterpret_cast<RefField<>*>(fieldAddr));
-        }
-        // go next ref word.
-        bitmapWord >>= BITS_FOR_REF;
-        fieldAddr += sizeof(RefField<>);
-    }
     void VisitAllField(U8 &bitmapWord, MAddress &fieldAddr, const RefFieldVisitor &visitor) const
     {
         visitor(*reinterpret_cast<RefField<> *>(fieldAddr));
@@ -288,54 +285,62 @@ struct StdGCTib {
         bitmapWord >>= BITS_FOR_REF;
         fieldAddr += sizeof(RefField<>);
     }
-    void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
+    template<typename Visitor>
+    void ForEachRef(MAddress contentAddr, Visitor&& visitor) const
     {
         const U8* bitmaps = bitmapWords;
 
         // start address of fields.
         MAddress baseAddr = contentAddr;
-        // for each bitmap word.
+        // for each bitmap word, words without refs are skipped with a single test.
         for (U32 i = 0; i < nBitmapWords; ++i) {
-            U8 bitmapWord = bitmaps[i];
-            MAddress fieldAddr = baseAddr;
-
-            // for each bit in bitmap.
-            while (LIKELY(bitmapWord != 0)) {
-                VisitRefField(bitmapWord, fieldAddr, visitor);
+            unsigned int bitmapWord = bitmaps[i];
+            while (bitmapWord != 0) {
+                unsigned int idx = static_cast<unsigned int>(__builtin_ctz(bitmapWord));
+                visitor(*reinterpret_cast<RefField<>*>(baseAddr + idx * sizeof(RefField<>)));
+                bitmapWord &= bitmapWord - 1; // clear the lowest ref bit.
             }
             // go next bitmap word.
             baseAddr += (sizeof(RefField<>) * REFS_PER_BIT_WORD);
         }
     }
-    void ForEachBitmapWordInRange(MAddress contentAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
-                                  MAddress rangeEnd) const
+    void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
+    {
+        ForEachRef(contentAddr, visitor);
+    }
+    // same as ForEachRef, but only visits the fields in [rangeStart, rangeEnd), rangeStart must be aligned.
+    template<typename Visitor>
+    void ForEachRefInRange(MAddress contentAddr, Visitor&& visitor, MAddress rangeStart, MAddress rangeEnd) const
     {
         const U8* bitmaps = bitmapWords;
         size_t mapWordSize = (sizeof(RefField<>) * REFS_PER_BIT_WORD);
         U32 startIndex = (rangeStart - contentAddr) / mapWordSize;
         // start address of fields.
         MAddress baseAddr = startIndex * mapWordSize + contentAddr;
-        // for each bitmap word.
-        for (U32 i = startIndex; i < nBitmapWords; ++i) {
-            U8 bitmapWord = bitmaps[i];
-            MAddress fieldAddr = baseAddr;
-            // Make sure each fieldAddr visited is no less then rangeStart addr
-            if (i == startIndex && bitmapWord != 0) {
-                bitmapWord >>= ((rangeStart - baseAddr) / sizeof(RefField<>));
-                fieldAddr = rangeStart;
+        for (U32 i = startIndex; i < nBitmapWords && baseAddr < rangeEnd; ++i) {
+            unsigned int bitmapWord = bitmaps[i];
+            // drop the refs before rangeStart in the first bitmap word.
+            if (i == startIndex) {
+                bitmapWord &= ~0U << ((rangeStart - baseAddr) / sizeof(RefField<>));
             }
-            // for each bit in bitmap.
-            while (LIKELY(bitmapWord != 0)) {
+            while (bitmapWord != 0) {
+                unsigned int idx = static_cast<unsigned int>(__builtin_ctz(bitmapWord));
+                MAddress fieldAddr = baseAddr + idx * sizeof(RefField<>);
                 if (fieldAddr >= rangeEnd) {
                     return;
                 }
-                VisitRefField(bitmapWord, fieldAddr, visitor);
+                visitor(*reinterpret_cast<RefField<>*>(fieldAddr));
+                bitmapWord &= bitmapWord - 1; // clear the lowest ref bit.
             }
-
             // go next bitmap word.
-            baseAddr += (sizeof(RefField<>) * REFS_PER_BIT_WORD);
+            baseAddr += mapWordSize;
         }
     }
+    void ForEachBitmapWordInRange(MAddress contentAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
+                                  MAddress rangeEnd) const
+    {
+        ForEachRefInRange(contentAddr, visitor, rangeStart, rangeEnd);
+    }
 };
 
 union GCTib {
@@ -353,17 +358,25 @@ union GCTib {
 #endif
     }
 
-    void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
+    // compile-time specialized version of ForEachBitmapWord, prefer it on hot paths where visitor is a lambda.
+    template<typename Visitor>
+    void ForEachRef(MAddress contentAddr, Visitor&& visitor) const
     {
         if (IsGCTibWord()) {
-            bitmap.ForEachBitmapWord(contentAddr, visitor);
+            bitmap.ForEachRef(contentAddr, visitor);
         } else {
-            gctib->ForEachBitmapWord(contentAddr, visitor);
+            gctib->ForEachRef(contentAddr, visitor);
         }
     }
 
-    void ForEachBitmapWordInRange(MAddress contentAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
-                                  MAddress rangeEnd) const
+    void ForEachBitmapWord(MAddress contentAddr, const RefFieldVisitor& visitor) const
+    {
+        ForEachRef(contentAddr, visitor);
+    }
+
+    // compile-time specialized version of ForEachBitmapWordInRange.
+    template<typename Visitor>
+    void ForEachRefInRange(MAddress contentAddr, Visitor&& visitor, MAddress rangeStart, MAddress rangeEnd) const
     {
 #ifdef __arm__
         rangeStart = ((rangeStart + 3) & (~3)); // 3: upper aligned to 4
@@ -374,11 +387,17 @@ union GCTib {
             return;
         }
         if (IsGCTibWord()) {
-            bitmap.ForEachBitmapWordInRange(contentAddr, visitor, rangeStart, rangeEnd);
+            bitmap.ForEachRefInRange(contentAddr, visitor, rangeStart, rangeEnd);
         } else {
-            gctib->ForEachBitmapWordInRange(contentAddr, visitor, rangeStart, rangeEnd);
+            gctib->ForEachRefInRange(contentAddr, visitor, rangeStart, rangeEnd);
         }
     }
+
+    void ForEachBitmapWordInRange(MAddress contentAddr, const RefFieldVisitor& visitor, MAddress rangeStart,
+                                  MAddress rangeEnd) const
+    {
+        ForEachRefInRange(contentAddr, visitor, rangeStart, rangeEnd);
+    }
 };
 
 struct FieldNames {
@@ -42,6 +42,7 @@
 #include "StackMap/StackMap.h"
 #endif
 #include "CpuProfiler/CpuProfiler.h"
+#include "LoaderManager.h"
 #include "Interpreter/InterpreterSpecific.h"
 #include "Interpreter/Options.h"
 
@@ -140,6 +141,62 @@ void StackManager::PrintStackTraceForCpuProfile(UnwindContext* unContext, unsign
     CpuProfiler::GetInstance().GetGenerator().Post(cjThreadId, funcDescRefs, frameTypes, lineNumbers);
 }
 
+#if defined(CPU_PROFILER_SIGNAL_SAMPLING)
+// A managed function saves its start pc below its frame address. The value read from a sampled frame is trusted only
+// if it is before the pc and in the same cangjie file.
+static bool IsManagedFrameForCpuProfile(uintptr_t pc, uintptr_t startPC, const Dl_info& pcInfo)
+{
+    constexpr uintptr_t maxFuncSize = 16 * 1024 * 1024;
+    if (startPC == 0 || startPC > pc || pc - startPC > maxFuncSize || pcInfo.dli_fname == nullptr) {
+        return false;
+    }
+    Dl_info startInfo;
+    if (dladdr(reinterpret_cast<void*>(startPC), &startInfo) == 0 || startInfo.dli_fbase != pcInfo.dli_fbase) {
+        return false;
+    }
+    // only called by the sampling thread.
+    static std::map<void*, bool> cangjieFiles;
+    auto it = cangjieFiles.find(pcInfo.dli_fbase);
+    if (it == cangjieFiles.end()) {
+        LoaderManager* loaderManager = LoaderManager::GetInstance();
+        bool loaded = loaderManager != nullptr && loaderManager->FileHasLoaded(pcInfo.dli_fname);
+        it = cangjieFiles.emplace(pcInfo.dli_fbase, loaded).first;
+    }
+    return it->second;
+}
+
+void StackManager::PostRawSampleForCpuProfile(const RawSample& sample)
+{
+    std::vector<uint64_t> funcIdentifiers;
+    std::vector<FrameType> frameTypes;
+    std::vector<uint32_t> lineNumbers;
+    for (uint32_t i = 0; i < sample.frameCount; ++i) {
+        uintptr_t pc = sample.pcs[i];
+        Dl_info pcInfo;
+        if (dladdr(reinterpret_cast<void*>(pc), &pcInfo) == 0) {
+            pcInfo.dli_fname = nullptr;
+            pcInfo.dli_saddr = nullptr;
+        }
+        if (!IsRuntimeFrame(pc) && IsManagedFrameForCpuProfile(pc, sample.startPCs[i], pcInfo)) {
+            FuncDescRef funcDesc = MFuncDesc::GetFuncDesc(static_cast<Uptr>(sample.startPCs[i]));
+            StackMapBuilder stackMapBuild(sample.startPCs[i], pc, 0, reinterpret_cast<uint64_t*>(funcDesc));
+            MethodMap methodMap = stackMapBuild.Build<MethodMap>();
+            funcIdentifiers.emplace_back(reinterpret_cast<uint64_t>(funcDesc));
+            frameTypes.emplace_back(FrameType::MANAGED);
+            lineNumbers.emplace_back(methodMap.IsValid() ? methodMap.GetLineNum() : 0);
+            continue;
+        }
+        // native and runtime frames are merged by their symbols.
+        uintptr_t symbol = pcInfo.dli_saddr == nullptr ? pc : reinterpret_cast<uintptr_t>(pcInfo.dli_saddr);
+        funcIdentifiers.emplace_back(static_cast<uint64_t>(symbol));
+        frameTypes.emplace_back(IsRuntimeFrame(pc) ? FrameType::RUNTIME : FrameType::NATIVE);
+        lineNumbers.emplace_back(0);
+    }
+    CpuProfiler::GetInstance().GetGenerator().Post(sample.cjThreadId, funcIdentifiers, frameTypes, lineNumbers,
+                                                   sample.timeStamp);
+}
+#endif
+
 void StackManager::RecordLiteFrameInfos(std::vector<uint64_t>& liteFrameInfos, size_t steps)
 {
     PrintStackInfo printStackInfo;
@@ -159,11 +216,19 @@ void StackManager::GetStackTraceByLiteFrameInfo(const uint64_t ip, const uint64_
     StackInfo::GetStackTraceByLiteFrameInfo(ip, pc, funcDesc, ste);
 }
 
-void StackManager::VisitStackRoots(const UnwindContext& topFrame, const RootVisitor& func, Mutator& mutator)
+size_t StackManager::VisitStackRoots(const UnwindContext& topFrame, const RootVisitor& func, Mutator& mutator,
+                                     size_t* stackBytes)
 {
     GCStackInfo gcStackInfo(&topFrame);
     gcStackInfo.FillInStackTrace();
     gcStackInfo.VisitStackRoots(func, mutator);
+    std::vector<FrameInfo>& frames = gcStackInfo.GetStack();
+    if (stackBytes != nullptr) {
+        *stackBytes = frames.empty() ? 0 :
+            reinterpret_cast<uintptr_t>(frames.back().mFrame.GetFA()) -
+            reinterpret_cast<uintptr_t>(frames.front().mFrame.GetFA());
+    }
+    return frames.size();
 }
 
 void StackManager::VisitHeapReferencesOnStack(const UnwindContext& topFrame, const RootVisitor& rootVisitor,
@@ -16,6 +16,8 @@
 #include "UnwindStack/StackInfo.h"
 
 namespace MapleRuntime {
+struct RawSample;
+
 class StackManager {
 public:
     StackManager();
@@ -61,6 +63,9 @@ public:
 
     static void PrintStackTraceForCpuProfile(UnwindContext* unContext, unsigned long long int cjThreadId);
 
+    // classify and post frames of a stack sampled by SIGPROF, called by the cpu profiler sampling thread.
+    static void PostRawSampleForCpuProfile(const RawSample& sample);
+
     static void RecordLiteFrameInfos(std::vector<uint64_t>& liteFrameInfos, size_t steps = STACK_UNWIND_STEP_MAX);
 
     static void GetStackTraceByLiteFrameInfos(const std::vector<uint64_t>& liteFrameInfos,
@@ -69,8 +74,10 @@ public:
     static void GetStackTraceByLiteFrameInfo(const uint64_t ip, const uint64_t pc, const uint64_t funcDesc,
                                              StackTraceElement& ste);
 
-    // visit GC roots of current managed thread for tracing GC.
-    static void VisitStackRoots(const UnwindContext& topFrame, const RootVisitor& func, Mutator& mutator);
+    // visit GC roots of current managed thread for tracing GC, return the number of unwound frames.
+    // stackBytes is set to the distance between the top and the bottom unwound frame if it is not null.
+    static size_t VisitStackRoots(const UnwindContext& topFrame, const RootVisitor& func, Mutator& mutator,
+                                  size_t* stackBytes = nullptr);
     static void VisitHeapReferencesOnStack(const UnwindContext& topFrame, const RootVisitor& rootVisitor,
                                            const DerivedPtrVisitor& derivedPtrVisitor, Mutator& mutator);
 
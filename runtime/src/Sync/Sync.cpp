@@ -11,6 +11,7 @@
 #include "Base/TimeUtils.h"
 #include "schedule.h"
 #include "Concurrency/ConcurrencyModel.h"
+#include "CpuProfiler/ContentionProfiler.h"
 #if defined(CANGJIE_TSAN_SUPPORT)
 #include "Sanitizer/SanitizerInterface.h"
 #endif
@@ -196,7 +197,10 @@ static void DoSpin()
     }
 }
 
-static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
+// waitBegin is set if the current thread blocks and lock profiling is enabled, and so is sample if the contention is
+// sampled.
+static bool MutexAcquireSlowPath(CJMutex* mutex, uint64_t count, LockKind kind, uint64_t& waitBegin,
+                                 ContentionProfiler::Sample*& sample)
 {
     int64_t currThreadId = MRT_GetCurrentThreadID();
     if (mutex->ownerThreadId.load(std::memory_order_acquire) == currThreadId) {
@@ -282,6 +286,13 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
         bool isPushToHead = firstWaitTime != 0;
         if (firstWaitTime == 0) {
             firstWaitTime = TimeUtil::MicroSeconds();
+            waitBegin = ContentionProfiler::WaitBegin();
+            if (waitBegin != 0) {
+                sample = ContentionProfiler::Instance().CaptureWaiter(kind);
+                // capturing the stack is not counted as delay.
+                waitBegin = TimeUtil::NanoSeconds();
+                ContentionProfiler::Instance().OnWaiting(kind, mutex, waitBegin);
+            }
         }
         Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
         MRT_SemAcquire(&mutex->sema, isPushToHead);
@@ -336,14 +347,26 @@ static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count)
     return false; // Unreachable
 }
 
+static bool MCC_MutexLockSlowPathImpl(CJMutex* mutex, uint64_t count, LockKind kind)
+{
+    uint64_t waitBegin = 0;
+    ContentionProfiler::Sample* sample = nullptr;
+    bool res = MutexAcquireSlowPath(mutex, count, kind, waitBegin, sample);
+    if (UNLIKELY(waitBegin != 0)) {
+        ContentionProfiler::Instance().WaitEnd(kind, mutex, waitBegin, sample);
+    }
+    return res;
+}
+
 /**
  * @brief Acquire the mutex.
  * @param ptr: raw pointer of a `CJMutex`.
  * @param count: number of acquision to hold the mutex.
+ * @param kind: the sync object owning the mutex, which is reported by lock profiling.
  * @return true if succeed in holding the mutex.
  * @return false if fail to acquire the mutex.
  */
-static bool MCC_MutexLockImpl(const void* ptr, uint64_t count)
+static bool MCC_MutexLockImpl(const void* ptr, uint64_t count, LockKind kind)
 {
     CJMutex* mutex = CastToT<CJMutex*>(ptr);
     int64_t expected = 0;
@@ -357,7 +380,7 @@ static bool MCC_MutexLockImpl(const void* ptr, uint64_t count)
 #endif
         return true;
     }
-    bool res = MCC_MutexLockSlowPathImpl(mutex, count);
+    bool res = MCC_MutexLockSlowPathImpl(mutex, count, kind);
     return res;
 }
 
@@ -366,11 +389,11 @@ static bool MCC_MutexLockImpl(const void* ptr, uint64_t count)
  * @param ptr: raw pointer of a `CJMutex`.
  * Current thread may be blocked until hold the mutex
  */
-void MCC_MutexLock(void* ptr) { MCC_MutexLockImpl(ptr, 1); }
+void MCC_MutexLock(void* ptr) { MCC_MutexLockImpl(ptr, 1, LockKind::CJ_MUTEX); }
 
 void MCC_MutexLockSlowPath(void* ptr)
 {
-    MCC_MutexLockSlowPathImpl(CastToT<CJMutex*>(ptr), 1);
+    MCC_MutexLockSlowPathImpl(CastToT<CJMutex*>(ptr), 1, LockKind::CJ_MUTEX);
 }
 
 /**
@@ -422,13 +445,7 @@ bool MCC_MutexCheckStatus(const void* ptr)
     return mutex->ownerThreadId.load(std::memory_order_acquire) == curThreadId;
 }
 
-/**
- * @brief If mutex is locked recursively, this method should be invoked N times to fully unlock mutex.
- * In Cangjie program, `checkStatus` must be called before this function.
- * @param ptr: raw pointer of a `CJMutex`.
- * @param count: number of acquision to release the mutex.
- */
-static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
+static void MutexRelease(const void* ptr, uint64_t count)
 {
     CJMutex* mutex = CastToT<CJMutex*>(ptr);
     MRT_ASSERT(IsLocked(mutex->state.load()), "Sync error: unlock an unlocked mutex");
@@ -482,12 +499,28 @@ static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
     }
 }
 
+/**
+ * @brief If mutex is locked recursively, this method should be invoked N times to fully unlock mutex.
+ * In Cangjie program, `checkStatus` must be called before this function.
+ * @param ptr: raw pointer of a `CJMutex`.
+ * @param count: number of acquision to release the mutex.
+ */
+static void MRT_MutexUnlockImpl(const void* ptr, uint64_t count)
+{
+    bool released = CastToT<CJMutex*>(ptr)->ownCount == count;
+    MutexRelease(ptr, count);
+    // contention is recorded after the mutex is released and its waiter is woken up.
+    if (UNLIKELY(ContentionProfiler::IsEnabled()) && released) {
+        ContentionProfiler::Instance().OnUnlock(ptr);
+    }
+}
+
 void MCC_MutexUnlock(const void* ptr) { MRT_MutexUnlockImpl(ptr, 1); }
 
 // =====================================================
 // Following functions are used to implement monitors.
 // =====================================================
-static void MRT_MutexFullyLock(void* ptr, uint64_t count) { MCC_MutexLockImpl(ptr, count); }
+static void MRT_MutexFullyLock(void* ptr, uint64_t count, LockKind kind) { MCC_MutexLockImpl(ptr, count, kind); }
 
 /**
  * @brief Fully unlock a mutex.
@@ -529,7 +562,7 @@ int MCC_WaitQueueInit(void* ptr)
     return ret;
 }
 
-bool MonitorWait(CJMutex* mutex, void* wq, int64_t timeout)
+bool MonitorWait(CJMutex* mutex, void* wq, int64_t timeout, LockKind kind)
 {
     // 1. Keep the #mutex-hold before release the mutex.
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
@@ -537,7 +570,7 @@ bool MonitorWait(CJMutex* mutex, void* wq, int64_t timeout)
     // 2. Release and wait
     bool wakeStatus = MRT_SuspendWithTimeout(wq, MRT_MutexFullyUnlock, mutex, timeout);
     // 3. Hold the mutex again
-    MRT_MutexFullyLock(mutex, ownCount);
+    MRT_MutexFullyLock(mutex, ownCount, kind);
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     if (wakeStatus) {
         // Notified by other threads
@@ -563,7 +596,7 @@ bool MCC_MonitorWait(const void* ptr, int64_t timeout)
     CJMutex* mutex = monitor->mutexPtr;
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(monitor));
-    bool ret = MonitorWait(mutex, &monitor->wq, timeout);
+    bool ret = MonitorWait(mutex, &monitor->wq, timeout, LockKind::CJ_MONITOR);
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(monitor));
     return ret;
@@ -595,7 +628,8 @@ bool MCC_MultiConditionMonitorWait(const void* ptr, void* waitQueuePtr, int64_t
     CJMutex* mutex = monitor->mutexPtr;
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     Heap::GetHeap().GetCollector().AddRawPointerObject(reinterpret_cast<BaseObject*>(waitQueuePtr));
-    bool ret = MonitorWait(mutex, &CastToT<CJWaitQueue*>(waitQueuePtr)->wq, timeout);
+    bool ret = MonitorWait(mutex, &CastToT<CJWaitQueue*>(waitQueuePtr)->wq, timeout,
+                           LockKind::CJ_MULTI_CONDITION_MONITOR);
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(mutex));
     Heap::GetHeap().GetCollector().RemoveRawPointerObject(reinterpret_cast<BaseObject*>(waitQueuePtr));
     return ret;
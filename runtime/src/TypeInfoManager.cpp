@@ -11,8 +11,60 @@
 #include "ObjectModel/MClass.h"
 #include "ObjectManager.inline.h"
 #include "Sync/Sync.h"
+#include "CpuProfiler/ContentionProfiler.h"
 
 namespace MapleRuntime {
+// bucket locks spin with sched_yield, whose contention is recorded by lock profiling.
+static void LockBucketRead(RwLock& rwLock)
+{
+    uint64_t beginTime = 0;
+    ContentionProfiler::Sample* sample = nullptr;
+    if (UNLIKELY(ContentionProfiler::IsEnabled())) {
+        if (rwLock.TryLockRead()) {
+            return;
+        }
+        sample = ContentionProfiler::Instance().CaptureWaiter(LockKind::TYPE_INFO_BUCKET);
+        beginTime = TimeUtil::NanoSeconds();
+    }
+    rwLock.LockRead();
+    if (beginTime != 0) {
+        ContentionProfiler::Instance().WaitEnd(LockKind::TYPE_INFO_BUCKET, &rwLock, beginTime, sample);
+    }
+}
+
+static void UnlockBucketRead(RwLock& rwLock)
+{
+    rwLock.UnlockRead();
+    if (UNLIKELY(ContentionProfiler::IsEnabled())) {
+        ContentionProfiler::Instance().FlushSamples();
+    }
+}
+
+static void LockBucketWrite(RwLock& rwLock)
+{
+    uint64_t beginTime = 0;
+    ContentionProfiler::Sample* sample = nullptr;
+    if (UNLIKELY(ContentionProfiler::IsEnabled())) {
+        if (rwLock.TryLockWrite()) {
+            return;
+        }
+        sample = ContentionProfiler::Instance().CaptureWaiter(LockKind::TYPE_INFO_BUCKET);
+        beginTime = TimeUtil::NanoSeconds();
+    }
+    rwLock.LockWrite();
+    if (beginTime != 0) {
+        ContentionProfiler::Instance().WaitEnd(LockKind::TYPE_INFO_BUCKET, &rwLock, beginTime, sample);
+    }
+}
+
+static void UnlockBucketWrite(RwLock& rwLock)
+{
+    rwLock.UnlockWrite();
+    if (UNLIKELY(ContentionProfiler::IsEnabled())) {
+        ContentionProfiler::Instance().FlushSamples();
+    }
+}
+
 void TypeGCInfo::FillTypeGCInfo(TypeInfo* ti, CString &gcTibStr, U32 &curSize)
 {
     U32 ptrSize = sizeof(void*);
@@ -310,17 +362,17 @@ TypeInfoManager::GenericTiDesc* TypeInfoManager::GenericTiDescHashMap::GetGeneri
     const U32 h = desc.GetHash();
     const size_t bucketIdx = h % buckets.size();
     auto &bucket = buckets[bucketIdx];
-    bucket.rwLock.LockRead();
+    LockBucketRead(bucket.rwLock);
     auto it = bucket.maps.find(h);
     if (it != bucket.maps.end()) {
         for (auto descIt = it->second.begin(); descIt != it->second.end(); ++descIt) {
             if (**descIt == desc) {
-                bucket.rwLock.UnlockRead();
+                UnlockBucketRead(bucket.rwLock);
                 return *descIt;
             }
         }
     }
-    bucket.rwLock.UnlockRead();
+    UnlockBucketRead(bucket.rwLock);
     return nullptr;
 }
 
@@ -329,12 +381,12 @@ TypeInfoManager::GenericTiDesc* TypeInfoManager::GenericTiDescHashMap::InsertGen
     const U32 h = desc.GetHash();
     const size_t bucketIdx = h % buckets.size();
     auto &bucket = buckets[bucketIdx];
-    bucket.rwLock.LockWrite();
+    LockBucketWrite(bucket.rwLock);
     auto it = bucket.maps.find(h);
     if (it != bucket.maps.end()) {
         for (auto descIt = it->second.begin(); descIt != it->second.end(); ++descIt) {
             if (**descIt == desc) {
-                bucket.rwLock.UnlockWrite();
+                UnlockBucketWrite(bucket.rwLock);
                 return *descIt;
             }
         }
@@ -342,7 +394,7 @@ TypeInfoManager::GenericTiDesc* TypeInfoManager::GenericTiDescHashMap::InsertGen
     GenericTiDesc* tiDesc = new (std::nothrow) GenericTiDesc(desc);
     CHECK_DETAIL(tiDesc != nullptr, "fail to allocate GenericTiDesc");
     bucket.maps[h].push_back(tiDesc);
-    bucket.rwLock.UnlockWrite();
+    UnlockBucketWrite(bucket.rwLock);
     return tiDesc;
 }
 
@@ -251,6 +251,7 @@ make_cangjie_lib(
         std-io
         std-time
         std-collection
+        std-sync
     CANGJIE_STD_LIB_INDIRECT_DEPENDS
         std-math
         std-sort
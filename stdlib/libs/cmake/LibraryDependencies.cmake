@@ -89,7 +89,8 @@ set(FS_DEPENDENCIES
     cangjie${BACKEND_TYPE}Core
     cangjie${BACKEND_TYPE}Io
     cangjie${BACKEND_TYPE}Time
-    cangjie${BACKEND_TYPE}Collection)
+    cangjie${BACKEND_TYPE}Collection
+    cangjie${BACKEND_TYPE}Sync)
 
 set(CONSOLE_DEPENDENCIES
     ${STD_CORE_DEPENDENCIES}
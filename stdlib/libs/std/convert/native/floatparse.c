@@ -7,10 +7,14 @@
  */
 
 #define _GNU_SOURCE
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <float.h>
 #include <string.h>
 #include <locale.h>
 #include <stdatomic.h>
+#include "securec.h"
 
 #if defined(__APPLE__)
 #include <xlocale.h>
@@ -21,14 +25,109 @@
 #define HAS_STRTOD_L 0
 #endif
 
-extern double* CJ_STRTOD(char* str)
+#define PARSE_BUFFER_SIZE 64
+#define DECIMAL 10
+#define MAX_EXACT_DIGITS 19       /* 10^19 - 1 fits in uint64_t */
+#define MAX_EXACT_MANTISSA (1ULL << 53)
+#define MAX_EXACT_POW10 22        /* 10^22 is the largest power of 10 which is exact in double */
+#define MAX_EXPONENT_DIGITS 100000
+
+static const double g_exactPow10[MAX_EXACT_POW10 + 1] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+/*
+ * Clinger's fast path: a decimal w * 10^e with w <= 2^53 and |e| <= 22 is correctly rounded by a single
+ * multiplication or division of two exact doubles. Only the plain [+-]digits[.digits][(e|E)[+-]digits]
+ * syntax is handled, return false for anything else and let strtod decide.
+ */
+static bool ParseFloat64Fast(const uint8_t* str, int64_t len, double* value)
 {
-    if (str == NULL) {
-        return NULL;
+#if defined(FLT_EVAL_METHOD) && FLT_EVAL_METHOD == 0
+    int64_t i = 0;
+    bool negative = false;
+    if (i < len && (str[i] == '+' || str[i] == '-')) {
+        negative = str[i] == '-';
+        i++;
     }
-    char* p = NULL;
-    double value;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int64_t exponent = 0;
+    bool hasDigit = false;
+    bool inFraction = false;
+    for (; i < len; i++) {
+        uint8_t c = str[i];
+        if (c == '.' && !inFraction) {
+            inFraction = true;
+            continue;
+        }
+        if (c < '0' || c > '9') {
+            break;
+        }
+        hasDigit = true;
+        if (inFraction) {
+            exponent--;
+        }
+        if (mantissa == 0 && c == '0') {
+            continue; /* leading zeros are not significant */
+        }
+        if (digits == MAX_EXACT_DIGITS) {
+            return false;
+        }
+        mantissa = mantissa * DECIMAL + (uint64_t)(c - '0');
+        digits++;
+    }
+    if (!hasDigit) {
+        return false;
+    }
+    if (i < len && (str[i] == 'e' || str[i] == 'E')) {
+        i++;
+        bool negativeExponent = false;
+        if (i < len && (str[i] == '+' || str[i] == '-')) {
+            negativeExponent = str[i] == '-';
+            i++;
+        }
+        if (i == len) {
+            return false;
+        }
+        int64_t e = 0;
+        for (; i < len && str[i] >= '0' && str[i] <= '9'; i++) {
+            e = e * DECIMAL + (str[i] - '0');
+            if (e >= MAX_EXPONENT_DIGITS) {
+                return false;
+            }
+        }
+        exponent += negativeExponent ? -e : e;
+    }
+    if (i != len) {
+        return false;
+    }
+    if (mantissa == 0) {
+        *value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (mantissa > MAX_EXACT_MANTISSA || exponent < -MAX_EXACT_POW10 || exponent > MAX_EXACT_POW10) {
+        return false;
+    }
+    double result = (double)mantissa;
+    if (exponent < 0) {
+        result /= g_exactPow10[-exponent];
+    } else {
+        result *= g_exactPow10[exponent];
+    }
+    *value = negative ? -result : result;
+    return true;
+#else
+    (void)str;
+    (void)len;
+    (void)value;
+    return false;
+#endif
+}
 
+static double StrToD(const char* str, char** end)
+{
 #if HAS_STRTOD_L
     static locale_t cLocale = NULL;
     static atomic_int localeInitState = 0;
@@ -44,21 +143,47 @@ extern double* CJ_STRTOD(char* str)
     while (atomic_load(&localeInitState) == 1) {
     }
     if (cLocale != NULL) {
-        value = strtod_l(str, &p, cLocale);
-    } else {
-        value = strtod(str, &p);
+        return strtod_l(str, end, cLocale);
     }
-#else
-    value = strtod(str, &p);
 #endif
+    return strtod(str, end);
+}
 
-    if (p == NULL || strlen(p) > 0) {
-        return NULL;
+/*
+ * Parse the whole str of len bytes as a double, return false if it is not a valid floating point number.
+ * Plain decimals are parsed in place, the rest are copied into a C string for strtod.
+ */
+extern bool CJ_CONVERT_ParseFloat64(const uint8_t* str, int64_t len, double* value)
+{
+    if (str == NULL || len < 0 || value == NULL) {
+        return false;
+    }
+    if (ParseFloat64Fast(str, len, value)) {
+        return true;
+    }
+    char buffer[PARSE_BUFFER_SIZE];
+    char* cStr = buffer;
+    if (len >= PARSE_BUFFER_SIZE) {
+        cStr = (char*)malloc((size_t)len + 1);
+        if (cStr == NULL) {
+            return false;
+        }
+    }
+    if (len > 0 && memcpy_s(cStr, (size_t)len + 1, str, (size_t)len) != EOK) {
+        if (cStr != buffer) {
+            free(cStr);
+        }
+        return false;
+    }
+    cStr[len] = '\0';
+    char* p = NULL;
+    double result = StrToD(cStr, &p);
+    bool valid = p != NULL && *p == '\0';
+    if (cStr != buffer) {
+        free(cStr);
     }
-    double* floatNumber = (double*)malloc(sizeof(double));
-    if (floatNumber == NULL) {
-        return NULL;
+    if (valid) {
+        *value = result;
     }
-    *floatNumber = value;
-    return floatNumber;
-}
\ No newline at end of file
+    return valid;
+}
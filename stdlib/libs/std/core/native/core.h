@@ -22,19 +22,21 @@
 #define EOK 0
 #endif
 
-typedef struct StrptrParameter {
-    const uint8_t* ptr;
-    int64_t size;
-} Strptr;
-
 bool CJ_CORE_CanUseSIMD(void);
 
 int64_t CJ_CORE_FromCharToUtf8(uint32_t c, uint8_t* itemBytes);
 
-void CJ_CORE_HashStr(const uint8_t* str, int64_t strSize, uint32_t* hash, uint32_t* pow);
-void CJ_CORE_HashStrRev(const uint8_t* str, int64_t strSize, uint32_t* hash, uint32_t* pow);
-int64_t CJ_CORE_RabinKarp(Strptr* org, Strptr* sub, uint32_t hashP, uint32_t pow);
-int64_t CJ_CORE_RabinKarpR(Strptr* org, Strptr* sub, uint32_t hashP, uint32_t pow);
+typedef struct TwoWayParameter {
+    const uint8_t* sub;
+    int64_t size;
+    int64_t critPos; // start of the right half of the critical factorization
+    int64_t period;
+    int64_t memory;  // prefix known to match after a shift by period, 0 if sub is not periodic
+    bool reverse;
+} TwoWay;
+
+void CJ_CORE_TwoWayInit(TwoWay* tw, const uint8_t* sub, int64_t subSize, bool reverse);
+int64_t CJ_CORE_TwoWaySearch(const TwoWay* tw, const uint8_t* org, int64_t orgSize);
 int64_t CJ_CORE_IndexOfByte(const uint8_t* orgStr, int64_t orgSize, uint8_t pat);
 int64_t CJ_CORE_LastIndexOfByte(const uint8_t* orgStr, int64_t orgSize, uint8_t pat);
 int64_t CJ_CORE_CountOfByte(const uint8_t* orgStr, int64_t orgSize, uint8_t pat);
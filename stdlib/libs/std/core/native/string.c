@@ -15,6 +15,7 @@
 #define MAXLENTH_INT64 21
 
 #define FL_TO_STR_MAX 512 /* 512 is the maxlength of double to string size */
+#define FLOAT_DEFAULT_PRECISION 6 /* precision of "%f" */
 
 static uint8_t* CloneString(const uint8_t* temp, const int size)
 {
@@ -34,20 +35,163 @@ static uint8_t* CloneString(const uint8_t* temp, const int size)
     return ret;
 }
 
-extern uint8_t* CJ_CORE_Float64ToCPointer(const double num)
+#ifdef __SIZEOF_INT128__
+#define FIXED_MAX_PRECISION 22 /* m * 10^22 < 2^53 * 2^74 always fits in 128 bits */
+#define FIXED_MANTISSA_BITS 52
+#define FIXED_EXPONENT_MASK 0x7FF
+#define FIXED_EXPONENT_BIAS 1075
+#define FIXED_MAX_EXPONENT 11 /* m < 2^53, so m * 2^e fits in 64 bits if e <= 11 */
+
+/*
+ * Print a finite double as "%.{precision}f" does, without going through the printf machinery.
+ * The double is m * 2^e exactly, so m * 10^precision * 2^e is computed in 128-bit integers and rounded
+ * to nearest, ties to even, exactly as glibc rounds "%f".
+ * Return the size written, excluding the terminating '\0', or -1 if the value is out of range
+ * of the fast path or the buffer is too small, then the caller falls back to snprintf.
+ */
+static int64_t FormatFixedFast(const double num, const int64_t precision, uint8_t* dest, const int64_t destMax)
 {
+    if (precision < 0 || precision > FIXED_MAX_PRECISION) {
+        return -1;
+    }
+    uint64_t bits;
+    (void)memcpy_s(&bits, sizeof(bits), &num, sizeof(num));
+    bool negative = (bits >> 63) != 0;
+    int32_t biased = (int32_t)((bits >> FIXED_MANTISSA_BITS) & FIXED_EXPONENT_MASK);
+    uint64_t mantissa = bits & ((1ULL << FIXED_MANTISSA_BITS) - 1);
+    if (biased == FIXED_EXPONENT_MASK) {
+        return -1;
+    }
+    int32_t exponent = 1 - FIXED_EXPONENT_BIAS;
+    if (biased != 0) {
+        mantissa |= 1ULL << FIXED_MANTISSA_BITS;
+        exponent = biased - FIXED_EXPONENT_BIAS;
+    }
+    __uint128_t scale = 1;
+    for (int64_t i = 0; i < precision; i++) {
+        scale *= DECIMAL;
+    }
+    uint64_t integer;
+    __uint128_t fraction = 0;
+    if (exponent >= 0) {
+        if (exponent > FIXED_MAX_EXPONENT) {
+            return -1;
+        }
+        integer = mantissa << exponent;
+    } else {
+        /* scaled is the value multiplied by 10^precision and rounded to an integer, integer part < 2^53. */
+        __uint128_t product = (__uint128_t)mantissa * scale;
+        int32_t shift = -exponent;
+        __uint128_t scaled = 0; /* product < 2^127, less than half of 2^shift if shift >= 128 */
+        if (shift < 128) {
+            scaled = product >> shift;
+            __uint128_t rest = product - (scaled << shift);
+            __uint128_t half = (__uint128_t)1 << (shift - 1);
+            if (rest > half || (rest == half && (scaled & 1) != 0)) {
+                scaled++;
+            }
+        }
+        integer = (uint64_t)(scaled / scale);
+        fraction = scaled - (__uint128_t)integer * scale;
+    }
+
+    uint8_t buff[MAXLENTH_INT64 + FIXED_MAX_PRECISION + 2]; /* sign, integer, '.' and fraction */
+    int64_t size = 0;
+    if (negative) {
+        buff[size++] = '-';
+    }
+    uint8_t digits[MAXLENTH_INT64];
+    int64_t digitLen = 0;
+    do {
+        digits[digitLen++] = (uint8_t)(integer % DECIMAL) + '0';
+        integer /= DECIMAL;
+    } while (integer != 0);
+    while (digitLen > 0) {
+        buff[size++] = digits[--digitLen];
+    }
+    if (precision > 0) {
+        buff[size++] = '.';
+        for (int64_t i = precision - 1; i >= 0; i--) {
+            buff[size + i] = (uint8_t)(fraction % DECIMAL) + '0';
+            fraction /= DECIMAL;
+        }
+        size += precision;
+    }
+    /* keep room for '\0' as snprintf_s does */
+    if (size >= destMax) {
+        return -1;
+    }
+    (void)memcpy_s(dest, (size_t)destMax, buff, (size_t)size);
+    dest[size] = '\0';
+    return size;
+}
+#else
+static int64_t FormatFixedFast(const double num, const int64_t precision, uint8_t* dest, const int64_t destMax)
+{
+    (void)num;
+    (void)precision;
+    (void)dest;
+    (void)destMax;
+    return -1;
+}
+#endif
+
+/*
+ * Format the double as "%.{precision}f" into dest, return the size excluding '\0' or -1 on failure.
+ */
+static int64_t Float64ToFixed(const double num, const int64_t precision, uint8_t* dest, const int64_t destMax)
+{
+    if (destMax <= 0 || dest == NULL || precision < 0) {
+        return -1;
+    }
+    int64_t size = FormatFixedFast(num, precision, dest, destMax);
+    if (size >= 0) {
+        return size;
+    }
+    size_t newSize = FL_TO_STR_MAX; // 512
+    if (destMax < FL_TO_STR_MAX) {
+        newSize = (size_t)destMax;
+    }
+    return snprintf_s((char*)dest, newSize, newSize - 1, "%.*f", (int)precision, num);
+}
+
+/*
+ * Format the double as Float64.toString does into dest, without the terminating '\0'.
+ * Return the size written, or -1 if the buffer is too small.
+ */
+extern int64_t CJ_CORE_Float64ToBuffer(const double num, uint8_t* dest, const int64_t destMax)
+{
+    if (destMax <= 0 || dest == NULL) {
+        return -1;
+    }
     uint8_t temp[FL_TO_STR_MAX]; // 512
-    int size;
+    int64_t size;
     if (isnan(num)) {
         // Nan doesn't have a sign in cangjie. So, we should always print nan.
         size = snprintf_s((char*)temp, FL_TO_STR_MAX, FL_TO_STR_MAX - 1, "%s", "nan");
     } else {
+        size = FormatFixedFast(num, FLOAT_DEFAULT_PRECISION, dest, destMax);
+        if (size >= 0) {
+            return size;
+        }
         size = snprintf_s((char*)temp, FL_TO_STR_MAX, FL_TO_STR_MAX - 1, "%f", num);
     }
+    if (size <= 0 || size > destMax) {
+        return -1;
+    }
+    (void)memcpy_s(dest, (size_t)destMax, temp, (size_t)size);
+    return size;
+}
+
+extern uint8_t* CJ_CORE_Float64ToCPointer(const double num)
+{
+    uint8_t temp[FL_TO_STR_MAX]; // 512
+    int64_t size = CJ_CORE_Float64ToBuffer(num, temp, FL_TO_STR_MAX - 1);
     if (size <= 0) {
         return NULL;
     }
-    return CloneString(temp, size + 1);
+    temp[size] = '\0';
+    return CloneString(temp, (int)size + 1);
 }
 
 extern int64_t CJ_BUFFER_Int64ToCPointer(const int64_t num, uint8_t* dest, const int64_t destMax)
@@ -96,15 +240,12 @@ extern int64_t CJ_BUFFER_UInt64ToCPointer(const uint64_t num, uint8_t* dest, con
 
 extern int64_t CJ_BUFFER_Float64ToCPointer(const double num, uint8_t* buf, const int64_t destMax)
 {
-    if (destMax <= 0 || NULL == buf) {
-        return -1;
-    }
-    size_t newSize = FL_TO_STR_MAX; // 512
-    if (destMax < FL_TO_STR_MAX) {
-        newSize = (size_t)destMax;
-    }
-    int size = snprintf_s((char*)buf, newSize, newSize - 1, "%f", num);
-    return size;
+    return Float64ToFixed(num, FLOAT_DEFAULT_PRECISION, buf, destMax);
+}
+
+extern int64_t CJ_BUFFER_Float64ToFixed(const double num, const int64_t precision, uint8_t* buf, const int64_t destMax)
+{
+    return Float64ToFixed(num, precision, buf, destMax);
 }
 
 extern int64_t CJ_CORE_StringMemcmp(const uint8_t* str1, const uint8_t* str2, const size_t n)
@@ -123,6 +264,95 @@ extern int64_t CJ_CORE_CountString(const uint8_t* orgStr, const uint8_t* subStr,
 extern int64_t* CJ_CORE_CountAndIndexString(
     const uint8_t* orgStr, const uint8_t* subStr, int64_t orgSize, int64_t subSize);
 
+#define SIMD_NEEDLE_MAX 16
+
+/*
+ * The SIMD searches filter candidates by the first and last bytes of a needle, and then compare the rest.
+ * That is linear for needles up to SIMD_NEEDLE_MAX bytes, but quadratic for long needles in the worst case,
+ * e.g. "aaa...ab" in "aaa...a". Long needles are filtered by a 16-byte prefix (or suffix when searching
+ * backwards), and the search falls back to Two-Way once comparing the rest costs more than the scanned bytes.
+ * Without SIMD, Two-Way is used for any needle.
+ */
+static int64_t SearchForward(const uint8_t* org, int64_t orgSize, const uint8_t* sub, int64_t subSize, TwoWay* tw)
+{
+    if (orgSize < subSize) {
+        return -1;
+    }
+    if (CJ_CORE_CanUseSIMD()) {
+        if (subSize <= SIMD_NEEDLE_MAX) {
+            return FastStrstr(org, orgSize, sub, subSize);
+        }
+        int64_t restSize = subSize - SIMD_NEEDLE_MAX;
+        int64_t budget = subSize;
+        int64_t pos = 0;
+        while (pos + subSize <= orgSize) {
+            int64_t n = FastStrstr(org + pos, orgSize - pos - restSize, sub, SIMD_NEEDLE_MAX);
+            if (n < 0) {
+                return -1;
+            }
+            pos += n;
+            if (memcmp(org + pos + SIMD_NEEDLE_MAX, sub + SIMD_NEEDLE_MAX, (size_t)restSize) == 0) {
+                return pos;
+            }
+            pos++;
+            budget += n + 1 - restSize;
+            if (budget < 0) {
+                break;
+            }
+        }
+        if (pos + subSize > orgSize) {
+            return -1;
+        }
+        if (tw->size == 0) {
+            CJ_CORE_TwoWayInit(tw, sub, subSize, false);
+        }
+        int64_t n = CJ_CORE_TwoWaySearch(tw, org + pos, orgSize - pos);
+        return (n < 0) ? -1 : n + pos;
+    }
+    if (tw->size == 0) {
+        CJ_CORE_TwoWayInit(tw, sub, subSize, false);
+    }
+    return CJ_CORE_TwoWaySearch(tw, org, orgSize);
+}
+
+static int64_t SearchBackward(const uint8_t* org, int64_t orgSize, const uint8_t* sub, int64_t subSize)
+{
+    if (orgSize < subSize) {
+        return -1;
+    }
+    TwoWay tw;
+    if (CJ_CORE_CanUseSIMD()) {
+        if (subSize <= SIMD_NEEDLE_MAX) {
+            return FastStrrstr(org, orgSize, sub, subSize);
+        }
+        int64_t restSize = subSize - SIMD_NEEDLE_MAX;
+        const uint8_t* suffix = sub + restSize;
+        int64_t budget = subSize;
+        int64_t end = orgSize; // candidates end before end
+        while (end >= subSize) {
+            int64_t n = FastStrrstr(org + restSize, end - restSize, suffix, SIMD_NEEDLE_MAX);
+            if (n < 0) {
+                return -1;
+            }
+            if (memcmp(org + n, sub, (size_t)restSize) == 0) {
+                return n;
+            }
+            budget += end - (n + subSize) + 1 - restSize;
+            end = n + subSize - 1;
+            if (budget < 0) {
+                break;
+            }
+        }
+        if (end < subSize) {
+            return -1;
+        }
+        CJ_CORE_TwoWayInit(&tw, sub, subSize, true);
+        return CJ_CORE_TwoWaySearch(&tw, org, end);
+    }
+    CJ_CORE_TwoWayInit(&tw, sub, subSize, true);
+    return CJ_CORE_TwoWaySearch(&tw, org, orgSize);
+}
+
 int64_t CJ_CORE_IndexOfString(
     const uint8_t* orgStr, const uint8_t* subStr, int64_t orgSize, int64_t subSize, int64_t start)
 {
@@ -132,18 +362,9 @@ int64_t CJ_CORE_IndexOfString(
     int64_t n;
     if (subSize == 1) {
         n = CJ_CORE_IndexOfByte(orgStr + start, orgSize - start, subStr[0]);
-        return (n < 0) ? -1 : n + start;
     } else {
-        if (CJ_CORE_CanUseSIMD()) {
-            n = FastStrstr(orgStr + start, orgSize - start, subStr, subSize);
-        } else {
-            uint32_t hash = 0;
-            uint32_t pow = 0;
-            CJ_CORE_HashStr(subStr, subSize, &hash, &pow);
-            Strptr org = {(const uint8_t*)orgStr + start, orgSize - start};
-            Strptr sub = {(const uint8_t*)subStr, subSize};
-            n = CJ_CORE_RabinKarp(&org, &sub, hash, pow);
-        }
+        TwoWay tw = {0};
+        n = SearchForward(orgStr + start, orgSize - start, subStr, subSize, &tw);
     }
     return (n < 0) ? -1 : n + start;
 }
@@ -158,12 +379,7 @@ int64_t CJ_CORE_LastIndexOfString(
     if (subSize == 1) {
         n = CJ_CORE_LastIndexOfByte(orgStr + start, orgSize - start, subStr[0]);
     } else {
-        uint32_t hash = 0;
-        uint32_t pow = 0;
-        CJ_CORE_HashStrRev(subStr, subSize, &hash, &pow);
-        Strptr org = {(const uint8_t*)orgStr + start, orgSize - start};
-        Strptr sub = {(const uint8_t*)subStr, subSize};
-        n = CJ_CORE_RabinKarpR(&org, &sub, hash, pow);
+        n = SearchBackward(orgStr + start, orgSize - start, subStr, subSize);
     }
     return (n < 0) ? -1 : n + start;
 }
@@ -179,29 +395,14 @@ int64_t CJ_CORE_CountString(const uint8_t* orgStr, const uint8_t* subStr, int64_
     int64_t n;
     int64_t i = 0;
     int64_t total = 0;
-    if (CJ_CORE_CanUseSIMD()) {
-        while (i < orgSize) {
-            n = FastStrstr(orgStr + i, orgSize - i, subStr, subSize);
-            if (n < 0) {
-                return total;
-            }
-            total++;
-            i += n + subSize;
-        }
-    } else {
-        uint32_t hash = 0;
-        uint32_t pow = 0;
-        CJ_CORE_HashStr(subStr, subSize, &hash, &pow);
-        Strptr sub = {(const uint8_t*)subStr, subSize};
-        while (i < orgSize) {
-            Strptr org = {(const uint8_t*)orgStr + i, orgSize - i};
-            n = CJ_CORE_RabinKarp(&org, &sub, hash, pow);
-            if (n < 0) {
-                return total;
-            }
-            total++;
-            i += n + subSize;
+    TwoWay tw = {0};
+    while (i < orgSize) {
+        n = SearchForward(orgStr + i, orgSize - i, subStr, subSize, &tw);
+        if (n < 0) {
+            return total;
         }
+        total++;
+        i += n + subSize;
     }
     return total;
 }
@@ -221,33 +422,15 @@ int64_t* CJ_CORE_CountAndIndexString(const uint8_t* orgStr, const uint8_t* subSt
     if (result == NULL) {
         return NULL;
     }
-    if (CJ_CORE_CanUseSIMD()) {
-        while (i < orgSize) {
-            n = FastStrstr(orgStr + i, orgSize - i, subStr, subSize);
-            if (n < 0) {
-                result[0] = total;
-                return result;
-            }
-            result[total + 1] = i + n;
-            total++;
-            i += n + subSize;
-        }
-    } else {
-        uint32_t hash = 0;
-        uint32_t pow = 0;
-        CJ_CORE_HashStr(subStr, subSize, &hash, &pow);
-        Strptr sub = {(const uint8_t*)subStr, subSize};
-        while (i < orgSize) {
-            Strptr org = {(const uint8_t*)orgStr + i, orgSize - i};
-            n = CJ_CORE_RabinKarp(&org, &sub, hash, pow);
-            if (n < 0) {
-                result[0] = total;
-                return result;
-            }
-            result[total + 1] = i + n;
-            total++;
-            i += n + subSize;
+    TwoWay tw = {0};
+    while (i < orgSize) {
+        n = SearchForward(orgStr + i, orgSize - i, subStr, subSize, &tw);
+        if (n < 0) {
+            break;
         }
+        result[total + 1] = i + n;
+        total++;
+        i += n + subSize;
     }
     result[0] = total;
     return result;
@@ -269,3 +452,38 @@ extern int64_t CJ_CORE_StringSize(const uint8_t* str, int64_t len)
         return size;
     }
 }
+
+extern bool CJ_CORE_Utf8Validate(const uint8_t* str, int64_t len)
+{
+    if (CJ_CORE_CanUseSIMD()) {
+        return FastUtf8Validate(str, len);
+    }
+    uint32_t rune;
+    int64_t i = 0;
+    while (i < len) {
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, &rune);
+        if (n < 0) {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+extern int64_t CJ_CORE_Utf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes)
+{
+    if (CJ_CORE_CanUseSIMD()) {
+        return FastUtf8ToUtf32(str, len, runes);
+    }
+    int64_t i = 0;
+    int64_t count = 0;
+    while (i < len) {
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, runes + count);
+        if (n < 0) {
+            return -1;
+        }
+        i += n;
+        count++;
+    }
+    return count;
+}
@@ -306,6 +306,93 @@ int64_t FastStrstr(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t s
     }
 }
 
+static inline bool MatchMiddle(const uint8_t* org, const uint8_t* sub, int64_t sl)
+{
+    return sl <= FIRST_AND_LAST || memcmp(org + 1, sub + 1, (size_t)(sl - FIRST_AND_LAST)) == 0;
+}
+
+#ifdef __x86_64__
+// same first/last byte filter as StrStrN, scanning blocks from the end of org
+static int64_t StrRStrN(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl)
+{
+    const __m256i f = _mm256_set1_epi8((char)sub[0]);
+    const __m256i l = _mm256_set1_epi8((char)sub[sl - 1]);
+    int64_t i = (ol - sl) - (X86_64_OFFSET - 1);
+    for (; i >= 0; i -= X86_64_OFFSET) {
+        const __m256i blockF = _mm256_loadu_si256((const __m256i*)(org + i));
+        const __m256i equalF = _mm256_cmpeq_epi8(f, blockF);
+        const __m256i blockL = _mm256_loadu_si256((const __m256i*)(org + i + sl - 1));
+        const __m256i equalL = _mm256_cmpeq_epi8(l, blockL);
+        uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(equalF, equalL));
+        while (mask != 0) {
+            const int64_t bitPos = (X86_64_OFFSET - 1) - __builtin_clz(mask);
+            if (MatchMiddle(org + i + bitPos, sub, sl)) {
+                return i + bitPos;
+            }
+            mask &= ~(1U << bitPos);
+        }
+    }
+    for (i += X86_64_OFFSET - 1; i >= 0; i--) {
+        if (org[i] == sub[0] && org[i + sl - 1] == sub[sl - 1] && MatchMiddle(org + i, sub, sl)) {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif
+
+#ifdef __aarch64__
+static int64_t StrRStrN(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl)
+{
+    const uint8x16_t F = vdupq_n_u8(sub[0]);
+    const uint8x16_t l = vdupq_n_u8(sub[sl - 1]);
+    int64_t i = (ol - sl) - (AARCH64_OFFSET - 1);
+    for (; i >= 0; i -= AARCH64_OFFSET) {
+        const uint8x16_t blockF = vld1q_u8(org + i);
+        const uint8x16_t blockL = vld1q_u8(org + i + sl - 1);
+        const uint8x16_t pred_16 = vandq_u8(vceqq_u8(F, blockF), vceqq_u8(l, blockL));
+        if (vmaxvq_u8(pred_16) == 0) {
+            continue;
+        }
+        for (int j = AARCH64_OFFSET - 1; j >= 0; j--) {
+            if (org[i + j] == sub[0] && org[i + j + sl - 1] == sub[sl - 1] && MatchMiddle(org + i + j, sub, sl)) {
+                return i + j;
+            }
+        }
+    }
+    for (i += AARCH64_OFFSET - 1; i >= 0; i--) {
+        if (org[i] == sub[0] && org[i + sl - 1] == sub[sl - 1] && MatchMiddle(org + i, sub, sl)) {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif
+
+#ifdef __arm__
+static int64_t StrRStrN(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl)
+{
+    for (int64_t i = ol - sl; i >= 0; i--) {
+        if (org[i] == sub[0] && org[i + sl - 1] == sub[sl - 1] && MatchMiddle(org + i, sub, sl)) {
+            return i;
+        }
+    }
+    return -1;
+}
+#endif
+
+// instruction set acceleration, return the last occurrence of sub in org
+int64_t FastStrrstr(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl)
+{
+    if (sl <= 0) {
+        return sl == 0 ? ol : -1;
+    }
+    if (ol < sl) {
+        return -1;
+    }
+    return StrRStrN(org, ol, sub, sl);
+}
+
 __attribute__((unused)) static inline int64_t DownAlign32(int64_t value)
 {
     return (int64_t)((uint64_t)value & (~(0b11111))); // clear the last 5 bits to align 32
@@ -383,3 +470,279 @@ int64_t FastSize(const uint8_t* str, int64_t len)
 {
     return StringSize(str, len);
 }
+
+/*
+ * UTF-8 validation with the lookup algorithm of simdjson (John Keiser, Daniel Lemire, "Validating UTF-8 In Less Than
+ * One Instruction Per Byte"). Every byte is classified with three 16-entry tables, indexed by the high nibble of the
+ * previous byte, the low nibble of the previous byte and the high nibble of the current byte. Each bit is one kind of
+ * error, which is only reported if all three tables agree on it. The 3rd and the 4th bytes of a sequence are checked
+ * by the leads 2 and 3 bytes before them.
+ */
+#define UTF8_TOO_SHORT (1 << 0)
+#define UTF8_TOO_LONG (1 << 1)
+#define UTF8_OVERLONG_3 (1 << 2)
+#define UTF8_TOO_LARGE (1 << 3)
+#define UTF8_SURROGATE (1 << 4)
+#define UTF8_OVERLONG_2 (1 << 5)
+#define UTF8_TOO_LARGE_1000 (1 << 6)
+#define UTF8_OVERLONG_4 (1 << 6)
+#define UTF8_TWO_CONTS (1 << 7)
+#define UTF8_CARRY (UTF8_TOO_SHORT | UTF8_TOO_LONG | UTF8_TWO_CONTS)
+#define UTF8_LARGE (UTF8_CARRY | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000)
+#define UTF8_CONT (UTF8_TOO_LONG | UTF8_OVERLONG_2 | UTF8_TWO_CONTS)
+#define UTF8_THIRD_BYTE_MIN 0xE0
+#define UTF8_FOURTH_BYTE_MIN 0xF0
+#define UTF8_CONT_MIN 0x80
+
+#define UTF8_BYTE_1_HIGH_TABLE                                                                                    \
+    UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG, UTF8_TOO_LONG,     \
+    UTF8_TOO_LONG, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TWO_CONTS, UTF8_TOO_SHORT | UTF8_OVERLONG_2, \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT | UTF8_OVERLONG_3 | UTF8_SURROGATE,                                          \
+    UTF8_TOO_SHORT | UTF8_TOO_LARGE | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4
+
+#define UTF8_BYTE_1_LOW_TABLE                                                                                     \
+    UTF8_CARRY | UTF8_OVERLONG_3 | UTF8_OVERLONG_2 | UTF8_OVERLONG_4, UTF8_CARRY | UTF8_OVERLONG_2, UTF8_CARRY,     \
+    UTF8_CARRY, UTF8_CARRY | UTF8_TOO_LARGE, UTF8_LARGE, UTF8_LARGE, UTF8_LARGE, UTF8_LARGE, UTF8_LARGE,          \
+    UTF8_LARGE, UTF8_LARGE, UTF8_LARGE, UTF8_LARGE | UTF8_SURROGATE, UTF8_LARGE, UTF8_LARGE
+
+#define UTF8_BYTE_2_HIGH_TABLE                                                                                    \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT,              \
+    UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_CONT | UTF8_OVERLONG_3 | UTF8_TOO_LARGE_1000 | UTF8_OVERLONG_4,        \
+    UTF8_CONT | UTF8_OVERLONG_3 | UTF8_TOO_LARGE, UTF8_CONT | UTF8_SURROGATE | UTF8_TOO_LARGE,                    \
+    UTF8_CONT | UTF8_SURROGATE | UTF8_TOO_LARGE, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT, UTF8_TOO_SHORT
+
+// the last 3 bytes of a block can't be leads of sequences longer than the rest of the block
+#define UTF8_INCOMPLETE_MAX_3 (UTF8_FOURTH_BYTE_MIN - 1)
+#define UTF8_INCOMPLETE_MAX_2 (UTF8_THIRD_BYTE_MIN - 1)
+#define UTF8_INCOMPLETE_MAX_1 (0xC0 - 1)
+
+#ifdef __x86_64__
+#include <immintrin.h>
+#define AVX2_PREV(input, prevInput, n) \
+    _mm256_alignr_epi8((input), _mm256_permute2x128_si256((prevInput), (input), 0x21), 16 - (n))
+
+inline __attribute__((always_inline)) static __m256i Utf8HighNibble(__m256i v)
+{
+    return _mm256_and_si256(_mm256_srli_epi16(v, OFFSET_4), _mm256_set1_epi8(0x0F));
+}
+
+inline __attribute__((always_inline)) static __m256i Utf8CheckBlock(__m256i input, __m256i prevInput)
+{
+    const __m256i byte1HighTable = _mm256_setr_epi8(UTF8_BYTE_1_HIGH_TABLE, UTF8_BYTE_1_HIGH_TABLE);
+    const __m256i byte1LowTable = _mm256_setr_epi8(UTF8_BYTE_1_LOW_TABLE, UTF8_BYTE_1_LOW_TABLE);
+    const __m256i byte2HighTable = _mm256_setr_epi8(UTF8_BYTE_2_HIGH_TABLE, UTF8_BYTE_2_HIGH_TABLE);
+    const __m256i prev1 = AVX2_PREV(input, prevInput, 1);
+    const __m256i byte1High = _mm256_shuffle_epi8(byte1HighTable, Utf8HighNibble(prev1));
+    const __m256i byte1Low = _mm256_shuffle_epi8(byte1LowTable, _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+    const __m256i byte2High = _mm256_shuffle_epi8(byte2HighTable, Utf8HighNibble(input));
+    const __m256i special = _mm256_and_si256(_mm256_and_si256(byte1High, byte1Low), byte2High);
+
+    // two continuations in a row are only valid as the 3rd or 4th byte of a sequence, so TWO_CONTS is xor-ed with
+    // the bytes 2 or 3 bytes after a 3 or 4 bytes lead, and either of them without the other is an error
+    const __m256i prev2 = AVX2_PREV(input, prevInput, 2);
+    const __m256i prev3 = AVX2_PREV(input, prevInput, 3);
+    const __m256i isThird = _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(UTF8_THIRD_BYTE_MIN - UTF8_CONT_MIN)));
+    const __m256i isFourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(UTF8_FOURTH_BYTE_MIN - UTF8_CONT_MIN)));
+    const __m256i must23 = _mm256_and_si256(_mm256_or_si256(isThird, isFourth), _mm256_set1_epi8((char)UTF8_CONT_MIN));
+    return _mm256_xor_si256(must23, special);
+}
+
+inline __attribute__((always_inline)) static __m256i Utf8Incomplete(__m256i input)
+{
+    const __m256i maxValue = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        (char)UTF8_INCOMPLETE_MAX_3, (char)UTF8_INCOMPLETE_MAX_2, (char)UTF8_INCOMPLETE_MAX_1);
+    return _mm256_subs_epu8(input, maxValue);
+}
+
+inline __attribute__((always_inline)) static bool Utf8Validate(const uint8_t* str, int64_t len)
+{
+    __m256i error = _mm256_setzero_si256();
+    __m256i prevInput = _mm256_setzero_si256();
+    __m256i prevIncomplete = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i < DownAlign32(len); i += X86_64_OFFSET) {
+        const __m256i input = _mm256_loadu_si256((const __m256i*)(str + i));
+        if (_mm256_movemask_epi8(input) == 0) {
+            // an ascii block is only invalid if the previous block ends with an incomplete sequence
+            error = _mm256_or_si256(error, prevIncomplete);
+            prevIncomplete = _mm256_setzero_si256();
+        } else {
+            error = _mm256_or_si256(error, Utf8CheckBlock(input, prevInput));
+            prevIncomplete = Utf8Incomplete(input);
+        }
+        prevInput = input;
+    }
+    if (i < len) {
+        // pad the tail with zero, which are ascii, so that an incomplete sequence at the end is reported
+        uint8_t tail[X86_64_OFFSET] = { 0 };
+        (void)memcpy(tail, str + i, (size_t)(len - i));
+        const __m256i input = _mm256_loadu_si256((const __m256i*)tail);
+        error = _mm256_or_si256(error, Utf8CheckBlock(input, prevInput));
+        prevIncomplete = _mm256_setzero_si256();
+    }
+    error = _mm256_or_si256(error, prevIncomplete);
+    return _mm256_testz_si256(error, error);
+}
+
+inline __attribute__((always_inline)) static int64_t Utf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes)
+{
+    int64_t i = 0;
+    int64_t count = 0;
+    while (i < len) {
+        if (str[i] < UTF8_CONT_MIN && i + X86_64_OFFSET <= len) {
+            const __m256i input = _mm256_loadu_si256((const __m256i*)(str + i));
+            if (_mm256_movemask_epi8(input) == 0) {
+                const __m128i low = _mm256_castsi256_si128(input);
+                const __m128i high = _mm256_extracti128_si256(input, 1);
+                _mm256_storeu_si256((__m256i*)(runes + count), _mm256_cvtepu8_epi32(low));
+                _mm256_storeu_si256((__m256i*)(runes + count + OFFSET_8), _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+                _mm256_storeu_si256((__m256i*)(runes + count + SIZE_16), _mm256_cvtepu8_epi32(high));
+                _mm256_storeu_si256((__m256i*)(runes + count + SIZE_16 + OFFSET_8),
+                    _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+                i += X86_64_OFFSET;
+                count += X86_64_OFFSET;
+                continue;
+            }
+        }
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, runes + count);
+        if (n < 0) {
+            return -1;
+        }
+        i += n;
+        count++;
+    }
+    return count;
+}
+#endif
+
+#ifdef __aarch64__
+#include <arm_neon.h>
+inline __attribute__((always_inline)) static uint8x16_t Utf8CheckBlock(uint8x16_t input, uint8x16_t prevInput)
+{
+    static const uint8_t byte1HighTable[AARCH64_OFFSET] = { UTF8_BYTE_1_HIGH_TABLE };
+    static const uint8_t byte1LowTable[AARCH64_OFFSET] = { UTF8_BYTE_1_LOW_TABLE };
+    static const uint8_t byte2HighTable[AARCH64_OFFSET] = { UTF8_BYTE_2_HIGH_TABLE };
+    const uint8x16_t prev1 = vextq_u8(prevInput, input, AARCH64_OFFSET - 1);
+    const uint8x16_t byte1High = vqtbl1q_u8(vld1q_u8(byte1HighTable), vshrq_n_u8(prev1, OFFSET_4));
+    const uint8x16_t byte1Low = vqtbl1q_u8(vld1q_u8(byte1LowTable), vandq_u8(prev1, vdupq_n_u8(0x0F)));
+    const uint8x16_t byte2High = vqtbl1q_u8(vld1q_u8(byte2HighTable), vshrq_n_u8(input, OFFSET_4));
+    const uint8x16_t special = vandq_u8(vandq_u8(byte1High, byte1Low), byte2High);
+
+    // two continuations in a row are only valid as the 3rd or 4th byte of a sequence, so TWO_CONTS is xor-ed with
+    // the bytes 2 or 3 bytes after a 3 or 4 bytes lead, and either of them without the other is an error
+    const uint8x16_t prev2 = vextq_u8(prevInput, input, AARCH64_OFFSET - 2);
+    const uint8x16_t prev3 = vextq_u8(prevInput, input, AARCH64_OFFSET - 3);
+    const uint8x16_t isThird = vqsubq_u8(prev2, vdupq_n_u8(UTF8_THIRD_BYTE_MIN - UTF8_CONT_MIN));
+    const uint8x16_t isFourth = vqsubq_u8(prev3, vdupq_n_u8(UTF8_FOURTH_BYTE_MIN - UTF8_CONT_MIN));
+    const uint8x16_t must23 = vandq_u8(vorrq_u8(isThird, isFourth), vdupq_n_u8(UTF8_CONT_MIN));
+    return veorq_u8(must23, special);
+}
+
+inline __attribute__((always_inline)) static uint8x16_t Utf8Incomplete(uint8x16_t input)
+{
+    static const uint8_t maxValue[AARCH64_OFFSET] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+        0xFF, 0xFF, 0xFF, UTF8_INCOMPLETE_MAX_3, UTF8_INCOMPLETE_MAX_2, UTF8_INCOMPLETE_MAX_1 };
+    return vqsubq_u8(input, vld1q_u8(maxValue));
+}
+
+inline __attribute__((always_inline)) static bool Utf8Validate(const uint8_t* str, int64_t len)
+{
+    uint8x16_t error = vdupq_n_u8(0);
+    uint8x16_t prevInput = vdupq_n_u8(0);
+    uint8x16_t prevIncomplete = vdupq_n_u8(0);
+    int64_t i = 0;
+    for (; i < DownAlign16(len); i += AARCH64_OFFSET) {
+        const uint8x16_t input = vld1q_u8(str + i);
+        if (vmaxvq_u8(input) < UTF8_CONT_MIN) {
+            // an ascii block is only invalid if the previous block ends with an incomplete sequence
+            error = vorrq_u8(error, prevIncomplete);
+            prevIncomplete = vdupq_n_u8(0);
+        } else {
+            error = vorrq_u8(error, Utf8CheckBlock(input, prevInput));
+            prevIncomplete = Utf8Incomplete(input);
+        }
+        prevInput = input;
+    }
+    if (i < len) {
+        // pad the tail with zero, which are ascii, so that an incomplete sequence at the end is reported
+        uint8_t tail[AARCH64_OFFSET] = { 0 };
+        (void)memcpy(tail, str + i, (size_t)(len - i));
+        error = vorrq_u8(error, Utf8CheckBlock(vld1q_u8(tail), prevInput));
+        prevIncomplete = vdupq_n_u8(0);
+    }
+    error = vorrq_u8(error, prevIncomplete);
+    return vmaxvq_u8(error) == 0;
+}
+
+inline __attribute__((always_inline)) static int64_t Utf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes)
+{
+    int64_t i = 0;
+    int64_t count = 0;
+    while (i < len) {
+        if (str[i] < UTF8_CONT_MIN && i + AARCH64_OFFSET <= len) {
+            const uint8x16_t input = vld1q_u8(str + i);
+            if (vmaxvq_u8(input) < UTF8_CONT_MIN) {
+                const uint16x8_t low = vmovl_u8(vget_low_u8(input));
+                const uint16x8_t high = vmovl_u8(vget_high_u8(input));
+                vst1q_u32(runes + count, vmovl_u16(vget_low_u16(low)));
+                vst1q_u32(runes + count + OFFSET_4, vmovl_u16(vget_high_u16(low)));
+                vst1q_u32(runes + count + OFFSET_8, vmovl_u16(vget_low_u16(high)));
+                vst1q_u32(runes + count + OFFSET_12, vmovl_u16(vget_high_u16(high)));
+                i += AARCH64_OFFSET;
+                count += AARCH64_OFFSET;
+                continue;
+            }
+        }
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, runes + count);
+        if (n < 0) {
+            return -1;
+        }
+        i += n;
+        count++;
+    }
+    return count;
+}
+#endif
+
+#ifdef __arm__
+inline __attribute__((always_inline)) static bool Utf8Validate(const uint8_t* str, int64_t len)
+{
+    uint32_t rune;
+    int64_t i = 0;
+    while (i < len) {
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, &rune);
+        if (n < 0) {
+            return false;
+        }
+        i += n;
+    }
+    return true;
+}
+
+inline __attribute__((always_inline)) static int64_t Utf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes)
+{
+    int64_t i = 0;
+    int64_t count = 0;
+    while (i < len) {
+        int64_t n = CJ_CORE_Utf8DecodeOne(str + i, len - i, runes + count);
+        if (n < 0) {
+            return -1;
+        }
+        i += n;
+        count++;
+    }
+    return count;
+}
+#endif
+
+bool FastUtf8Validate(const uint8_t* str, int64_t len)
+{
+    return Utf8Validate(str, len);
+}
+
+// `runes` must have room for `len` code points. Return the number of code points, or -1 if the input is invalid.
+int64_t FastUtf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes)
+{
+    return Utf8ToUtf32(str, len, runes);
+}
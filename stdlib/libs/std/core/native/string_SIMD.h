@@ -9,10 +9,20 @@
 #ifndef CANGJIE_STRING_SIMD_H
 #define CANGJIE_STRING_SIMD_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 int64_t FastStrstr(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl);
 
+int64_t FastStrrstr(const uint8_t* org, int64_t ol, const uint8_t* sub, int64_t sl);
+
 int64_t FastSize(const uint8_t* str, int64_t len);
 
+bool FastUtf8Validate(const uint8_t* str, int64_t len);
+
+int64_t FastUtf8ToUtf32(const uint8_t* str, int64_t len, uint32_t* runes);
+
+// scalar decoder implemented in string_utf8.c, which is used for non-ASCII code points by FastUtf8ToUtf32
+int64_t CJ_CORE_Utf8DecodeOne(const uint8_t* str, int64_t len, uint32_t* rune);
+
 #endif // CANGJIE_STRING_SIMD_H
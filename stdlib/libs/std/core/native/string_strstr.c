@@ -8,103 +8,116 @@
 
 #include "core.h"
 
-// PrimeRK is the prime base used in Rabin-Karp algorithm.
-static const uint32_t PRIME_RK = 16777619;
+static inline uint8_t TwoWayByte(const uint8_t* str, int64_t size, int64_t i, bool reverse)
+{
+    return reverse ? str[size - 1 - i] : str[i];
+}
 
-void CJ_CORE_HashStr(const uint8_t* str, int64_t strSize, uint32_t* hash, uint32_t* pow)
+// Return the start of the maximal suffix of sub minus 1 for the given order of bytes, and its period.
+static int64_t MaximalSuffix(const uint8_t* sub, int64_t size, bool reverse, bool greater, int64_t* period)
 {
-    uint32_t hashV = 0;
-    int64_t j = 0;
-    while (j < strSize) {
-        hashV = hashV * PRIME_RK + (uint32_t)str[j];
-        j++;
-    }
-    uint64_t i = (uint64_t)strSize;
-    uint32_t powV = 1;
-    uint32_t sq = PRIME_RK;
-    while (i > 0) {
-        if ((i & 1) != 0) {
-            powV *= sq;
+    int64_t ip = -1;
+    int64_t jp = 0;
+    int64_t k = 1;
+    int64_t p = 1;
+    while (jp + k < size) {
+        uint8_t a = TwoWayByte(sub, size, ip + k, reverse);
+        uint8_t b = TwoWayByte(sub, size, jp + k, reverse);
+        if (a == b) {
+            if (k == p) {
+                jp += p;
+                k = 1;
+            } else {
+                k++;
+            }
+        } else if (greater ? (a > b) : (a < b)) {
+            jp += k;
+            k = 1;
+            p = jp - ip;
+        } else {
+            ip = jp++;
+            k = 1;
+            p = 1;
         }
-        sq *= sq;
-        i = i >> 1;
     }
-    *hash = hashV;
-    *pow = powV;
+    *period = p;
+    return ip;
 }
 
-void CJ_CORE_HashStrRev(const uint8_t* str, int64_t strSize, uint32_t* hash, uint32_t* pow)
+/*
+ * Crochemore-Perrin Two-Way string matching: sub is split at a critical factorization, the right half is
+ * matched left to right and the left half right to left. It uses constant space and compares at most
+ * 2 * orgSize bytes. A reversed searcher runs the same algorithm over the reversed strings.
+ */
+void CJ_CORE_TwoWayInit(TwoWay* tw, const uint8_t* sub, int64_t subSize, bool reverse)
 {
-    uint32_t hashV = 0;
-    int64_t j = strSize - 1;
-    while (j >= 0) {
-        hashV = hashV * PRIME_RK + (uint32_t)str[j];
-        j--;
-    }
-    uint64_t i = (uint64_t)strSize;
-    uint32_t powV = 1;
-    uint32_t sq = PRIME_RK;
-    while (i > 0) {
-        if ((i & 1) == 1) {
-            powV *= sq;
+    int64_t period;
+    int64_t periodR;
+    int64_t ms = MaximalSuffix(sub, subSize, reverse, true, &period);
+    int64_t msR = MaximalSuffix(sub, subSize, reverse, false, &periodR);
+    if (msR > ms) {
+        ms = msR;
+        period = periodR;
+    }
+    bool periodic = true;
+    for (int64_t i = 0; i <= ms; i++) {
+        if (TwoWayByte(sub, subSize, i, reverse) != TwoWayByte(sub, subSize, i + period, reverse)) {
+            periodic = false;
+            break;
         }
-        sq *= sq;
-        i = i >> 1;
     }
-    *hash = hashV;
-    *pow = powV;
+    tw->sub = sub;
+    tw->size = subSize;
+    tw->critPos = ms + 1;
+    tw->reverse = reverse;
+    if (periodic) {
+        tw->period = period;
+        tw->memory = subSize - period;
+    } else {
+        tw->period = (ms + 1 > subSize - ms - 1 ? ms + 1 : subSize - ms - 1) + 1;
+        tw->memory = 0;
+    }
 }
 
-int64_t CJ_CORE_RabinKarp(Strptr* org, Strptr* sub, uint32_t hashP, uint32_t pow)
+static inline int64_t TwoWaySearch(const TwoWay* tw, const uint8_t* org, int64_t orgSize, bool reverse)
 {
-    if (sub->size < 0 || org->size < 0 || org->size < sub->size) {
-        return -1;
-    }
-    uint32_t hashO = 0;
-    int64_t i;
-    for (i = 0; i < sub->size; ++i) {
-        hashO = hashO * PRIME_RK + (uint32_t)(org->ptr)[i];
-    }
-    const uint8_t* itemOrgStr = org->ptr;
-    if (hashP == hashO && memcmp(itemOrgStr, sub->ptr, (size_t)sub->size) == 0) {
-        return 0;
-    }
-    i = sub->size;
-    while (i < org->size) {
-        hashO = hashO * PRIME_RK + (uint32_t)(org->ptr)[i];
-        hashO -= pow * (uint32_t)(org->ptr)[i - sub->size];
-        i++;
-        itemOrgStr = org->ptr + i - sub->size;
-        if (hashP == hashO && memcmp(itemOrgStr, sub->ptr, (size_t)sub->size) == 0) {
-            return i - sub->size;
+    const uint8_t* sub = tw->sub;
+    int64_t size = tw->size;
+    int64_t pos = 0;
+    int64_t memory = 0;
+    while (pos <= orgSize - size) {
+        int64_t k = tw->critPos > memory ? tw->critPos : memory;
+        while (k < size && TwoWayByte(sub, size, k, reverse) == TwoWayByte(org, orgSize, pos + k, reverse)) {
+            k++;
+        }
+        if (k < size) {
+            pos += k - tw->critPos + 1;
+            memory = 0;
+            continue;
+        }
+        k = tw->critPos;
+        while (k > memory && TwoWayByte(sub, size, k - 1, reverse) == TwoWayByte(org, orgSize, pos + k - 1, reverse)) {
+            k--;
         }
+        if (k <= memory) {
+            return reverse ? orgSize - size - pos : pos;
+        }
+        pos += tw->period;
+        memory = tw->memory;
     }
     return -1;
 }
 
-int64_t CJ_CORE_RabinKarpR(Strptr* org, Strptr* sub, uint32_t hashP, uint32_t pow)
+// Return the first occurrence of the searcher's sub in org, or the last one for a reversed searcher.
+int64_t CJ_CORE_TwoWaySearch(const TwoWay* tw, const uint8_t* org, int64_t orgSize)
 {
-    if (sub->size < 0 || org->size < 0 || (org->size - sub->size) < 0) {
+    if (orgSize < tw->size) {
         return -1;
     }
-    uint32_t hashO = 0;
-    int64_t i;
-    for (i = org->size - 1; i >= org->size - sub->size; --i) {
-        hashO = hashO * PRIME_RK + (uint32_t)(org->ptr)[i];
-    }
-    const uint8_t* itemOrgStr = org->ptr + org->size - sub->size;
-    if (hashP == hashO && memcmp(itemOrgStr, sub->ptr, (size_t)sub->size) == 0) {
-        return org->size - sub->size;
+    if (tw->size == 0) {
+        return tw->reverse ? orgSize : 0;
     }
-    for (i = (org->size - sub->size) - 1; i >= 0; --i) {
-        hashO = hashO * PRIME_RK + (uint32_t)(org->ptr)[i];
-        hashO -= pow * (uint32_t)(org->ptr)[i + sub->size];
-        itemOrgStr = org->ptr + i;
-        if (hashP == hashO && memcmp(itemOrgStr, sub->ptr, (size_t)sub->size) == 0) {
-            return i;
-        }
-    }
-    return -1;
+    return tw->reverse ? TwoWaySearch(tw, org, orgSize, true) : TwoWaySearch(tw, org, orgSize, false);
 }
 
 int64_t CJ_CORE_IndexOfByte(const uint8_t* orgStr, int64_t orgSize, uint8_t pat)
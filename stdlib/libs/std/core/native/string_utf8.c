@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include "core.h"
+#include "string_SIMD.h"
 
 #define HIGH_1_MASK 0b10000000 /* 0x80 */
 #define HIGH_2_MASK 0b11000000 /* 0xc0 */
@@ -24,6 +25,10 @@
 #define UTF8_3_MAX 0xFFFF
 #define UTF8_2_MAX 0x07FF
 #define UTF8_1_MAX 0x7F
+#define UTF8_2_LEAD_MIN 0xC2
+#define UTF8_4_LEAD_MAX 0xF4
+#define SURROGATE_MIN 0xD800
+#define SURROGATE_MAX 0xDFFF
 #define SUBSCRIPT_0 0
 #define SUBSCRIPT_1 1
 #define SUBSCRIPT_2 2
@@ -56,3 +61,53 @@ int64_t CJ_CORE_FromCharToUtf8(uint32_t c, uint8_t* itemBytes)
     }
     return -1;
 }
+
+/*
+ * Decode one code point from a UTF-8 sequence of at most `len` bytes, with the same rules as `checkInvalid` in
+ * Cangjie: overlong encodings, surrogates and code points bigger than U+10FFFF are invalid.
+ * Return the number of bytes decoded, or -1 if the sequence is invalid.
+ */
+int64_t CJ_CORE_Utf8DecodeOne(const uint8_t* str, int64_t len, uint32_t* rune)
+{
+    uint8_t b0 = str[SUBSCRIPT_0];
+    if (b0 < HIGH_1_MASK) {
+        *rune = b0;
+        return LENTH_1;
+    }
+    // continuation bytes, leads of overlong 2 bytes sequences C0 and C1, and leads bigger than F4 are invalid
+    if (b0 < UTF8_2_LEAD_MIN || b0 > UTF8_4_LEAD_MAX) {
+        return -1;
+    }
+    if (b0 < HIGH_3_MASK) {
+        if (len < LENTH_2 || (str[SUBSCRIPT_1] & HIGH_2_MASK) != HIGH_1_MASK) {
+            return -1;
+        }
+        *rune = ((uint32_t)(b0 & LOW_5_MASK) << SHIFT_6) | (str[SUBSCRIPT_1] & LOW_6_MASK);
+        return LENTH_2;
+    }
+    if (b0 < HIGH_4_MASK) {
+        if (len < LENTH_3 || (str[SUBSCRIPT_1] & HIGH_2_MASK) != HIGH_1_MASK ||
+            (str[SUBSCRIPT_2] & HIGH_2_MASK) != HIGH_1_MASK) {
+            return -1;
+        }
+        uint32_t c = ((uint32_t)(b0 & LOW_4_MASK) << SHIFT_12) |
+            ((uint32_t)(str[SUBSCRIPT_1] & LOW_6_MASK) << SHIFT_6) | (str[SUBSCRIPT_2] & LOW_6_MASK);
+        if (c <= UTF8_2_MAX || (c >= SURROGATE_MIN && c <= SURROGATE_MAX)) {
+            return -1;
+        }
+        *rune = c;
+        return LENTH_3;
+    }
+    if (len < LENTH_4 || (str[SUBSCRIPT_1] & HIGH_2_MASK) != HIGH_1_MASK ||
+        (str[SUBSCRIPT_2] & HIGH_2_MASK) != HIGH_1_MASK || (str[SUBSCRIPT_3] & HIGH_2_MASK) != HIGH_1_MASK) {
+        return -1;
+    }
+    uint32_t c = ((uint32_t)(b0 & LOW_3_MASK) << SHIFT_18) |
+        ((uint32_t)(str[SUBSCRIPT_1] & LOW_6_MASK) << SHIFT_12) |
+        ((uint32_t)(str[SUBSCRIPT_2] & LOW_6_MASK) << SHIFT_6) | (str[SUBSCRIPT_3] & LOW_6_MASK);
+    if (c <= UTF8_3_MAX || c > UTF8_4_MAX) {
+        return -1;
+    }
+    *rune = c;
+    return LENTH_4;
+}
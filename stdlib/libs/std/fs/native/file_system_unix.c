@@ -7,53 +7,46 @@
  */
 
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/types.h>
 #include "file_system.h"
 #include <string.h>
+#if defined(__linux__)
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/syscall.h>
+#endif
+
+#if defined(__linux__) && !defined(FICLONE)
+#define FICLONE _IOW(0x94, 9, int)
+#endif
 
-static int64_t BuildSubPath(char* dirPath, const int64_t pathLen, const char* subName);
 static FsError* GetErrnoResult(void);
 
-struct FolderNode {
-    char* path;
-    struct FolderNode* next;
-    struct FolderNode* prior;
-};
+#define DIR_ENTRY_RECORD_MAX (sizeof(((struct dirent*)0)->d_name) + 2) // type, name and '\0'
+#define DIR_OPEN_FLAGS (O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC)
 
-static struct FolderNode* FolderNodeInit(const char* dirPath)
-{
-    struct FolderNode* newnode;
-    if (dirPath == NULL) {
-        return NULL;
-    }
-    size_t pathLen = strlen(dirPath);
-    if (pathLen > MAX_PATH_LEN) {
-        return NULL;
-    }
-    newnode = (struct FolderNode*)malloc(sizeof(struct FolderNode));
-    if (newnode == NULL) {
-        return NULL;
-    }
+// Entry types returned by CJ_FS_ReadDirBatch, DIR_ENTRY_UNKNOWN if the file system does not provide d_type.
+#define DIR_ENTRY_UNKNOWN (0)
+#define DIR_ENTRY_REGULAR (1)
+#define DIR_ENTRY_DIRECTORY (2)
+#define DIR_ENTRY_SYMLINK (3)
+#define DIR_ENTRY_OTHER (4)
 
-    newnode->path = (char*)malloc(pathLen + 1);
-    if (newnode->path == NULL) {
-        free(newnode);
-        return NULL;
-    }
-    (void)memset_s(newnode->path, pathLen + 1, 0, pathLen + 1);
+#define DIR_LIST_INIT_CAPACITY (16)
 
-    newnode->next = NULL;
-    newnode->prior = NULL;
+#define COPY_DONE (0)
+#define COPY_FAILED (-1)
+#define COPY_FALLBACK (1)
+#define COPY_CHUNK_SIZE (1 << 30)     // the most bytes moved by one copy_file_range or sendfile call
+#define COPY_BUFFER_SIZE (128 * 1024) // used only if the kernel can not copy the files
 
-    int err = strncpy_s(newnode->path, pathLen + 1, dirPath, pathLen);
-    if (err != 0) {
-        free(newnode->path);
-        newnode->path = NULL;
-        free(newnode);
-        newnode = NULL;
-    }
-    return newnode;
-}
+// Advice for CJ_FS_AdviseMappedFile, in the order of MapAdvice in std.fs.
+#define MAP_ADVICE_NORMAL (0)
+#define MAP_ADVICE_SEQUENTIAL (1)
+#define MAP_ADVICE_RANDOM (2)
+#define MAP_ADVICE_WILL_NEED (3)
+#define MAP_ADVICE_DONT_NEED (4)
 
 /*
  * FileInfo
@@ -73,39 +66,155 @@ static inline int SysRmdir(const char* path)
     return remove(path);
 }
 
-/* If get get directory size faied, return 0. */
-static int64_t GetDirectorySize(char* dirPath, int64_t pathLen)
+static inline bool IsDotOrDotDot(const char* name)
 {
-    if (pathLen < 0 || pathLen > MAX_PATH_LEN) {
-        return 0;
+    return name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0'));
+}
+
+static uint8_t GetDirEntryType(const struct dirent* entry)
+{
+#ifdef DT_UNKNOWN
+    switch (entry->d_type) {
+        case DT_UNKNOWN:
+            return DIR_ENTRY_UNKNOWN;
+        case DT_REG:
+            return DIR_ENTRY_REGULAR;
+        case DT_DIR:
+            return DIR_ENTRY_DIRECTORY;
+        case DT_LNK:
+            return DIR_ENTRY_SYMLINK;
+        default:
+            return DIR_ENTRY_OTHER;
+    }
+#else
+    return DIR_ENTRY_UNKNOWN;
+#endif
+}
+
+/* Whether an entry is a directory, without following links. lstat is needed only if d_type is unknown. */
+static int IsDirEntryDirectory(int dirFd, const struct dirent* entry)
+{
+    uint8_t type = GetDirEntryType(entry);
+    if (type != DIR_ENTRY_UNKNOWN) {
+        return type == DIR_ENTRY_DIRECTORY ? 1 : 0;
     }
-    int64_t totalSize = 0;
     struct stat statbuf;
-    if (lstat(dirPath, &statbuf) < 0) {
+    if (fstatat(dirFd, entry->d_name, &statbuf, AT_SYMLINK_NOFOLLOW) < 0) {
+        return -1;
+    }
+    return S_ISDIR(statbuf.st_mode) ? 1 : 0;
+}
+
+/*
+ * Directories of a tree, in the order they are found. Trees are walked one directory at a time with this list on the
+ * heap, so that neither the stack nor the descriptors in use grow with the depth of the tree.
+ */
+struct DirList {
+    char** paths;
+    size_t count;
+    size_t capacity;
+};
+
+/* Append parent/name, or parent itself if name is NULL. Return 0, or -1 with errno set. */
+static int DirListAppend(struct DirList* list, const char* parent, const char* name)
+{
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity == 0 ? DIR_LIST_INIT_CAPACITY : list->capacity * 2;
+        char** paths = (char**)realloc(list->paths, capacity * sizeof(char*));
+        if (paths == NULL) {
+            errno = ENOMEM;
+            return -1;
+        }
+        list->paths = paths;
+        list->capacity = capacity;
+    }
+    size_t parentLen = strlen(parent);
+    size_t nameSize = name == NULL ? 0 : strlen(name) + 1;
+    size_t pathSize = parentLen + 1 + nameSize;
+    char* path = (char*)malloc(pathSize);
+    if (path == NULL) {
+        errno = ENOMEM;
+        return -1;
+    }
+    if (memcpy_s(path, pathSize, parent, parentLen) != EOK) {
+        free(path);
+        errno = ENOMEM;
+        return -1;
+    }
+    path[parentLen] = '\0';
+    if (name != NULL) {
+        path[parentLen] = SLASH;
+        if (memcpy_s(path + parentLen + 1, nameSize, name, nameSize) != EOK) {
+            free(path);
+            errno = ENOMEM;
+            return -1;
+        }
+    }
+    list->paths[list->count++] = path;
+    return 0;
+}
+
+static void DirListFree(struct DirList* list)
+{
+    for (size_t i = 0; i < list->count; ++i) {
+        free(list->paths[i]);
+    }
+    free(list->paths);
+    list->paths = NULL;
+    list->count = 0;
+    list->capacity = 0;
+}
+
+/*
+ * Sum the sizes of the entries in the directory, and append its subdirectories to dirs. Entries are looked up
+ * relative to the directory, so that the path is neither built nor resolved again for each of them.
+ * Return -1 only if the subdirectories can not be recorded.
+ */
+static int SumDirEntries(const char* dirPath, bool withSelf, struct DirList* dirs, int64_t* totalSize)
+{
+    int dirFd = open(dirPath, DIR_OPEN_FLAGS);
+    if (dirFd < 0) {
         return 0;
     }
-    DIR* dirPtr = opendir(dirPath);
+    DIR* dirPtr = fdopendir(dirFd);
     if (dirPtr == NULL) {
+        (void)close(dirFd);
         return 0;
     }
-    totalSize += statbuf.st_size;
+    int ret = 0;
+    struct stat statbuf;
+    if (withSelf && fstat(dirfd(dirPtr), &statbuf) == 0) {
+        *totalSize += statbuf.st_size;
+    }
     struct dirent* dirInfo = NULL;
-    dirPath[pathLen] = SLASH;
-    while ((dirInfo = readdir(dirPtr)) != NULL) {
-        int64_t newPathLen = BuildSubPath(dirPath, pathLen, dirInfo->d_name);
-        if (newPathLen < 0) {
+    while (ret == 0 && (dirInfo = readdir(dirPtr)) != NULL) {
+        if (IsDotOrDotDot(dirInfo->d_name)) {
             continue;
         }
-        if (lstat(dirPath, &statbuf) < 0) {
+        if (fstatat(dirfd(dirPtr), dirInfo->d_name, &statbuf, AT_SYMLINK_NOFOLLOW) < 0) {
             break;
         }
         if (S_ISDIR(statbuf.st_mode)) {
-            totalSize += GetDirectorySize(dirPath, newPathLen);
+            // counted when it is opened, as a directory that can not be opened is not counted at all.
+            ret = DirListAppend(dirs, dirPath, dirInfo->d_name);
         } else {
-            totalSize += statbuf.st_size;
+            *totalSize += statbuf.st_size;
         }
     }
     (void)closedir(dirPtr);
+    return ret;
+}
+
+/* Sum the sizes of the entries in the directory recursively. If get directory size faied, return 0. */
+static int64_t GetDirectorySize(const char* dirPath)
+{
+    struct DirList dirs = { NULL, 0, 0 };
+    int64_t totalSize = 0;
+    int ret = DirListAppend(&dirs, dirPath, NULL);
+    for (size_t i = 0; ret == 0 && i < dirs.count; ++i) {
+        ret = SumDirEntries(dirs.paths[i], i != 0, &dirs, &totalSize);
+    }
+    DirListFree(&dirs);
     return totalSize;
 }
 
@@ -117,14 +226,7 @@ extern int64_t CJ_FS_PathSize(const char* path)
         return -1;
     }
     if (S_ISDIR(buf.st_mode)) {
-        char cPath[MAX_PATH_LEN + 1] = {0};
-        int64_t pathLen = (int64_t)strlen(path);
-        errno_t rc = memcpy_s(cPath, MAX_PATH_LEN, path, (size_t)pathLen);
-        if (rc != 0) {
-            return -1;
-        }
-        int64_t res = GetDirectorySize(cPath, pathLen);
-        return res;
+        return buf.st_size + GetDirectorySize(path);
     } else {
         return buf.st_size;
     }
@@ -431,6 +533,39 @@ extern char* CJ_FS_ReadDirHandle(uintptr_t handle)
     return strdup(dirInfo->d_name);
 }
 
+/*
+ * Read the next entries of the directory into buffer, each as its type, its name and '\0', so that a directory is
+ * listed with a few calls instead of one call and one allocation per entry. The buffer should hold at least
+ * DIR_ENTRY_RECORD_MAX bytes. Return the size used, 0 at the end of the directory, or -1 if failed.
+ */
+extern int64_t CJ_FS_ReadDirBatch(uintptr_t handle, uint8_t* buffer, size_t bufLen)
+{
+    if (handle == 0 || buffer == NULL) {
+        return -1;
+    }
+    size_t used = 0;
+    while (bufLen - used >= DIR_ENTRY_RECORD_MAX) {
+        errno = 0;
+        struct dirent* dirInfo = readdir((DIR*)handle);
+        if (dirInfo == NULL) {
+            if (errno != 0 && used == 0) {
+                return -1;
+            }
+            break;
+        }
+        if (IsDotOrDotDot(dirInfo->d_name)) {
+            continue;
+        }
+        size_t nameSize = strlen(dirInfo->d_name) + 1;
+        buffer[used] = GetDirEntryType(dirInfo);
+        if (memcpy_s(buffer + used + 1, bufLen - used - 1, dirInfo->d_name, nameSize) != EOK) {
+            return -1;
+        }
+        used += nameSize + 1;
+    }
+    return (int64_t)used;
+}
+
 extern void CJ_FS_CloseDirHandle(uintptr_t handle)
 {
     if (handle != 0) {
@@ -465,92 +600,59 @@ extern FsError* CJ_FS_DirCreate(const char* path)
     return result;
 }
 
-static int DeleteFileOrAppendDir(
-    const struct FolderNode* folderfirst, struct FolderNode** folderlast, struct dirent* dirInfo)
+/*
+ * Remove the files in the directory, and append its subdirectories to dirs. Files are removed relative to the
+ * directory with unlinkat, and the type from readdir saves lstat. Return 0, or -1 with errno set.
+ */
+static int DeleteDirFiles(const char* dirPath, struct DirList* dirs)
 {
-    if (strncmp(dirInfo->d_name, ".", sizeof(".")) == 0 || strncmp(dirInfo->d_name, "..", sizeof("..")) == 0) {
-        return 0;
-    }
-
-    char folderpath[MAX_PATH_LEN] = {0};
-    int err =
-        snprintf_s(folderpath, MAX_PATH_LEN, MAX_PATH_LEN - 1, "%s%c%s", folderfirst->path, SLASH, dirInfo->d_name);
-    if (err < 0) {
+    int dirFd = open(dirPath, DIR_OPEN_FLAGS);
+    if (dirFd < 0) {
         return -1;
     }
-
-    struct stat statbuf;
-    if (lstat(folderpath, &statbuf) != 0) {
+    DIR* dirPtr = fdopendir(dirFd);
+    if (dirPtr == NULL) {
+        int savedErrno = errno;
+        (void)close(dirFd);
+        errno = savedErrno;
         return -1;
     }
-
-    if (S_ISDIR(statbuf.st_mode) && !S_ISLNK(statbuf.st_mode)) {
-        struct FolderNode* foldernew = NULL;
-        foldernew = FolderNodeInit(folderpath);
-        if (foldernew == NULL) {
-            return -1;
+    int ret = 0;
+    struct dirent* dirInfo = NULL;
+    while (ret == 0 && (dirInfo = readdir(dirPtr)) != NULL) {
+        if (IsDotOrDotDot(dirInfo->d_name)) {
+            continue;
+        }
+        int isDir = IsDirEntryDirectory(dirfd(dirPtr), dirInfo);
+        if (isDir < 0) {
+            ret = -1;
+        } else if (isDir == 0) {
+            ret = unlinkat(dirfd(dirPtr), dirInfo->d_name, 0);
+        } else {
+            ret = DirListAppend(dirs, dirPath, dirInfo->d_name);
         }
-        foldernew->prior = *folderlast;
-        (*folderlast)->next = foldernew;
-        *folderlast = foldernew;
-    } else if (remove(folderpath) != 0) {
-        return -1;
     }
-    return 0;
+    int savedErrno = errno;
+    (void)closedir(dirPtr);
+    errno = savedErrno;
+    return ret;
 }
 
 static FsError* DeleteTree(const char* dirPath)
 {
-    int ret = 0;
-    DIR* dirPtr;
-    struct dirent* dirInfo;
-
-    struct FolderNode* folderstart;
-    folderstart = FolderNodeInit(dirPath);
-    if (folderstart == NULL) {
-        return GetErrnoResult();
-    }
-
-    struct FolderNode* folderfirst = folderstart;
-    struct FolderNode* folderlast = folderstart;
-    struct FolderNode* oldfirst = NULL;
-
-    while (folderfirst != NULL) {
-        dirPtr = opendir(folderfirst->path);
-        if (dirPtr == NULL) {
-            ret = -1;
-            break;
-        }
-
-        while ((dirInfo = readdir(dirPtr)) != NULL) {
-            ret = DeleteFileOrAppendDir(folderfirst, &folderlast, dirInfo);
-            if (ret == -1) {
-                break;
-            }
-        }
-
-        folderfirst = folderfirst->next;
-        (void)closedir(dirPtr);
-        if (ret == -1) {
-            break;
-        }
+    struct DirList dirs = { NULL, 0, 0 };
+    int ret = DirListAppend(&dirs, dirPath, NULL);
+    for (size_t i = 0; ret == 0 && i < dirs.count; ++i) {
+        ret = DeleteDirFiles(dirs.paths[i], &dirs);
     }
-
-    while (folderlast != NULL) {
-        if (ret == 0 && SysRmdir(folderlast->path) != 0) {
-            ret = -1;
-        }
-        oldfirst = folderlast;
-        folderlast = folderlast->prior;
-        if (oldfirst->path) {
-            free(oldfirst->path);
-            oldfirst->path = NULL;
-        }
-        free(oldfirst);
-        oldfirst = NULL;
+    // subdirectories are listed after their parents, so they are empty and removed first in reverse order.
+    for (size_t i = dirs.count; ret == 0 && i > 0; --i) {
+        ret = SysRmdir(dirs.paths[i - 1]);
     }
-
-    if (ret == -1) {
+    int savedErrno = errno;
+    DirListFree(&dirs);
+    errno = savedErrno;
+    if (ret != 0) {
         return GetErrnoResult();
     }
     return GetDefaultResult();
@@ -597,35 +699,129 @@ static ssize_t WriteAll(int fd, char* buf, ssize_t len)
     return sts;
 }
 
-extern int8_t CJ_FS_CopyREF(char* dir1, char* dir2)
+#if defined(__linux__)
+/* Whether a kernel copy fails because it does not support these files, so that the next method should be tried. */
+static bool IsCopyUnsupported(int err)
 {
-    char buf[BUF_SIZE];
+    return err == ENOSYS || err == EXDEV || err == EINVAL || err == EOPNOTSUPP || err == ENOTSUP || err == EPERM ||
+        err == EBADF || err == ETXTBSY;
+}
 
-    int fd1 = open(dir1, O_RDONLY);
-    if (fd1 < 0) {
-        return -1;
+/*
+ * Copy with copy_file_range, which may share extents or copy on the server side for network file systems.
+ * Fall back if nothing can be copied, e.g., the files are on different file systems before linux 5.3,
+ * or the source is a pseudo file whose size is reported as 0.
+ */
+static int CopyFileRange(int fdIn, int fdOut)
+{
+#if defined(SYS_copy_file_range)
+    bool copied = false;
+    while (true) {
+        ssize_t len = syscall(SYS_copy_file_range, fdIn, NULL, fdOut, NULL, (size_t)COPY_CHUNK_SIZE, 0U);
+        if (len > 0) {
+            copied = true;
+            continue;
+        }
+        if (len == 0) {
+            return copied ? COPY_DONE : COPY_FALLBACK;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return IsCopyUnsupported(errno) ? COPY_FALLBACK : COPY_FAILED;
     }
-    int fd2 = open(dir2, O_WRONLY | O_CREAT | O_TRUNC, DEFFILEMODE);
-    if (fd2 < 0) {
-        (void)close(fd1);
-        return -1;
+#else
+    (void)fdIn;
+    (void)fdOut;
+    return COPY_FALLBACK;
+#endif
+}
+
+/* Copy with sendfile, which moves pages in the kernel and supports regular output files since linux 2.6.33. */
+static int SendFile(int fdIn, int fdOut)
+{
+    bool copied = false;
+    while (true) {
+        ssize_t len = sendfile(fdOut, fdIn, NULL, (size_t)COPY_CHUNK_SIZE);
+        if (len > 0) {
+            copied = true;
+            continue;
+        }
+        if (len == 0) {
+            return copied ? COPY_DONE : COPY_FALLBACK;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        return IsCopyUnsupported(errno) ? COPY_FALLBACK : COPY_FAILED;
     }
+}
+#endif
 
-    ssize_t ret = read(fd1, buf, sizeof(buf) - 1);
-    while (ret > 0) {
-        if (WriteAll(fd2, buf, ret) < 0) {
-            (void)close(fd1);
-            (void)close(fd2);
-            return -1;
+static int CopyWithBuffer(int fdIn, int fdOut)
+{
+    char* buf = (char*)malloc(COPY_BUFFER_SIZE);
+    if (buf == NULL) {
+        return COPY_FAILED;
+    }
+    int ret = COPY_DONE;
+    while (true) {
+        ssize_t len = read(fdIn, buf, COPY_BUFFER_SIZE);
+        if (len == 0) {
+            break;
         }
-        if (memset_s(buf, sizeof(buf), 0, sizeof(buf)) != EOK) {
-            ret = -1;
+        if (len < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            ret = COPY_FAILED;
+            break;
+        }
+        if (WriteAll(fdOut, buf, len) < 0) {
+            ret = COPY_FAILED;
             break;
         }
-        ret = read(fd1, buf, sizeof(buf) - 1);
     }
+    free(buf);
+    return ret;
+}
 
-    if (ret == -1) {
+/*
+ * Copy the content of fdIn to fdOut, both of which are at offset 0 and fdOut is empty.
+ * On linux, the file is cloned with FICLONE if the file system supports reflinks, e.g., btrfs or xfs, else it
+ * is copied in the kernel with copy_file_range or sendfile. Data is copied through a user space buffer only if
+ * none of them works. Each method continues from the file offsets where the previous one stopped.
+ */
+static int CopyFileData(int fdIn, int fdOut)
+{
+#if defined(__linux__)
+    if (ioctl(fdOut, FICLONE, fdIn) == 0) {
+        return COPY_DONE;
+    }
+    int ret = CopyFileRange(fdIn, fdOut);
+    if (ret == COPY_FALLBACK) {
+        ret = SendFile(fdIn, fdOut);
+    }
+    if (ret != COPY_FALLBACK) {
+        return ret;
+    }
+#endif
+    return CopyWithBuffer(fdIn, fdOut);
+}
+
+extern int8_t CJ_FS_CopyREF(char* dir1, char* dir2)
+{
+    int fd1 = open(dir1, O_RDONLY | O_CLOEXEC);
+    if (fd1 < 0) {
+        return -1;
+    }
+    int fd2 = open(dir2, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, DEFFILEMODE);
+    if (fd2 < 0) {
+        (void)close(fd1);
+        return -1;
+    }
+
+    if (CopyFileData(fd1, fd2) != COPY_DONE) {
         (void)close(fd1);
         (void)close(fd2);
         return -1;
@@ -647,6 +843,12 @@ extern int8_t CJ_FS_CopyREF(char* dir1, char* dir2)
     return 0;
 }
 
+/* Copy the content of an opened file to an empty one, used when the destination is created by File. */
+extern int8_t CJ_FS_CopyFileData(intptr_t fdIn, intptr_t fdOut)
+{
+    return CopyFileData((int)fdIn, (int)fdOut) == COPY_DONE ? 0 : -1;
+}
+
 /*
  * File
  */
@@ -822,6 +1024,65 @@ extern intptr_t CJ_FS_CreateTempFile(char* path)
     return mkstemp(path);
 }
 
+/*
+ * Mapped file
+ */
+
+extern int64_t CJ_FS_GetPageSize(void)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    return pageSize > 0 ? (int64_t)pageSize : (int64_t)getpagesize();
+}
+
+/* Map length bytes of the file from offset, which is a multiple of the page size. Return NULL if failed. */
+extern void* CJ_FS_MapFile(intptr_t fd, int64_t offset, int64_t length, bool writable)
+{
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* addr = mmap(NULL, (size_t)length, prot, MAP_SHARED, (int)fd, (off_t)offset);
+    return addr == MAP_FAILED ? NULL : addr;
+}
+
+extern int32_t CJ_FS_UnmapFile(void* addr, int64_t length)
+{
+    return munmap(addr, (size_t)length);
+}
+
+/* Addr is aligned to the page size. Return 0, or -1 with errno set if failed. */
+extern int32_t CJ_FS_AdviseMappedFile(void* addr, int64_t length, int32_t advice)
+{
+    int sysAdvice;
+    switch (advice) {
+        case MAP_ADVICE_NORMAL:
+            sysAdvice = MADV_NORMAL;
+            break;
+        case MAP_ADVICE_SEQUENTIAL:
+            sysAdvice = MADV_SEQUENTIAL;
+            break;
+        case MAP_ADVICE_RANDOM:
+            sysAdvice = MADV_RANDOM;
+            break;
+        case MAP_ADVICE_WILL_NEED:
+            sysAdvice = MADV_WILLNEED;
+            break;
+        case MAP_ADVICE_DONT_NEED:
+            sysAdvice = MADV_DONTNEED;
+            break;
+        default:
+            errno = EINVAL;
+            return -1;
+    }
+    if (madvise(addr, (size_t)length, sysAdvice) != 0 && errno != ENOSYS) {
+        return -1;
+    }
+    return 0;
+}
+
+/* Write the modified pages back to the file, addr is aligned to the page size. */
+extern int32_t CJ_FS_SyncMappedFile(void* addr, int64_t length)
+{
+    return msync(addr, (size_t)length, MS_SYNC);
+}
+
 /*
  * Util
  */
@@ -861,23 +1122,6 @@ static FsError* GetErrnoResult(void)
     return result;
 }
 
-static int64_t BuildSubPath(char* dirPath, const int64_t pathLen, const char* subName)
-{
-    int64_t nameLen = (int64_t)strlen(subName);
-    if ((nameLen == 1 && subName[0] == '.') ||
-        (nameLen == 2 && subName[0] == '.' && subName[1] == '.')) { // 2 is the size of ".."
-        return -1;
-    }
-    if ((MAX_PATH_LEN - (pathLen + 1)) <= 0 || (MAX_PATH_LEN - (pathLen + 1)) < (nameLen + 1)) {
-        return -1;
-    }
-    errno_t rc = memcpy_s(dirPath + pathLen + 1, (size_t)(MAX_PATH_LEN - (pathLen + 1)), subName, (size_t)nameLen + 1);
-    if (rc != 0) {
-        return -1;
-    }
-    return pathLen + nameLen + 1;
-}
-
 extern FsError* CJ_FS_Truncate(int32_t fd, int64_t length)
 {
     int ret = ftruncate(fd, length);
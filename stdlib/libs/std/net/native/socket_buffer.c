@@ -24,12 +24,214 @@
 typedef struct SockBuffer {
     int32_t rBufSize;
     int32_t wBufSize;
-    char* rBuf;
-    char* wBuf;
+    // NULL until the first read or write, or after being released to the pool. A thread using a buffer takes it
+    // out with CJ_SocketClaimBuffer and puts it back with CJ_SocketReturnBuffer, so no other thread releases it.
+    _Atomic(char*) rBuf;
+    _Atomic(char*) wBuf;
     atomic_llong handle;
     atomic_int count;
+    atomic_int wLen; // size of the data copied to wBuf by the last CJ_SOCKET_BufferWCopy
 } SocketBuffer;
 
+/*
+ * Read and write buffers are taken from pools of size classes, 4 KiB to 64 KiB, which covers the buffers of TCP
+ * (4 KiB and 64 KiB) and UDP and unix sockets (64 KiB - 1). Larger buffers are allocated directly.
+ * Buffers are pooled in shards, which are assigned to OS threads round-robin. Each thread uses its own shard first so
+ * that threads seldom contend for a lock, and takes a buffer from another shard before allocating a new one.
+ * Pooled buffers are freed if the idle bytes would exceed maxIdleBytes.
+ * Buffers are not zero-filled, since their content is only read after being written by recv or by a copy.
+ */
+#define POOL_MIN_CLASS_SHIFT 12 // 4 KiB
+#define POOL_CLASS_NUM 5        // 4, 8, 16, 32 and 64 KiB
+#define POOL_SHARD_NUM 16
+#define POOL_DEFAULT_MAX_IDLE_BYTES (64LL * 1024 * 1024)
+#define POOL_SHARD_ALIGN 64 // a cache line, so that the lock of a shard does not share it with its neighbours
+
+#if defined(__aarch64__) || defined(__arm__)
+#define YIELD_PROCESSOR() __asm__ __volatile__("yield")
+#elif defined(__x86_64__) || defined(__i386__)
+#define YIELD_PROCESSOR() __asm__ __volatile__("pause")
+#else
+#define YIELD_PROCESSOR() ((void)0)
+#endif
+
+typedef struct PoolBlock {
+    struct PoolBlock* next;
+} PoolBlock;
+
+typedef struct {
+    atomic_int lock;
+    PoolBlock* freeLists[POOL_CLASS_NUM];
+} __attribute__((aligned(POOL_SHARD_ALIGN))) PoolShard;
+
+typedef struct {
+    int64_t hits;
+    int64_t misses;
+    int64_t residentBytes;
+    int64_t idleBytes;
+    int64_t maxIdleBytes;
+    bool releaseIdleBuffers;
+} SocketBufferPoolStats;
+
+static PoolShard g_poolShards[POOL_SHARD_NUM];
+static atomic_uint g_nextPoolShard;
+static __thread int g_poolShard = -1;
+static atomic_llong g_poolMaxIdleBytes = POOL_DEFAULT_MAX_IDLE_BYTES;
+static atomic_llong g_poolIdleBytes;
+static atomic_llong g_poolResidentBytes;
+static atomic_llong g_poolHits;
+static atomic_llong g_poolMisses;
+// Whether buffers are returned to the pool once a read or write is done, so that idle sockets do not hold them.
+static atomic_bool g_releaseIdleBuffers;
+
+static inline void PoolShardLock(PoolShard* shard)
+{
+    while (atomic_exchange_explicit(&shard->lock, 1, memory_order_acquire) != 0) {
+        while (atomic_load_explicit(&shard->lock, memory_order_relaxed) != 0) {
+            YIELD_PROCESSOR();
+        }
+    }
+}
+
+static inline bool PoolShardTryLock(PoolShard* shard)
+{
+    return atomic_load_explicit(&shard->lock, memory_order_relaxed) == 0 &&
+        atomic_exchange_explicit(&shard->lock, 1, memory_order_acquire) == 0;
+}
+
+static inline void PoolShardUnlock(PoolShard* shard)
+{
+    atomic_store_explicit(&shard->lock, 0, memory_order_release);
+}
+
+static int PoolGetLocalShard(void)
+{
+    if (g_poolShard < 0) {
+        g_poolShard = (int)(atomic_fetch_add_explicit(&g_nextPoolShard, 1, memory_order_relaxed) % POOL_SHARD_NUM);
+    }
+    return g_poolShard;
+}
+
+/* Return the size class of a buffer, or -1 if it is too large to be pooled. */
+static int PoolGetSizeClass(int32_t size)
+{
+    for (int sizeClass = 0; sizeClass < POOL_CLASS_NUM; ++sizeClass) {
+        if (size <= (1 << (POOL_MIN_CLASS_SHIFT + sizeClass))) {
+            return sizeClass;
+        }
+    }
+    return -1;
+}
+
+static PoolBlock* PoolPop(PoolShard* shard, int sizeClass)
+{
+    PoolBlock* block = shard->freeLists[sizeClass];
+    if (block != NULL) {
+        shard->freeLists[sizeClass] = block->next;
+    }
+    return block;
+}
+
+static char* PoolAcquire(int32_t size)
+{
+    int sizeClass = PoolGetSizeClass(size);
+    if (sizeClass >= 0) {
+        int local = PoolGetLocalShard();
+        PoolBlock* block = NULL;
+        for (int i = 0; i < POOL_SHARD_NUM && block == NULL; ++i) {
+            PoolShard* shard = &g_poolShards[(local + i) % POOL_SHARD_NUM];
+            // Wait for the local shard only, a busy remote one is skipped.
+            if (i == 0) {
+                PoolShardLock(shard);
+            } else if (!PoolShardTryLock(shard)) {
+                continue;
+            }
+            block = PoolPop(shard, sizeClass);
+            PoolShardUnlock(shard);
+        }
+        if (block != NULL) {
+            atomic_fetch_sub(&g_poolIdleBytes, 1LL << (POOL_MIN_CLASS_SHIFT + sizeClass));
+            atomic_fetch_add_explicit(&g_poolHits, 1, memory_order_relaxed);
+            return (char*)block;
+        }
+        size = 1 << (POOL_MIN_CLASS_SHIFT + sizeClass);
+    }
+    atomic_fetch_add_explicit(&g_poolMisses, 1, memory_order_relaxed);
+    char* buf = (char*)malloc((size_t)size);
+    if (buf != NULL) {
+        atomic_fetch_add(&g_poolResidentBytes, size);
+    }
+    return buf;
+}
+
+static void PoolRelease(char* buf, int32_t size)
+{
+    if (buf == NULL) {
+        return;
+    }
+    int sizeClass = PoolGetSizeClass(size);
+    if (sizeClass >= 0) {
+        long long classSize = 1LL << (POOL_MIN_CLASS_SHIFT + sizeClass);
+        long long idle = atomic_fetch_add(&g_poolIdleBytes, classSize) + classSize;
+        if (idle <= atomic_load_explicit(&g_poolMaxIdleBytes, memory_order_relaxed)) {
+            PoolShard* shard = &g_poolShards[PoolGetLocalShard()];
+            PoolBlock* block = (PoolBlock*)(void*)buf;
+            PoolShardLock(shard);
+            block->next = shard->freeLists[sizeClass];
+            shard->freeLists[sizeClass] = block;
+            PoolShardUnlock(shard);
+            return;
+        }
+        atomic_fetch_sub(&g_poolIdleBytes, classSize);
+        size = (int32_t)classSize;
+    }
+    atomic_fetch_sub(&g_poolResidentBytes, size);
+    free(buf);
+}
+
+/* Free pooled buffers until the idle bytes are within maxIdleBytes. */
+static void PoolTrim(void)
+{
+    for (int i = 0; i < POOL_SHARD_NUM; ++i) {
+        PoolShard* shard = &g_poolShards[i];
+        for (int sizeClass = POOL_CLASS_NUM - 1; sizeClass >= 0; --sizeClass) {
+            long long classSize = 1LL << (POOL_MIN_CLASS_SHIFT + sizeClass);
+            while (atomic_load(&g_poolIdleBytes) > atomic_load(&g_poolMaxIdleBytes)) {
+                PoolShardLock(shard);
+                PoolBlock* block = PoolPop(shard, sizeClass);
+                PoolShardUnlock(shard);
+                if (block == NULL) {
+                    break;
+                }
+                atomic_fetch_sub(&g_poolIdleBytes, classSize);
+                atomic_fetch_sub(&g_poolResidentBytes, classSize);
+                free(block);
+            }
+        }
+    }
+}
+
+/**
+ * Set the upper bound of the bytes kept in the pool by idle buffers, which are freed at once if it is lowered,
+ * and whether sockets return their buffers to the pool after each read or write.
+ */
+extern void CJ_SOCKET_BufferPoolConfigure(int64_t maxIdleBytes, bool releaseIdleBuffers)
+{
+    atomic_store(&g_poolMaxIdleBytes, maxIdleBytes < 0 ? 0 : maxIdleBytes);
+    atomic_store(&g_releaseIdleBuffers, releaseIdleBuffers);
+    PoolTrim();
+}
+
+extern void CJ_SOCKET_BufferPoolGetStats(SocketBufferPoolStats* stats)
+{
+    stats->hits = atomic_load_explicit(&g_poolHits, memory_order_relaxed);
+    stats->misses = atomic_load_explicit(&g_poolMisses, memory_order_relaxed);
+    stats->residentBytes = atomic_load(&g_poolResidentBytes);
+    stats->idleBytes = atomic_load(&g_poolIdleBytes);
+    stats->maxIdleBytes = atomic_load(&g_poolMaxIdleBytes);
+    stats->releaseIdleBuffers = atomic_load(&g_releaseIdleBuffers);
+}
+
 extern void* CJ_SOCKET_MallocWithInit(size_t size)
 {
     if (size == 0 || size > MAX_MALLOC_SIZE) {
@@ -38,6 +240,7 @@ extern void* CJ_SOCKET_MallocWithInit(size_t size)
     return calloc(1, size);
 }
 
+/* The read and write buffers are taken from the pool on first use. */
 extern SocketBuffer* CJ_SOCKET_BufferInit(long long handle, int32_t rBufSize, int32_t wBufSize)
 {
     if (handle == -1 || rBufSize <= 0 || wBufSize <= 0) {
@@ -47,17 +250,6 @@ extern SocketBuffer* CJ_SOCKET_BufferInit(long long handle, int32_t rBufSize, in
     if (sockBuf == NULL) {
         return NULL;
     }
-    sockBuf->rBuf = (char*)CJ_SOCKET_MallocWithInit((size_t)rBufSize);
-    if (sockBuf->rBuf == NULL) {
-        free(sockBuf);
-        return NULL;
-    }
-    sockBuf->wBuf = (char*)CJ_SOCKET_MallocWithInit((size_t)wBufSize);
-    if (sockBuf->wBuf == NULL) {
-        free(sockBuf->rBuf);
-        free(sockBuf);
-        return NULL;
-    }
     atomic_init(&sockBuf->handle, handle);
     atomic_init(&sockBuf->count, 1);
     sockBuf->rBufSize = rBufSize;
@@ -65,16 +257,39 @@ extern SocketBuffer* CJ_SOCKET_BufferInit(long long handle, int32_t rBufSize, in
     return sockBuf;
 }
 
+extern void CJ_SOCKET_BufferSetHandle(SocketBuffer* sockBuf, long long handle)
+{
+    atomic_store(&sockBuf->handle, handle);
+}
+
+/* Take the buffer out of the socket, or NULL if it has none. */
+static char* CJ_SocketClaimBuffer(_Atomic(char*)* slot)
+{
+    return atomic_exchange(slot, NULL);
+}
+
+/*
+ * Put a claimed buffer back into the socket. It is returned to the pool instead if release is set and idle buffers
+ * are released, or if another thread has put a buffer back meanwhile.
+ */
+static void CJ_SocketReturnBuffer(_Atomic(char*)* slot, char* buf, int32_t size, bool release)
+{
+    if (buf == NULL) {
+        return;
+    }
+    char* expected = NULL;
+    if ((release && atomic_load_explicit(&g_releaseIdleBuffers, memory_order_relaxed)) ||
+        !atomic_compare_exchange_strong(slot, &expected, buf)) {
+        PoolRelease(buf, size);
+    }
+}
+
 static void CJ_SocketFreeWrapperBuffer(SocketBuffer* sockBuf)
 {
-    char* itemR = sockBuf->rBuf;
-    sockBuf->rBuf = NULL;
+    PoolRelease(CJ_SocketClaimBuffer(&sockBuf->rBuf), sockBuf->rBufSize);
+    PoolRelease(CJ_SocketClaimBuffer(&sockBuf->wBuf), sockBuf->wBufSize);
     sockBuf->rBufSize = 0;
-    char* itemW = sockBuf->wBuf;
-    sockBuf->wBuf = NULL;
     sockBuf->wBufSize = 0;
-    free(itemR);
-    free(itemW);
     free(sockBuf);
 }
 
@@ -127,13 +342,23 @@ extern int32_t CJ_SOCKET_BufferRead(
         (void)CJ_SocketDecreaseRef(sockBuf);
         return 0;
     }
+    char* rBuf = CJ_SocketClaimBuffer(&sockBuf->rBuf);
+    if (rBuf == NULL) {
+        rBuf = PoolAcquire(sockBuf->rBufSize);
+    }
+    if (rBuf == NULL) {
+        (void)CJ_SocketDecreaseRef(sockBuf);
+        return -1;
+    }
     int32_t recvLen = 0;
     if (timeout < 0) {
-        recvLen = CJ_MRT_SockRecv(handle, (const char*)sockBuf->rBuf + bufOff, (unsigned int)maxReadSize, flags);
+        recvLen = CJ_MRT_SockRecv(handle, (const char*)rBuf + bufOff, (unsigned int)maxReadSize, flags);
     } else {
         recvLen = CJ_MRT_SockRecvTimeout(
-            handle, (const char*)sockBuf->rBuf + bufOff, (unsigned int)maxReadSize, flags, (uint64_t)timeout);
+            handle, (const char*)rBuf + bufOff, (unsigned int)maxReadSize, flags, (uint64_t)timeout);
     }
+    // No data is to be copied if the read fails.
+    CJ_SocketReturnBuffer(&sockBuf->rBuf, rBuf, sockBuf->rBufSize, recvLen <= 0);
     if (CJ_SocketDecreaseRef(sockBuf)) {
         return 0; // This affects subsequent operations. Therefore, return 0 directly.
     }
@@ -152,10 +377,20 @@ extern int32_t CJ_SOCKET_BufferRecvFrom(
         (void)CJ_SocketDecreaseRef(sockBuf);
         return 0;
     }
+    char* rBuf = CJ_SocketClaimBuffer(&sockBuf->rBuf);
+    if (rBuf == NULL) {
+        rBuf = PoolAcquire(sockBuf->rBufSize);
+    }
+    if (rBuf == NULL) {
+        (void)CJ_SocketDecreaseRef(sockBuf);
+        return -1;
+    }
     int32_t recvLen = 0;
 
     recvLen = CJ_MRT_SockRecvfromTimeout(
-        handle, (void*)sockBuf->rBuf + bufOff, (unsigned int)maxReadSize, flags, addr, (uint64_t)timeout);
+        handle, (void*)rBuf + bufOff, (unsigned int)maxReadSize, flags, addr, (uint64_t)timeout);
+    // No data is to be copied if the read fails.
+    CJ_SocketReturnBuffer(&sockBuf->rBuf, rBuf, sockBuf->rBufSize, recvLen <= 0);
 
     if (CJ_SocketDecreaseRef(sockBuf)) {
         return 0; // This affects subsequent operations. Therefore, return 0 directly.
@@ -175,13 +410,21 @@ extern int32_t CJ_SOCKET_BufferWrite(
         (void)CJ_SocketDecreaseRef(sockBuf);
         return 0;
     }
+    char* wBuf = CJ_SocketClaimBuffer(&sockBuf->wBuf);
+    if (wBuf == NULL) {
+        (void)CJ_SocketDecreaseRef(sockBuf);
+        return -1; // no data copied by CJ_SOCKET_BufferWCopy
+    }
     int32_t sendLen = 0;
     if (timeout < 0) {
-        sendLen = CJ_MRT_SockSend(handle, (const char*)sockBuf->wBuf + bufOff, (unsigned int)maxWriteSize, flags);
+        sendLen = CJ_MRT_SockSend(handle, (const char*)wBuf + bufOff, (unsigned int)maxWriteSize, flags);
     } else {
         sendLen = CJ_MRT_SockSendTimeout(
-            handle, (const char*)sockBuf->wBuf + bufOff, (unsigned int)maxWriteSize, flags, (uint64_t)timeout);
+            handle, (const char*)wBuf + bufOff, (unsigned int)maxWriteSize, flags, (uint64_t)timeout);
     }
+    // The write fails, or all data copied is sent.
+    size_t wLen = (size_t)atomic_load_explicit(&sockBuf->wLen, memory_order_relaxed);
+    CJ_SocketReturnBuffer(&sockBuf->wBuf, wBuf, sockBuf->wBufSize, sendLen <= 0 || bufOff + (size_t)sendLen >= wLen);
     (void)CJ_SocketDecreaseRef(sockBuf); // The value 0 is not returned because subsequent operations are not affected.
     return sendLen;
 }
@@ -198,8 +441,13 @@ extern int32_t CJ_SOCKET_BufferSendto(SocketBuffer* sockBuf, size_t bufOff, int3
         (void)CJ_SocketDecreaseRef(sockBuf);
         return 0;
     }
-    int32_t sendLen =
-        CJ_MRT_SockSendto(handle, (const char*)sockBuf->wBuf + bufOff, (unsigned int)maxWriteSize, flags, addr);
+    char* wBuf = CJ_SocketClaimBuffer(&sockBuf->wBuf);
+    if (wBuf == NULL) {
+        (void)CJ_SocketDecreaseRef(sockBuf);
+        return -1; // no data copied by CJ_SOCKET_BufferWCopy
+    }
+    int32_t sendLen = CJ_MRT_SockSendto(handle, (const char*)wBuf + bufOff, (unsigned int)maxWriteSize, flags, addr);
+    CJ_SocketReturnBuffer(&sockBuf->wBuf, wBuf, sockBuf->wBufSize, true); // a datagram is sent at once
 
     (void)CJ_SocketDecreaseRef(sockBuf); // The value 0 is not returned because subsequent operations are not affected.
     return sendLen;
@@ -207,14 +455,16 @@ extern int32_t CJ_SOCKET_BufferSendto(SocketBuffer* sockBuf, size_t bufOff, int3
 
 extern int32_t CJ_SOCKET_BufferRCopy(SocketBuffer* sockBuf, const char* arrBuf, int64_t bufLen, int32_t copyLen)
 {
-    if (CJ_SocketIncreaseRef(sockBuf) || bufLen <= 0 || copyLen <= 0) {
+    if (bufLen <= 0 || copyLen <= 0 || CJ_SocketIncreaseRef(sockBuf)) {
         return 0;
     }
-    if (copyLen > sockBuf->rBufSize || (int64_t)copyLen > bufLen) {
+    char* rBuf = copyLen > sockBuf->rBufSize || (int64_t)copyLen > bufLen ? NULL : CJ_SocketClaimBuffer(&sockBuf->rBuf);
+    if (rBuf == NULL) {
         (void)CJ_SocketDecreaseRef(sockBuf);
         return -1;
     }
-    int32_t ret = memcpy_s((void*)arrBuf, (size_t)bufLen, sockBuf->rBuf, (size_t)copyLen);
+    int32_t ret = memcpy_s((void*)arrBuf, (size_t)bufLen, rBuf, (size_t)copyLen);
+    CJ_SocketReturnBuffer(&sockBuf->rBuf, rBuf, sockBuf->rBufSize, true);
     (void)CJ_SocketDecreaseRef(sockBuf); // The value 0 is not returned because subsequent operations are not affected.
     if (ret == EOK) {
         return copyLen;
@@ -224,16 +474,25 @@ extern int32_t CJ_SOCKET_BufferRCopy(SocketBuffer* sockBuf, const char* arrBuf,
 
 extern int32_t CJ_SOCKET_BufferWCopy(SocketBuffer* sockBuf, const char* arrBuf, int64_t bufLen, int32_t copyLen)
 {
-    if (CJ_SocketIncreaseRef(sockBuf) || bufLen <= 0 || copyLen <= 0) {
+    if (bufLen <= 0 || copyLen <= 0 || CJ_SocketIncreaseRef(sockBuf)) {
         return 0;
     }
-    if (copyLen > sockBuf->wBufSize || (int64_t)copyLen > bufLen) {
+    char* wBuf = NULL;
+    if (copyLen <= sockBuf->wBufSize && (int64_t)copyLen <= bufLen) {
+        wBuf = CJ_SocketClaimBuffer(&sockBuf->wBuf);
+        if (wBuf == NULL) {
+            wBuf = PoolAcquire(sockBuf->wBufSize);
+        }
+    }
+    if (wBuf == NULL) {
         if (CJ_SocketDecreaseRef(sockBuf)) {
             return 0;
         }
         return -1;
     }
-    int32_t ret = memcpy_s((void*)sockBuf->wBuf, (size_t)sockBuf->wBufSize, arrBuf, (size_t)copyLen);
+    int32_t ret = memcpy_s((void*)wBuf, (size_t)sockBuf->wBufSize, arrBuf, (size_t)copyLen);
+    atomic_store_explicit(&sockBuf->wLen, ret == EOK ? copyLen : 0, memory_order_relaxed);
+    CJ_SocketReturnBuffer(&sockBuf->wBuf, wBuf, sockBuf->wBufSize, false);
     if (CJ_SocketDecreaseRef(sockBuf)) {
         return 0; // This affects subsequent operations. Therefore, return 0 directly.
     }
@@ -6,6 +6,7 @@
  * See https://cangjie-lang.cn/pages/LICENSE for license information.
  */
 
+#include <limits.h>
 #include <stdint.h>
 #include <stdlib.h>
 #if defined(_WIN32) && defined(__MINGW64__)
@@ -36,4 +37,30 @@ extern uint64_t CJ_Gettid(void)
     return (uint64_t)syscall(SYS_gettid);
 }
 
-#endif
\ No newline at end of file
+#endif
+
+#define MAX_SHARD_NUM 256
+
+extern unsigned int CJ_MRT_ProcessorLocalId(void);
+extern unsigned int CJ_ScheduleGetProcessorNum(void);
+
+/* Return the id of the current processor, or of the thread if the caller does not run on a processor. */
+extern uint64_t CJ_ObjectPoolShardHint(void)
+{
+    unsigned int processorId = CJ_MRT_ProcessorLocalId();
+    if (processorId != UINT_MAX) {
+        return (uint64_t)processorId;
+    }
+    return CJ_Gettid();
+}
+
+/* Return the number of shards of a pool, the number of processors rounded up to a power of 2. */
+extern int64_t CJ_ObjectPoolShardNum(void)
+{
+    unsigned int processorNum = CJ_ScheduleGetProcessorNum();
+    int64_t shardNum = 1;
+    while (shardNum < (int64_t)processorNum && shardNum < MAX_SHARD_NUM) {
+        shardNum <<= 1;
+    }
+    return shardNum;
+}
@@ -6,6 +6,9 @@
  * See https://cangjie-lang.cn/pages/LICENSE for license information.
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
 #include <errno.h>
 #include <fcntl.h>
 #include <pwd.h>
@@ -19,6 +22,17 @@
 #include <unistd.h>
 #include <stddef.h>
 #include <stdint.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+#if defined(__GLIBC__)
+#include <spawn.h>
+// posix_spawn_file_actions_addchdir_np (2.29) and posix_spawn_file_actions_addclosefrom_np (2.34). Without them
+// the child can't get the working directory and the descriptor cleanup of the fork path, which is used instead.
+#if __GLIBC_PREREQ(2, 34)
+#define HAS_POSIX_SPAWN 1
+#endif
+#endif
 #include "securec.h"
 #include "process_ffi_unix.h"
 
@@ -28,6 +42,8 @@ extern char** environ;
 #define INVALID_PID (-1)
 #define INVALID_FD (-1)
 #define ERRMSG_LEN (200)
+#define FIRST_INHERITED_FD (3)
+#define SPAWN_FALLBACK (-1)
 
 typedef struct ProcessStartInfo {
     char* command;
@@ -269,6 +285,23 @@ static int32_t UnBlockSignals(void)
     return 0;
 }
 
+/* Close the descriptors the child would inherit from the runtime and other threads, except keepFd. */
+static void CloseInheritedFds(int32_t keepFd)
+{
+#if defined(__linux__) && defined(SYS_close_range)
+    if (keepFd < FIRST_INHERITED_FD) {
+        (void)syscall(SYS_close_range, FIRST_INHERITED_FD, ~0U, 0);
+        return;
+    }
+    if (keepFd > FIRST_INHERITED_FD) {
+        (void)syscall(SYS_close_range, FIRST_INHERITED_FD, keepFd - 1, 0);
+    }
+    (void)syscall(SYS_close_range, keepFd + 1, ~0U, 0);
+#else
+    (void)keepFd;
+#endif
+}
+
 static void ChildProcess(
     ProcessStartInfo* info, char** arguments, char** environment, 
     int32_t filedes[STD_COUNT][WR_COUNT], int32_t* error, int32_t errorSize)
@@ -301,6 +334,7 @@ static void ChildProcess(
         return;
     }
 
+    CloseInheritedFds(error[WRITE]);
     Execvpe(info->command, arguments, environment);
     WriteError(error[WRITE], &errno);
 }
@@ -362,6 +396,100 @@ static int32_t HandleFd(const ProcessStartInfo* info, int32_t filedes[STD_COUNT]
     return 0;
 }
 
+static void SetErrorData(ProcessRtnData* processData, int32_t errCode)
+{
+    processData->errMessage = GetErrMessage(errCode);
+    processData->errCode = errCode;
+}
+
+#ifdef HAS_POSIX_SPAWN
+/* execvp in the child looks the command up in the PATH of the new environment, posix_spawnp in ours. */
+static bool IsSamePathLookup(const char* command, char** environment)
+{
+    if (environment == NULL || strchr(command, '/') != NULL) {
+        return true;
+    }
+    const char* path = getenv("PATH");
+    for (char** p = environment; *p != NULL; p++) {
+        if (strncmp(*p, "PATH=", strlen("PATH=")) == 0) {
+            return path != NULL && strcmp(*p + strlen("PATH="), path) == 0;
+        }
+    }
+    return path == NULL;
+}
+
+/* The same redirection, descriptor cleanup and working directory change as ChildProcess does after fork. */
+static int32_t AddSpawnFileActions(
+    posix_spawn_file_actions_t* actions, const ProcessStartInfo* info, int32_t filedes[STD_COUNT][WR_COUNT])
+{
+    const intptr_t infoFds[STD_COUNT] = {info->stdIn, info->stdOut, info->stdErr};
+    for (int32_t i = STDIN; i <= STDERR; i++) {
+        int32_t parentEnd = (i == STDIN) ? WRITE : READ;
+        int32_t childEnd = (i == STDIN) ? READ : WRITE;
+        int32_t ret;
+        if (infoFds[i] == -1) { // Close the parent end in pipe mode.
+            ret = posix_spawn_file_actions_addclose(actions, filedes[i][parentEnd]);
+            if (ret != 0) {
+                return ret;
+            }
+        }
+        ret = posix_spawn_file_actions_adddup2(actions, filedes[i][childEnd], i);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    int32_t ret = posix_spawn_file_actions_addclosefrom_np(actions, FIRST_INHERITED_FD);
+    if (ret != 0) {
+        return ret;
+    }
+    if (info->workingDirectory != NULL) {
+        return posix_spawn_file_actions_addchdir_np(actions, info->workingDirectory);
+    }
+    return 0;
+}
+
+/*
+ * Start the child with posix_spawnp, which clones with CLONE_VM | CLONE_VFORK on glibc instead of copying
+ * the page tables of the whole heap as fork does. Exec errors are returned by posix_spawnp itself, which
+ * has reaped the child then. Return SPAWN_FALLBACK when only the fork path keeps the semantics of execvp:
+ * a PATH changed by the new environment, or a script without "#!" which execvp runs with /bin/sh.
+ */
+static int32_t SpawnProcess(const ProcessStartInfo* info, char** arguments, char** environment,
+    int32_t filedes[STD_COUNT][WR_COUNT], pid_t* pid)
+{
+    if (!IsSamePathLookup(info->command, environment)) {
+        return SPAWN_FALLBACK;
+    }
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    int32_t ret = posix_spawn_file_actions_init(&actions);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = posix_spawnattr_init(&attr);
+    if (ret != 0) {
+        (void)posix_spawn_file_actions_destroy(&actions);
+        return ret;
+    }
+    sigset_t emptySet;
+    (void)sigemptyset(&emptySet);
+    ret = AddSpawnFileActions(&actions, info, filedes);
+    if (ret == 0) {
+        ret = posix_spawnattr_setsigmask(&attr, &emptySet);
+    }
+    if (ret == 0) {
+        ret = posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+    }
+    if (ret == 0) {
+        ret = posix_spawnp(pid, info->command, &actions, &attr, arguments,
+            environment != NULL ? environment : environ);
+    }
+    (void)posix_spawnattr_destroy(&attr);
+    (void)posix_spawn_file_actions_destroy(&actions);
+    return (ret == ENOEXEC) ? SPAWN_FALLBACK : ret;
+}
+#endif
+
 /* Create and execute a child process. */
 extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
 {
@@ -376,16 +504,7 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
         {INVALID_FD, INVALID_FD}, {INVALID_FD, INVALID_FD}, {INVALID_FD, INVALID_FD}};
     if (InitFiledes(info, filedes) < 0) {
         CloseFiledes(filedes);
-        processData->errMessage = GetErrMessage(errno);
-        processData->errCode = errno;
-        return processData;
-    }
-
-    int32_t error[WR_COUNT] = {INVALID_FD, INVALID_FD};
-    if (pipe(error) < 0) {
-        CloseFiledes(filedes);
-        processData->errMessage = GetErrMessage(errno);
-        processData->errCode = errno;
+        SetErrorData(processData, errno);
         return processData;
     }
 
@@ -396,10 +515,7 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
     char** arguments = CopyTwoDimensionalArray(info->arguments, info->argSize);
     if (arguments == NULL) {
         CloseFiledes(filedes);
-        (void)close(error[READ]);
-        (void)close(error[WRITE]);
-        processData->errMessage = GetErrMessage(errno);
-        processData->errCode = errno;
+        SetErrorData(processData, errno);
         return processData;
     }
 
@@ -409,12 +525,40 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
         if (environment == NULL) {
             FreeTwoDimensionalArray(arguments);
             CloseFiledes(filedes);
-            (void)close(error[READ]);
-            (void)close(error[WRITE]);
-            processData->errMessage = GetErrMessage(errno);
-            processData->errCode = errno;
+            SetErrorData(processData, errno);
+            return processData;
+        }
+    }
+
+#ifdef HAS_POSIX_SPAWN
+    pid_t spawnPid = INVALID_PID;
+    int32_t spawnRet = SpawnProcess(info, arguments, environment, filedes, &spawnPid);
+    if (spawnRet != SPAWN_FALLBACK) {
+        FreeTwoDimensionalArray(arguments);
+        FreeTwoDimensionalArray(environment);
+        if (spawnRet != 0) {
+            CloseFiledes(filedes);
+            processData->pid = 0; // There is no child to wait for.
+            SetErrorData(processData, spawnRet);
+            return processData;
+        }
+        processData->pid = spawnPid;
+        if (HandleFd(info, filedes, processData) < 0) {
+            SetErrorData(processData, errno);
             return processData;
         }
+        SetErrorData(processData, 0);
+        return processData;
+    }
+#endif
+
+    int32_t error[WR_COUNT] = {INVALID_FD, INVALID_FD};
+    if (pipe(error) < 0) {
+        FreeTwoDimensionalArray(arguments);
+        FreeTwoDimensionalArray(environment);
+        CloseFiledes(filedes);
+        SetErrorData(processData, errno);
+        return processData;
     }
 
     // Create a child process.
@@ -425,8 +569,7 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
         CloseFiledes(filedes);
         (void)close(error[READ]);
         (void)close(error[WRITE]);
-        processData->errMessage = GetErrMessage(errno);
-        processData->errCode = errno;
+        SetErrorData(processData, errno);
         return processData;
     }
 
@@ -439,8 +582,7 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
         FreeTwoDimensionalArray(environment);
         // Close redundant file descriptors in pipe mode.
         if (HandleFd(info, filedes, processData) < 0) {
-            processData->errMessage = GetErrMessage(errno);
-            processData->errCode = errno;
+            SetErrorData(processData, errno);
             return processData;
         }
         (void)close(error[WRITE]);
@@ -448,13 +590,30 @@ extern ProcessRtnData* CJ_OS_StartProcess(ProcessStartInfo* info)
         uint8_t errCode = 0;
         ReadError(error[READ], &errCode, sizeof(errCode));
         (void)close(error[READ]);
-        processData->errMessage = GetErrMessage((int32_t)errCode);
-        processData->errCode = errCode;
+        SetErrorData(processData, (int32_t)errCode);
     }
 
     return processData;
 }
 
+/*
+ * Open a pidfd of the child, which becomes readable when it exits, so that the exit can be waited on the netpoller
+ * instead of blocking a thread in waitpid. Return -1 if pidfds are not supported.
+ */
+extern int32_t CJ_OS_OpenPidfd(int32_t pid)
+{
+#if defined(__linux__) && defined(SYS_pidfd_open)
+    int32_t fd = (int32_t)syscall(SYS_pidfd_open, pid, 0);
+    if (fd >= 0) {
+        (void)fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+    return fd;
+#else
+    (void)pid;
+    return -1;
+#endif
+}
+
 /* Waiting for the process to end. */
 extern int64_t CJ_OS_WaitSubProcessExit(int32_t pid)
 {
@@ -6,6 +6,10 @@
  * See https://cangjie-lang.cn/pages/LICENSE for license information.
  */
 
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdatomic.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
@@ -15,154 +19,240 @@
 #define EXPAND_MUL (2)
 #define MAX_PATH_LEN (4096)
 #define BUF_LEN (4096)
-#ifndef __android__
-#define CHAR_MAX (255)
-#endif
-
-typedef struct EnvListNode {
-    char* env;
-    struct EnvListNode* next;
-} EnvListNode;
-
-static void FreeList(EnvListNode* listHead, bool force)
+#define STAT_BUF_LEN (1024)
+#define PROC_PATH_LEN (64)
+#define STAT_FIELD_PPID (4)
+#define STAT_FIELD_UTIME (14)
+#define STAT_FIELD_STIME (15)
+#define STAT_FIELD_STARTTIME (22)
+#define DECIMAL (10)
+
+typedef struct ProcStat {
+    const char* name; // points into the buffer that is parsed
+    size_t nameLen;
+    int32_t ppid;
+    int64_t times[PROCESS_TIME_ARRAY_LENGTH]; // indexed by TIMEKIND_CREATE, TIMEKIND_SYSTEM and TIMEKIND_USER
+} ProcStat;
+
+// Fields of one process enumerated by CJ_OS_GetAllProcessStats, strings are offsets in the pool of the list.
+typedef struct ProcessStat {
+    int32_t pid;
+    int32_t ppid;
+    int64_t startTime; // milliseconds since the Unix epoch, -1 if the boot time is unknown.
+    int64_t userTime;
+    int64_t systemTime;
+    size_t nameOffset;
+    size_t cmdlineOffset; // '\0' separated arguments of cmdlineLen bytes, cmdlineLen is 0 if not read.
+    size_t cmdlineLen;
+} ProcessStat;
+
+typedef struct ProcessStatList {
+    ProcessStat* stats;
+    size_t size;
+    char* pool;
+    size_t poolSize;
+} ProcessStatList;
+
+// Boot time in milliseconds since the Unix epoch, 0 if not yet read.
+static atomic_llong g_bootTime = 0;
+static atomic_long g_clockTicks = 0;
+
+/* Read until the buffer is full or the end of file. Return the length read, or -1. */
+static ssize_t ReadFull(int fd, char* buffer, size_t bufLen)
 {
-    EnvListNode* current = listHead;
-    EnvListNode* next = NULL;
-    while (current != NULL) {
-        next = current->next;
-        if (force) {
-            free(current->env);
+    size_t total = 0;
+    while (total < bufLen) {
+        ssize_t readLen = read(fd, buffer + total, bufLen - total);
+        if (readLen < 0 && errno == EINTR) {
+            continue;
         }
-        free(current);
-        current = next;
+        if (readLen < 0) {
+            return -1;
+        }
+        if (readLen == 0) {
+            break;
+        }
+        total += (size_t)readLen;
     }
+    return (ssize_t)total;
 }
 
-static char* ExpandStr(char* strDest, size_t oldsize, size_t newsize)
+/* Read a file in /proc with plain reads, without the stdio buffer. Return the length read, or -1. */
+static ssize_t ReadProcFile(const char* path, char* buffer, size_t bufLen)
 {
-    if (newsize <= oldsize) {
-        return NULL;
-    }
-
-    if (strDest == NULL) {
-        return NULL;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
     }
+    ssize_t total = ReadFull(fd, buffer, bufLen);
+    (void)close(fd);
+    return total;
+}
 
-    char* buffer = (char*)calloc(newsize, sizeof(char));
-    if (buffer == NULL) {
+/*
+ * Read a whole file in /proc into one buffer, which grows only if the file does not fit in BUF_LEN. The buffer is
+ * terminated by an extra '\0' which is not counted in readLen.
+ */
+static char* ReadProcFileAlloc(const char* path, size_t* readLen)
+{
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
         return NULL;
     }
-
-    if (memcpy_s(buffer, newsize, strDest, oldsize) != EOK) {
-        free(buffer);
-        return NULL;
+    size_t capacity = BUF_LEN;
+    char* buffer = (char*)malloc(capacity);
+    size_t total = 0;
+    while (buffer != NULL) {
+        if (total == capacity - 1) {
+            char* newBuffer = (char*)realloc(buffer, capacity * EXPAND_MUL);
+            if (newBuffer == NULL) {
+                free(buffer);
+                buffer = NULL;
+                break;
+            }
+            buffer = newBuffer;
+            capacity *= EXPAND_MUL;
+        }
+        ssize_t len = read(fd, buffer + total, capacity - 1 - total);
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len < 0) {
+            free(buffer);
+            buffer = NULL;
+        } else if (len == 0) {
+            buffer[total] = '\0';
+            *readLen = total;
+            break;
+        } else {
+            total += (size_t)len;
+        }
     }
+    (void)close(fd);
     return buffer;
 }
 
-static char* ReadUntil(FILE* fp, int32_t tag, size_t* readLen)
+/*
+ * Parse the content of /proc/[pid]/stat. The name may contain spaces and parentheses, so fields are counted from
+ * the last ')'.
+ */
+static bool ParseProcStat(char* buffer, size_t len, ProcStat* stat)
 {
-    char* buffer = (char*)calloc(BUF_LEN, sizeof(char));
-    if (buffer == NULL) {
-        return NULL;
-    }
-
-    size_t lenth = BUF_LEN;
-    size_t i;
-    for (i = 0;; i++) {
-        if (i >= (lenth - 1)) {
-            char* oldbuf = buffer;
-            buffer = ExpandStr(oldbuf, lenth, lenth * EXPAND_MUL);
-            if (buffer == NULL) {
-                free(oldbuf);
-                return NULL;
-            }
-
-            lenth = lenth * EXPAND_MUL;
-            free(oldbuf);
+    buffer[len] = '\0';
+    char* nameBegin = strchr(buffer, '(');
+    char* nameEnd = strrchr(buffer, ')');
+    if (nameBegin == NULL || nameEnd == NULL || nameEnd < nameBegin) {
+        return false;
+    }
+    stat->name = nameBegin + 1;
+    stat->nameLen = (size_t)(nameEnd - nameBegin - 1);
+
+    char* cursor = nameEnd + 1;
+    int32_t parsed = 0;
+    for (int32_t field = 3; field <= STAT_FIELD_STARTTIME; field++) { // field 3 is the state.
+        while (*cursor == ' ') {
+            cursor++;
         }
-
-        int32_t c = fgetc(fp);
-        if (c == tag) {
-            break;
+        if (*cursor == '\0') {
+            return false;
         }
-        if (c == EOF || c < 0 || c > CHAR_MAX) {
-            free(buffer);
-            return NULL;
+        char* fieldEnd = NULL;
+        long long value = (field == 3) ? 0 : strtoll(cursor, &fieldEnd, DECIMAL);
+        switch (field) {
+            case STAT_FIELD_PPID:
+                stat->ppid = (int32_t)value;
+                parsed++;
+                break;
+            case STAT_FIELD_UTIME:
+                stat->times[TIMEKIND_USER] = (int64_t)value;
+                parsed++;
+                break;
+            case STAT_FIELD_STIME:
+                stat->times[TIMEKIND_SYSTEM] = (int64_t)value;
+                parsed++;
+                break;
+            case STAT_FIELD_STARTTIME:
+                stat->times[TIMEKIND_CREATE] = (int64_t)value;
+                parsed++;
+                break;
+            default:
+                break;
+        }
+        while (*cursor != ' ' && *cursor != '\0') {
+            cursor++;
         }
-        buffer[i] = (char)c;
     }
+    return parsed == PROCESS_TIME_ARRAY_LENGTH + 1;
+}
 
-    if (strlen(buffer) == 0) {
-        free(buffer);
-        return NULL;
+/* Read /proc/[pid]/stat with one read into the buffer of the caller, which must hold STAT_BUF_LEN bytes. */
+static bool ReadProcStat(int32_t pid, char* buffer, ProcStat* stat)
+{
+    char filename[PROC_PATH_LEN] = {0};
+    if (sprintf_s(filename, PROC_PATH_LEN, "/proc/%d/stat", pid) < 0) {
+        return false;
     }
+    ssize_t len = ReadProcFile(filename, buffer, STAT_BUF_LEN - 1);
+    if (len <= 0) {
+        return false;
+    }
+    return ParseProcStat(buffer, (size_t)len, stat);
+}
 
-    if (readLen != NULL) {
-        *readLen = i;
+static int64_t TicksToMilliSeconds(int64_t ticks)
+{
+    long clockTicks = atomic_load_explicit(&g_clockTicks, memory_order_relaxed);
+    if (clockTicks <= 0) {
+        clockTicks = sysconf(_SC_CLK_TCK);
+        atomic_store_explicit(&g_clockTicks, clockTicks, memory_order_relaxed);
     }
-    return buffer;
+    return (int64_t)(((double)ticks / clockTicks) * SECOND_TO_MILLI_SECOND);
 }
 
 // Note: This function reads the environment variables snapshot of a process with the given PID, not realtime.
 static char** GetEnvironmentSnapshot(int32_t pid)
 {
-    char filename[MAX_PATH_LEN] = {0};
-    if (sprintf_s(filename, MAX_PATH_LEN, "/proc/%d/environ", pid) < 0) {
-        return NULL;
-    }
-
-    FILE* fp = fopen(filename, "r");
-    if (fp == NULL) {
+    char filename[PROC_PATH_LEN] = {0};
+    if (sprintf_s(filename, PROC_PATH_LEN, "/proc/%d/environ", pid) < 0) {
         return NULL;
     }
 
-    EnvListNode* envListHead = (EnvListNode*)calloc(1, sizeof(EnvListNode));
-    if (envListHead == NULL) {
-        (void)fclose(fp);
+    size_t len = 0;
+    char* content = ReadProcFileAlloc(filename, &len);
+    if (content == NULL) {
         return NULL;
     }
 
-    EnvListNode* before = envListHead;
+    // Entries are terminated by '\0', and the list ends at an empty or unterminated entry.
     size_t envCount = 0;
-    for (;;) {
-        char* env = ReadUntil(fp, 0, NULL);
-        if (env == NULL) {
+    size_t offset = 0;
+    while (offset < len && content[offset] != '\0') {
+        size_t envLen = strnlen(content + offset, len - offset);
+        if (offset + envLen == len) {
             break;
         }
-
-        EnvListNode* current = (EnvListNode*)calloc(1, sizeof(EnvListNode));
-        if (current == NULL) {
-            free(env);
-            FreeList(envListHead, true);
-            (void)fclose(fp);
-            return NULL;
-        }
-
-        before->next = current;
-        current->env = env;
-        before = current;
         envCount++;
+        offset += envLen + 1;
     }
-    (void)fclose(fp);
 
     char** environment = (char**)calloc(envCount + 1, sizeof(char*));
     if (environment == NULL) {
-        FreeList(envListHead, true);
+        free(content);
         return NULL;
     }
 
-    EnvListNode* eachEnv = envListHead->next;
+    char* env = content;
     for (size_t i = 0; i < envCount; i++) {
-        if (eachEnv == NULL) {
-            break;
+        size_t envSize = strlen(env) + 1;
+        environment[i] = (char*)malloc(envSize);
+        if (environment[i] == NULL || memcpy_s(environment[i], envSize, env, envSize) != EOK) {
+            FreeTwoDimensionalArray(environment);
+            free(content);
+            return NULL;
         }
-        environment[i] = eachEnv->env;
-        eachEnv = eachEnv->next;
+        env += envSize;
     }
-    environment[envCount] = NULL;
-    FreeList(envListHead, false);
-
+    free(content);
     return environment;
 }
 
@@ -199,23 +289,16 @@ static char* GetWorkingDirectory(int32_t pid)
 
 static char* GetProcessCmdline(int32_t pid, size_t* cmdLen)
 {
-    char filename[MAX_PATH_LEN] = {0};
-    if (sprintf_s(filename, MAX_PATH_LEN, "/proc/%d/cmdline", pid) < 0) {
-        return NULL;
-    }
-
-    FILE* fp = fopen(filename, "r");
-    if (fp == NULL) {
+    char filename[PROC_PATH_LEN] = {0};
+    if (sprintf_s(filename, PROC_PATH_LEN, "/proc/%d/cmdline", pid) < 0) {
         return NULL;
     }
 
-    char* cmdLine = ReadUntil(fp, EOF, cmdLen);
-    if (cmdLine == NULL) {
-        (void)fclose(fp);
+    char* cmdLine = ReadProcFileAlloc(filename, cmdLen);
+    if (cmdLine != NULL && cmdLine[0] == '\0') { // Kernel threads have no command line.
+        free(cmdLine);
         return NULL;
     }
-
-    (void)fclose(fp);
     return cmdLine;
 }
 
@@ -361,38 +444,43 @@ static char** GetCommandLine(char* command, char** arguments)
 /**
  * @brief Retrieves the system boot time in milliseconds since the Unix epoch.
  *
- * This function reads the `/proc/stat` file to extract the `btime` value, which represents
- * the system boot time in seconds since the Unix epoch. The boot time is then converted
- * to milliseconds.
+ * This function reads the `btime` value of the `/proc/stat` file, which represents
+ * the system boot time in seconds since the Unix epoch, on the first call only.
+ * The boot time is then converted to milliseconds and cached.
  *
  * @return The boot time in milliseconds since the Unix epoch, or:
  *         - `ERROR_NOT_FIND_BOOTTIME` if the `btime` value cannot be found or read.
  */
 static int64_t GetBootTime(void)
 {
-    FILE* fp = fopen("/proc/stat", "r");
-    if (fp == NULL) {
+    int64_t cached = atomic_load_explicit(&g_bootTime, memory_order_relaxed);
+    if (cached > 0) {
+        return cached;
+    }
+
+    size_t len = 0;
+    char* content = ReadProcFileAlloc("/proc/stat", &len);
+    if (content == NULL) {
         return ERROR_NOT_FIND_BOOTTIME;
     }
 
-    char path[MAX_PATH_LEN];
     int64_t bootTime = -1;
-    while (fgets(path, sizeof(path), fp) != NULL) {
-        if (strncmp(path, "btime", strlen("btime")) == 0) {
-            if (sscanf_s(path, "btime %ld", &bootTime) != 1) {
-                fclose(fp);
-                return ERROR_NOT_FIND_BOOTTIME;
-            }
-            break;
+    char* line = strstr(content, "\nbtime ");
+    if (line != NULL) {
+        char* end = NULL;
+        bootTime = (int64_t)strtoll(line + strlen("\nbtime "), &end, DECIMAL);
+        if (end == line + strlen("\nbtime ")) {
+            bootTime = -1;
         }
     }
+    free(content);
 
-    (void)fclose(fp);
-
-    if (bootTime != -1) {
-        return (int64_t)(bootTime * SECOND_TO_MILLI_SECOND);
+    if (bootTime <= 0) {
+        return ERROR_NOT_FIND_BOOTTIME;
     }
-    return ERROR_NOT_FIND_BOOTTIME;
+    bootTime *= SECOND_TO_MILLI_SECOND;
+    atomic_store_explicit(&g_bootTime, bootTime, memory_order_relaxed);
+    return bootTime;
 }
 
 /**
@@ -413,27 +501,12 @@ static int64_t GetBootTime(void)
  */
 static int64_t GetProcessTime(int32_t pid, int8_t kind)
 {
-    char filename[MAX_PATH_LEN] = {0};
-    if (sprintf_s(filename, MAX_PATH_LEN, "/proc/%d/stat", pid) < 0) {
+    char buffer[STAT_BUF_LEN];
+    ProcStat stat;
+    if (!ReadProcStat(pid, buffer, &stat)) {
         return ERROR_GET_PROCESS_TIME_FAILED;
     }
-
-    FILE* fp = fopen(filename, "r");
-    if (fp == NULL) {
-        return ERROR_GET_PROCESS_TIME_FAILED;
-    }
-
-    int64_t processTime[PROCESS_TIME_ARRAY_LENGTH] = {0}; // starttime, stime, utime
-    if (fscanf_s(fp,
-        "%*d %*s %*c %*d %*d %*d %*d %*d %*d %*d %*d %*d %*d %ld %ld %*d %*d %*d %*d %*d %*d %lld %*d %*d %*d %*d",
-        &processTime[TIMEKIND_USER], &processTime[TIMEKIND_SYSTEM],
-        &processTime[TIMEKIND_CREATE]) != PROCESS_TIME_ARRAY_LENGTH) {
-        (void)fclose(fp);
-        return ERROR_GET_PROCESS_TIME_FAILED;
-    }
-
-    (void)fclose(fp);
-    return (int64_t)(((double)processTime[kind] / sysconf(_SC_CLK_TCK)) * SECOND_TO_MILLI_SECOND);
+    return TicksToMilliSeconds(stat.times[kind]);
 }
 
 /**
@@ -575,3 +648,158 @@ extern ProcessInfo* CJ_OS_GetProcessInfoByPid(int32_t pid)
 
     return linuxInfo;
 }
+
+static bool ReservePool(ProcessStatList* list, size_t* capacity, size_t required)
+{
+    if (list->poolSize + required <= *capacity) {
+        return true;
+    }
+    size_t newCapacity = *capacity;
+    while (list->poolSize + required > newCapacity) {
+        newCapacity *= EXPAND_MUL;
+    }
+    char* newPool = (char*)realloc(list->pool, newCapacity);
+    if (newPool == NULL) {
+        return false;
+    }
+    list->pool = newPool;
+    *capacity = newCapacity;
+    return true;
+}
+
+/* Read /proc/[pid]/cmdline to the end of the pool. */
+static bool AppendCmdline(ProcessStatList* list, size_t* capacity, int32_t pid, ProcessStat* stat)
+{
+    char filename[PROC_PATH_LEN] = {0};
+    if (sprintf_s(filename, PROC_PATH_LEN, "/proc/%d/cmdline", pid) < 0) {
+        return false;
+    }
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return true; // The process has exited, or is not accessible.
+    }
+    size_t offset = list->poolSize;
+    for (;;) {
+        if (!ReservePool(list, capacity, BUF_LEN)) {
+            (void)close(fd);
+            return false;
+        }
+        size_t room = *capacity - list->poolSize;
+        ssize_t len = ReadFull(fd, list->pool + list->poolSize, room);
+        if (len < 0) {
+            break;
+        }
+        list->poolSize += (size_t)len;
+        if ((size_t)len < room) {
+            break;
+        }
+    }
+    (void)close(fd);
+    // Arguments are expected to be terminated by '\0', which is added if the process changed its command line.
+    if (list->poolSize > offset && list->pool[list->poolSize - 1] != '\0') {
+        if (!ReservePool(list, capacity, 1)) {
+            return false;
+        }
+        list->pool[list->poolSize++] = '\0';
+    }
+    stat->cmdlineOffset = offset;
+    stat->cmdlineLen = list->poolSize - offset;
+    return true;
+}
+
+static bool AppendProcessStat(ProcessStatList* list, size_t* statCapacity, size_t* poolCapacity, int32_t pid,
+    bool withCommandLine)
+{
+    char buffer[STAT_BUF_LEN];
+    ProcStat procStat;
+    if (!ReadProcStat(pid, buffer, &procStat)) {
+        return true; // The process has exited.
+    }
+    if (list->size == *statCapacity) {
+        ProcessStat* newStats = (ProcessStat*)realloc(list->stats, *statCapacity * EXPAND_MUL * sizeof(ProcessStat));
+        if (newStats == NULL) {
+            return false;
+        }
+        list->stats = newStats;
+        *statCapacity *= EXPAND_MUL;
+    }
+    if (!ReservePool(list, poolCapacity, procStat.nameLen + 1)) {
+        return false;
+    }
+
+    ProcessStat* stat = &list->stats[list->size];
+    stat->pid = pid;
+    stat->ppid = procStat.ppid;
+    int64_t bootTime = GetBootTime();
+    stat->startTime = (bootTime == ERROR_NOT_FIND_BOOTTIME) ? -1 :
+        bootTime + TicksToMilliSeconds(procStat.times[TIMEKIND_CREATE]);
+    stat->userTime = TicksToMilliSeconds(procStat.times[TIMEKIND_USER]);
+    stat->systemTime = TicksToMilliSeconds(procStat.times[TIMEKIND_SYSTEM]);
+    stat->nameOffset = list->poolSize;
+    (void)memcpy_s(list->pool + list->poolSize, *poolCapacity - list->poolSize, procStat.name, procStat.nameLen);
+    list->pool[list->poolSize + procStat.nameLen] = '\0';
+    list->poolSize += procStat.nameLen + 1;
+    stat->cmdlineOffset = 0;
+    stat->cmdlineLen = 0;
+    if (withCommandLine && !AppendCmdline(list, poolCapacity, pid, stat)) {
+        return false;
+    }
+    list->size++;
+    return true;
+}
+
+extern void CJ_OS_FreeProcessStats(ProcessStatList* list)
+{
+    if (list != NULL) {
+        free(list->stats);
+        free(list->pool);
+        free(list);
+    }
+}
+
+/**
+ * @brief Enumerates all processes in one pass over `/proc`.
+ *
+ * Only `/proc/[pid]/stat` is read for each process, with one read into a stack buffer, and
+ * `/proc/[pid]/cmdline` if requested. The fields of all processes are stored in one array and
+ * their strings in one pool, so that the number of allocations does not grow with the processes.
+ * Processes which exit during the enumeration are skipped.
+ *
+ * @param withCommandLine Whether to read the command line of each process.
+ * @return The list of processes which should be freed by `CJ_OS_FreeProcessStats`, or NULL on failure.
+ */
+extern ProcessStatList* CJ_OS_GetAllProcessStats(bool withCommandLine)
+{
+    DIR* dir = opendir("/proc");
+    if (dir == NULL) {
+        return NULL;
+    }
+    ProcessStatList* list = (ProcessStatList*)calloc(1, sizeof(ProcessStatList));
+    size_t statCapacity = BUF_LEN / sizeof(ProcessStat);
+    size_t poolCapacity = BUF_LEN;
+    if (list != NULL) {
+        list->stats = (ProcessStat*)malloc(statCapacity * sizeof(ProcessStat));
+        list->pool = (char*)malloc(poolCapacity);
+    }
+    if (list == NULL || list->stats == NULL || list->pool == NULL) {
+        CJ_OS_FreeProcessStats(list);
+        (void)closedir(dir);
+        return NULL;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        char* end = NULL;
+        long pid = strtol(entry->d_name, &end, DECIMAL);
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9' || *end != '\0' || pid > INT32_MAX) {
+            continue;
+        }
+        if (!AppendProcessStat(list, &statCapacity, &poolCapacity, (int32_t)pid, withCommandLine)) {
+            CJ_OS_FreeProcessStats(list);
+            (void)closedir(dir);
+            return NULL;
+        }
+    }
+    (void)closedir(dir);
+    return list;
+}
@@ -9,7 +9,9 @@
 #include <stdio.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <limits.h>
+#include <pthread.h>
 
 #define PCRE2_STATIC
 
@@ -25,6 +27,10 @@
 
 #define CJ_REGEX_MATCH_LIMIT (10000000)
 #define CJ_REGEX_RECURSION_LIMIT (1000000)
+#define CJ_REGEX_JIT_STACK_START_SIZE (32 * 1024)
+#define CJ_REGEX_JIT_STACK_MAX_SIZE (1024 * 1024)
+// start, end and return code of a match found by CJ_REGEX_FindAll
+#define CJ_REGEX_FIND_ALL_ENTRY_SIZE (3)
 
 typedef struct {
     pcre2_code* re;
@@ -38,7 +44,7 @@ typedef struct {
     uint8_t* nameTable;
 } NamedTableInfo;
 
-extern CompileResult* CJ_REGEX_Compile(const unsigned char* pattern, const uint32_t options)
+extern CompileResult* CJ_REGEX_Compile(const unsigned char* pattern, const uint32_t options, const bool jit)
 {
     CompileResult* result = (CompileResult*)malloc(sizeof(CompileResult));
     if (result == NULL) {
@@ -49,6 +55,11 @@ extern CompileResult* CJ_REGEX_Compile(const unsigned char* pattern, const uint3
     PCRE2_SIZE errorOffset;
 
     pcre2_code* re = pcre2_compile(pattern, PCRE2_ZERO_TERMINATED, options, &errorCode, &errorOffset, NULL);
+    if (re != NULL && jit) {
+        // JIT is not supported on every platform, or executable memory may be unavailable.
+        // In that case, pcre2_match falls back to the interpreter, so the error is ignored.
+        (void)pcre2_jit_compile(re, PCRE2_JIT_COMPLETE);
+    }
 
     result->re = re;
     result->errorCode = errorCode;
@@ -62,18 +73,73 @@ extern pcre2_match_data* CJ_REGEX_CreateMatchData(const pcre2_code* re)
     return pcre2_match_data_create_from_pattern(re, NULL);
 }
 
-extern int64_t CJ_REGEX_Match(const pcre2_code* re, const unsigned char* subject, const PCRE2_SIZE length,
-    const PCRE2_SIZE offset, pcre2_match_data* matchData)
+/*
+ * A JIT stack must not be used by two threads at the same time, while a match context is shared by all threads
+ * matching the same pattern. So the stack is cached per OS thread and returned by the callback. A cjthread can't be
+ * switched out in the middle of a match, as matching never calls back into Cangjie code.
+ * The stack is also stored in a thread-specific key, whose destructor frees it when the thread exits.
+ */
+static __thread pcre2_jit_stack* g_jitStack = NULL;
+static pthread_key_t g_jitStackKey;
+static pthread_once_t g_jitStackKeyOnce = PTHREAD_ONCE_INIT;
+static bool g_jitStackKeyCreated = false;
+
+static void CJ_REGEX_FreeJitStack(void* stack)
+{
+    pcre2_jit_stack_free((pcre2_jit_stack*)stack);
+}
+
+static void CJ_REGEX_CreateJitStackKey(void)
+{
+    g_jitStackKeyCreated = pthread_key_create(&g_jitStackKey, CJ_REGEX_FreeJitStack) == 0;
+}
+
+static pcre2_jit_stack* CJ_REGEX_GetJitStack(void* data)
+{
+    (void)data;
+    if (g_jitStack != NULL) {
+        return g_jitStack;
+    }
+    (void)pthread_once(&g_jitStackKeyOnce, CJ_REGEX_CreateJitStackKey);
+    // without the key the stack would leak at thread exit, so it isn't created
+    if (!g_jitStackKeyCreated) {
+        return NULL;
+    }
+    // pcre2_match uses a small stack on the machine stack if NULL is returned
+    pcre2_jit_stack* stack =
+        pcre2_jit_stack_create(CJ_REGEX_JIT_STACK_START_SIZE, CJ_REGEX_JIT_STACK_MAX_SIZE, NULL);
+    if (stack == NULL) {
+        return NULL;
+    }
+    if (pthread_setspecific(g_jitStackKey, stack) != 0) {
+        pcre2_jit_stack_free(stack);
+        return NULL;
+    }
+    g_jitStack = stack;
+    return g_jitStack;
+}
+
+extern pcre2_match_context* CJ_REGEX_CreateMatchContext(void)
 {
     pcre2_match_context* mcontext = pcre2_match_context_create(NULL);
     if (mcontext == NULL) {
-        return PCRE2_ERROR_NOMEMORY;
+        return NULL;
     }
     pcre2_set_match_limit(mcontext, CJ_REGEX_MATCH_LIMIT);
     pcre2_set_recursion_limit(mcontext, CJ_REGEX_RECURSION_LIMIT);
-    int result = pcre2_match(re, subject, length, offset, 0, matchData, mcontext);
+    pcre2_jit_stack_assign(mcontext, CJ_REGEX_GetJitStack, NULL);
+    return mcontext;
+}
+
+extern void CJ_REGEX_FreeMatchContext(pcre2_match_context* mcontext)
+{
     pcre2_match_context_free(mcontext);
-    return (int64_t)result;
+}
+
+extern int64_t CJ_REGEX_Match(const pcre2_code* re, const unsigned char* subject, const PCRE2_SIZE length,
+    const PCRE2_SIZE offset, pcre2_match_data* matchData, pcre2_match_context* mcontext)
+{
+    return (int64_t)pcre2_match(re, subject, length, offset, 0, matchData, mcontext);
 }
 
 extern PCRE2_SIZE* CJ_REGEX_GetOvector(pcre2_match_data* matchData)
@@ -142,16 +208,18 @@ extern void CJ_REGEX_FreeMatchData(pcre2_match_data* md)
     pcre2_match_data_free(md);
 }
 
-extern int64_t CJ_REGEX_Count(const pcre2_code* re, const unsigned char* subject, const PCRE2_SIZE length,
-    const PCRE2_SIZE offset, const PCRE2_SIZE end, pcre2_match_data* matchData)
+static int64_t CJ_REGEX_MatchError(int matchResult)
 {
-    pcre2_match_context* mcontext = pcre2_match_context_create(NULL);
-    if (mcontext == NULL) {
-        return PCRE2_ERROR_NOMEMORY;
+    if (matchResult == PCRE2_ERROR_MATCHLIMIT || matchResult == PCRE2_ERROR_RECURSIONLIMIT ||
+        matchResult == PCRE2_ERROR_JIT_STACKLIMIT) {
+        return matchResult;
     }
-    pcre2_set_match_limit(mcontext, CJ_REGEX_MATCH_LIMIT);
-    pcre2_set_recursion_limit(mcontext, CJ_REGEX_RECURSION_LIMIT);
-    
+    return 0;
+}
+
+extern int64_t CJ_REGEX_Count(const pcre2_code* re, const unsigned char* subject, const PCRE2_SIZE length,
+    const PCRE2_SIZE offset, const PCRE2_SIZE end, pcre2_match_data* matchData, pcre2_match_context* mcontext)
+{
     PCRE2_SIZE startOffset = offset;
     int64_t count = 0;
     int matchResult = 0;
@@ -161,13 +229,35 @@ extern int64_t CJ_REGEX_Count(const pcre2_code* re, const unsigned char* subject
         startOffset = ovector[1] + (startOffset == ovector[1]);
         count++;
     }
-    pcre2_match_context_free(mcontext);
-    
-    if (matchResult == PCRE2_ERROR_MATCHLIMIT) {
-        return PCRE2_ERROR_MATCHLIMIT;
-    }
-    if (matchResult == PCRE2_ERROR_RECURSIONLIMIT) {
-        return PCRE2_ERROR_RECURSIONLIMIT;
+
+    int64_t error = CJ_REGEX_MatchError(matchResult);
+    return error != 0 ? error : count;
+}
+
+/*
+ * Find at most `capacity` matches from `offset`, and write the start, the end and the return code of pcre2_match,
+ * i.e. one more than the highest capture group set, of each match to `matches`.
+ * Return the number of matches found. If it equals to `capacity`, the caller continues from `nextOffset`.
+ * An empty match at the offset where matching starts is skipped by starting the next match from the next byte.
+ */
+extern int64_t CJ_REGEX_FindAll(const pcre2_code* re, const unsigned char* subject, const PCRE2_SIZE length,
+    const PCRE2_SIZE offset, pcre2_match_data* matchData, pcre2_match_context* mcontext, PCRE2_SIZE* matches,
+    const int64_t capacity, PCRE2_SIZE* nextOffset)
+{
+    PCRE2_SIZE startOffset = offset;
+    int64_t count = 0;
+    int matchResult = 0;
+    while (count < capacity && startOffset <= length &&
+           (matchResult = pcre2_match(re, subject, length, startOffset, 0, matchData, mcontext)) > 0) {
+        PCRE2_SIZE* ovector = pcre2_get_ovector_pointer(matchData);
+        matches[CJ_REGEX_FIND_ALL_ENTRY_SIZE * count] = ovector[0];
+        matches[CJ_REGEX_FIND_ALL_ENTRY_SIZE * count + 1] = ovector[1];
+        matches[CJ_REGEX_FIND_ALL_ENTRY_SIZE * count + 2] = (PCRE2_SIZE)matchResult;
+        startOffset = ovector[1] + (startOffset == ovector[1]);
+        count++;
     }
-    return count;
-}
\ No newline at end of file
+    *nextOffset = startOffset;
+
+    int64_t error = CJ_REGEX_MatchError(matchResult);
+    return error != 0 ? error : count;
+}
@@ -28,9 +28,12 @@ const uint64_t COUNTER_MAP[] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCT
     PERF_COUNT_HW_BUS_CYCLES, PERF_COUNT_HW_STALLED_CYCLES_FRONTEND, PERF_COUNT_HW_STALLED_CYCLES_BACKEND,
     PERF_COUNT_HW_REF_CPU_CYCLES, PERF_COUNT_SW_CPU_CLOCK, PERF_COUNT_SW_TASK_CLOCK, PERF_COUNT_SW_PAGE_FAULTS,
     PERF_COUNT_SW_CONTEXT_SWITCHES, PERF_COUNT_SW_CPU_MIGRATIONS, PERF_COUNT_SW_PAGE_FAULTS_MIN,
-    PERF_COUNT_SW_PAGE_FAULTS_MAJ, PERF_COUNT_SW_EMULATION_FAULTS};
+    PERF_COUNT_SW_PAGE_FAULTS_MAJ, PERF_COUNT_SW_EMULATION_FAULTS,
+    PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+    PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
 
 #define LAST_HW_COUNTER_INDEX 9
+#define LAST_SW_COUNTER_INDEX 17
 
 static uint64_t MapConfig(int counter)
 {
@@ -41,57 +44,340 @@ static uint64_t MapType(int counter)
 {
     if (counter <= LAST_HW_COUNTER_INDEX) {
         return PERF_TYPE_HARDWARE;
-    } else {
+    } else if (counter <= LAST_SW_COUNTER_INDEX) {
         return PERF_TYPE_SOFTWARE;
+    } else {
+        return PERF_TYPE_HW_CACHE;
     }
 }
 
-int g_fd = 0;
+/*
+ * A perf event group is opened for every counted thread. The first counter is the group leader, so all counters of
+ * a thread are scheduled on the PMU together and read at once with PERF_FORMAT_GROUP.
+ */
+struct PerfGroup {
+    int32_t count;
+    int32_t flags;
+    pid_t owner;
+    int32_t threadCount;
+    int *fds; // threadCount * count descriptors, the leader of each thread goes first
+    // mmap pages of the counters of the owner thread, used to read them with rdpmc. Not mapped for all threads.
+    struct perf_event_mmap_page *pages[PERF_GROUP_MAX_COUNTERS];
+};
 
-int InitPerf(int counter)
-{
-    const int supportedCounters = sizeof(COUNTER_MAP) / sizeof(uint64_t);
+struct PerfGroupReadFormat {
+    uint64_t nr;
+    uint64_t timeEnabled;
+    uint64_t timeRunning;
+    uint64_t values[PERF_GROUP_MAX_COUNTERS];
+};
 
-    if (counter >= supportedCounters || counter < 0) {
-        return -1;
+static __thread pid_t g_perfTid = 0;
+
+static pid_t CurrentTid(void)
+{
+    if (g_perfTid == 0) {
+        g_perfTid = (pid_t)syscall(SYS_gettid);
     }
+    return g_perfTid;
+}
 
+static int OpenCounter(int counter, pid_t tid, int groupFd, int inherit)
+{
     struct perf_event_attr pe = {0};
-    if (g_fd != 0) {
-        ioctl(g_fd, PERF_EVENT_IOC_DISABLE, 0);
-        close(g_fd);
-        g_fd = 0;
-    }
     // Configure the event to count
     pe.type = (unsigned int)MapType(counter);
     pe.size = sizeof(struct perf_event_attr);
     pe.config = MapConfig(counter);
-    pe.disabled = 1;
+    pe.disabled = groupFd == -1 ? 1 : 0; // members are enabled with the leader
+    pe.inherit = inherit ? 1 : 0;
     pe.exclude_kernel = 1; // Do not measure instructions executed in the kernel
     pe.exclude_hv = 1;
+    pe.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    return (int)syscall(SYS_perf_event_open, &pe, tid, -1, groupFd, 0);
+}
+
+static void CloseFds(int *fds, int32_t count)
+{
+    for (int32_t i = 0; i < count; ++i) {
+        if (fds[i] >= 0) {
+            close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+}
+
+/* Return 0, or errno if any counter can not be opened for the thread. */
+static int OpenThreadGroup(const int32_t *counters, int32_t count, pid_t tid, int inherit, int *fds)
+{
+    for (int32_t i = 0; i < count; ++i) {
+        fds[i] = OpenCounter(counters[i], tid, i == 0 ? -1 : fds[0], inherit);
+        // old kernels can not read inherited counters as a group
+        if (fds[i] < 0 && errno == EINVAL && inherit) {
+            CloseFds(fds, i);
+            return OpenThreadGroup(counters, count, tid, 0, fds);
+        }
+        if (fds[i] < 0) {
+            int err = errno;
+            CloseFds(fds, i);
+            return err;
+        }
+    }
+    return 0;
+}
+
+/* Collect the threads of the current process. Return the number of them, or -1 on failure. */
+static int32_t ListThreads(pid_t **tids)
+{
+    DIR *dir = opendir("/proc/self/task");
+    if (dir == NULL) {
+        return -1;
+    }
+    int32_t capacity = 16;
+    int32_t size = 0;
+    pid_t *result = malloc(sizeof(pid_t) * capacity);
+    struct dirent *entry;
+    while (result != NULL && (entry = readdir(dir)) != NULL) {
+        if (entry->d_name[0] < '0' || entry->d_name[0] > '9') {
+            continue;
+        }
+        if (size == capacity) {
+            capacity *= 2;
+            pid_t *grown = realloc(result, sizeof(pid_t) * capacity);
+            if (grown == NULL) {
+                free(result);
+                result = NULL;
+                break;
+            }
+            result = grown;
+        }
+        result[size++] = (pid_t)atoi(entry->d_name);
+    }
+    closedir(dir);
+    if (result == NULL) {
+        return -1;
+    }
+    *tids = result;
+    return size;
+}
+
+static int OpenAllThreads(struct PerfGroup *group, const int32_t *counters)
+{
+    pid_t *tids = NULL;
+    int32_t threadCount = ListThreads(&tids);
+    if (threadCount < 0) {
+        return errno != 0 ? errno : ENOMEM;
+    }
+    group->fds = malloc(sizeof(int) * (size_t)threadCount * (size_t)group->count);
+    if (group->fds == NULL) {
+        free(tids);
+        return ENOMEM;
+    }
+    int err = 0;
+    for (int32_t i = 0; i < threadCount; ++i) {
+        int *fds = group->fds + (size_t)group->threadCount * (size_t)group->count;
+        int rc = OpenThreadGroup(counters, group->count, tids[i], 1, fds);
+        if (rc == ESRCH) {
+            continue; // the thread has exited
+        }
+        if (rc != 0) {
+            err = rc;
+            break;
+        }
+        group->threadCount++;
+    }
+    free(tids);
+    return err;
+}
+
+static void MapPages(struct PerfGroup *group)
+{
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (int32_t i = 0; i < group->count; ++i) {
+        void *page = mmap(NULL, (size_t)pageSize, PROT_READ, MAP_SHARED, group->fds[i], 0);
+        group->pages[i] = page == MAP_FAILED ? NULL : (struct perf_event_mmap_page *)page;
+    }
+}
 
-    g_fd = (int)syscall(SYS_perf_event_open, &pe, 0, -1, -1, 0);
-    if (g_fd < 0) {
-        fprintf(stderr, "error: Open perf event failed %d.\n", errno);
-        return errno;
+void ClosePerfGroup(struct PerfGroup *group)
+{
+    if (group == NULL) {
+        return;
+    }
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (int32_t i = 0; i < group->count; ++i) {
+        if (group->pages[i] != NULL) {
+            munmap(group->pages[i], (size_t)pageSize);
+        }
     }
+    if (group->fds != NULL) {
+        for (int32_t t = 0; t < group->threadCount; ++t) {
+            ioctl(group->fds[(size_t)t * (size_t)group->count], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        }
+        CloseFds(group->fds, group->threadCount * group->count);
+        free(group->fds);
+    }
+    free(group);
+}
 
-    ioctl(g_fd, PERF_EVENT_IOC_RESET, 0);
-    ioctl(g_fd, PERF_EVENT_IOC_ENABLE, 0);
+struct PerfGroup *OpenPerfGroup(const int32_t *counters, int32_t count, int32_t flags, int32_t *err)
+{
+    if (counters == NULL || count <= 0 || count > PERF_GROUP_MAX_COUNTERS) {
+        *err = EINVAL;
+        return NULL;
+    }
+    const int32_t supportedCounters = (int32_t)(sizeof(COUNTER_MAP) / sizeof(uint64_t));
+    for (int32_t i = 0; i < count; ++i) {
+        if (counters[i] < 0 || counters[i] >= supportedCounters) {
+            *err = EINVAL;
+            return NULL;
+        }
+    }
+    struct PerfGroup *group = calloc(1, sizeof(struct PerfGroup));
+    if (group == NULL) {
+        *err = ENOMEM;
+        return NULL;
+    }
+    group->count = count;
+    group->flags = flags;
+    group->owner = CurrentTid();
+    int rc = 0;
+    if ((flags & PERF_GROUP_ALL_THREADS) != 0) {
+        rc = OpenAllThreads(group, counters);
+    } else {
+        group->fds = malloc(sizeof(int) * (size_t)count);
+        rc = group->fds == NULL ? ENOMEM : OpenThreadGroup(counters, count, 0, 0, group->fds);
+        if (rc == 0) {
+            group->threadCount = 1;
+            MapPages(group);
+        }
+    }
+    if (rc != 0) {
+        fprintf(stderr, "error: Open perf event failed %d.\n", rc);
+        ClosePerfGroup(group);
+        *err = rc;
+        return NULL;
+    }
+    for (int32_t t = 0; t < group->threadCount; ++t) {
+        int leader = group->fds[(size_t)t * (size_t)count];
+        ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    *err = 0;
+    return group;
+}
 
+/*
+ * Read all counters of the group and their times, summed up over the counted threads. Return 0, or -1 on failure.
+ * Counters are not scaled here, so that they are the same as the ones read with rdpmc.
+ */
+static int ReadPerfGroup(const struct PerfGroup *group, uint64_t *values)
+{
+    struct PerfGroupReadFormat data;
+    size_t expected = sizeof(uint64_t) * (3 + (size_t)group->count);
+    for (int32_t i = 0; i < group->count + 2; ++i) {
+        values[i] = 0;
+    }
+    for (int32_t t = 0; t < group->threadCount; ++t) {
+        ssize_t len = read(group->fds[(size_t)t * (size_t)group->count], &data, sizeof(data));
+        if (len < (ssize_t)expected || data.nr != (uint64_t)group->count) {
+            return -1;
+        }
+        for (int32_t i = 0; i < group->count; ++i) {
+            values[i] += data.values[i];
+        }
+        values[group->count] += data.timeEnabled;
+        values[group->count + 1] += data.timeRunning;
+    }
     return 0;
 }
 
-uint64_t ReadPerf(void)
+#if defined(__x86_64__)
+static uint64_t Rdpmc(uint32_t counter)
 {
-    uint64_t val = 0;
+    uint32_t low;
+    uint32_t high;
+    __asm__ __volatile__("rdpmc" : "=a"(low), "=d"(high) : "c"(counter));
+    return ((uint64_t)high << 32) | low;
+}
 
-    ssize_t len = read(g_fd, &val, sizeof(val));
-    if (len < 0) {
-        return (uint64_t)-1;
+/*
+ * Read a counter of the calling thread in user space, following the seqlock protocol of perf_event_mmap_page.
+ * If times is not NULL, the enabled and running times up to now are computed from the TSC as well.
+ * Return -1 if the counter is not on the PMU now, so it has to be read with read().
+ */
+static int ReadUserCounter(volatile struct perf_event_mmap_page *page, uint64_t *value, uint64_t *times)
+{
+    uint32_t seq;
+    uint64_t count;
+    uint64_t enabled;
+    uint64_t running;
+    do {
+        seq = page->lock;
+        __asm__ __volatile__("" ::: "memory");
+        uint32_t index = page->index;
+        if (!page->cap_user_rdpmc || index == 0 || (times != NULL && !page->cap_user_time)) {
+            return -1;
+        }
+        uint16_t width = page->pmc_width;
+        int64_t pmc = (int64_t)Rdpmc(index - 1);
+        pmc <<= 64 - width;
+        pmc >>= 64 - width; // sign extend the raw counter
+        count = (uint64_t)((int64_t)page->offset + pmc);
+        enabled = page->time_enabled;
+        running = page->time_running;
+        if (times != NULL) {
+            // time since the counter was scheduled in, it's counted as both enabled and running.
+            uint64_t cycles = GetRdtsc();
+            uint16_t shift = page->time_shift;
+            uint32_t mult = page->time_mult;
+            uint64_t quot = cycles >> shift;
+            uint64_t rem = cycles & (((uint64_t)1 << shift) - 1);
+            uint64_t delta = page->time_offset + quot * mult + ((rem * mult) >> shift);
+            enabled += delta;
+            running += delta;
+        }
+        __asm__ __volatile__("" ::: "memory");
+    } while (page->lock != seq);
+    *value = count;
+    if (times != NULL) {
+        times[0] = enabled;
+        times[1] = running;
     }
+    return 0;
+}
+#endif
 
-    return val;
+#if defined(__x86_64__)
+/*
+ * Read every counter of the calling thread's group with rdpmc, back to back, and the times of the group from its
+ * leader. Return -1 if any has to use read().
+ */
+static int ReadUserCounters(const struct PerfGroup *group, uint64_t *values)
+{
+    for (int32_t i = 0; i < group->count; ++i) {
+        uint64_t *times = i == 0 ? &values[group->count] : NULL;
+        if (group->pages[i] == NULL || ReadUserCounter(group->pages[i], &values[i], times) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+#endif
+
+int32_t ReadPerfGroupValues(const struct PerfGroup *group, uint64_t *values, int32_t count)
+{
+    if (group == NULL || values == NULL || count != group->count) {
+        return -1;
+    }
+#if defined(__x86_64__)
+    // rdpmc reads the PMU of the current cpu, it's only valid on the thread the counters are opened for.
+    if (group->owner == CurrentTid() && ReadUserCounters(group, values) == 0) {
+        return 0;
+    }
+#endif
+    return ReadPerfGroup(group, values);
 }
 
 #endif // ifdef __linux__
@@ -18,8 +18,24 @@
 #include <stdint.h>
 
 #ifdef __linux__
-int InitPerf(int counter);
-uint64_t ReadPerf(void);
+#define PERF_GROUP_MAX_COUNTERS 8
+/* count every thread of the process, including threads created after the group is opened */
+#define PERF_GROUP_ALL_THREADS 0x1
+
+struct PerfGroup;
+
+/*
+ * Open counters as a perf event group of the calling thread, or of all threads with PERF_GROUP_ALL_THREADS.
+ * Return NULL and set err to errno on failure.
+ */
+struct PerfGroup *OpenPerfGroup(const int32_t *counters, int32_t count, int32_t flags, int32_t *err);
+/*
+ * Read all count counters of the group at once into values, followed by the time the group was enabled and the time
+ * it was running on the PMU, so values holds count + 2 elements. Counters are not scaled, the times of two reads scale
+ * the difference of the counters. Return 0, or -1 on failure.
+ */
+int32_t ReadPerfGroupValues(const struct PerfGroup *group, uint64_t *values, int32_t count);
+void ClosePerfGroup(struct PerfGroup *group);
 #endif // ifdef __linux__
 
 #if defined(__x86_64__) || defined(_M_X64) || defined(i386) \
@@ -37,6 +37,7 @@ execute_process(
         -DCMAKE_C_FLAGS=${CMAKE_C_FLAGS}
         -DCUSTOM_WARNING_SETTINGS=${CUSTOM_WARNING_SETTINGS}
         -DPCRE2_STATIC_PIC=ON
+        -DPCRE2_SUPPORT_JIT=ON
         -DBUILD_SHARED_LIBS=ON
         -DPCRE2_BUILD_PCRE2GREP=OFF
         -DPCRE2_BUILD_TESTS=OFF